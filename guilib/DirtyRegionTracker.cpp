@@ -0,0 +1,251 @@
+/*
+ *      Copyright (C) 2005-2010 Team XBMC
+ *      http://www.xbmc.org
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, write to
+ *  the Free Software Foundation, 675 Mass Ave, Cambridge, MA 02139, USA.
+ *  http://www.gnu.org/copyleft/gpl.html
+ *
+ */
+
+#include "DirtyRegionTracker.h"
+#include <stddef.h>
+
+using namespace std;
+
+// past this many separate regions it's cheaper to treat them as one
+#define MAX_DIRTY_REGIONS 8
+
+// linear filtering can reach a pixel past the geometry
+#define DIRTY_REGION_MARGIN 1.0f
+
+#define HASH_SEED 2166136261u
+
+CDirtyRegionTracker::CDirtyRegionTracker()
+{
+  m_algorithm = REDRAW_ALWAYS;
+  m_tracking = false;
+  m_redrawAll = true;
+  m_invalidated = true;
+  m_frame = 0;
+}
+
+CRect CDirtyRegionTracker::BeginFrame(int algorithm, const CRect &screen, bool redrawAll)
+{
+  bool tracking = algorithm != REDRAW_ALWAYS && !redrawAll;
+  if (!tracking || algorithm != m_algorithm || screen != m_screen)
+    m_invalidated = true;
+
+  m_algorithm = algorithm;
+  m_redrawAll = !tracking;
+  m_tracking = tracking;
+  m_screen = screen;
+  m_frame++;
+  m_dirty.clear();
+  m_scopes.clear();
+
+  if (m_invalidated)
+  { // nothing we know about the screen can be trusted, so both buffers need drawing in full
+    m_drawn.clear();
+    m_changed[0] = m_changed[1] = screen;
+    m_invalidated = false;
+  }
+
+  m_redraw = screen;
+  if (m_tracking && m_algorithm == REDRAW_CHANGED)
+  {
+    m_redraw = m_changed[0];
+    m_redraw.Union(m_changed[1]);
+    m_redraw.Intersect(screen);
+  }
+
+  if (m_tracking)
+  { // anything drawn outside of a control
+    Scope root = { NULL, HASH_SEED, CRect(), false };
+    m_scopes.push_back(root);
+  }
+  return m_redraw;
+}
+
+void CDirtyRegionTracker::EndFrame()
+{
+  if (!m_tracking)
+    return;
+
+  while (m_scopes.size())
+    EndControl();
+
+  // whatever we drew last frame and not this one has gone
+  map<const void *, Drawn>::iterator i = m_drawn.begin();
+  while (i != m_drawn.end())
+  {
+    if (i->second.frame != m_frame)
+    {
+      MarkDirty(i->second.bounds);
+      m_drawn.erase(i++);
+    }
+    else
+      ++i;
+  }
+
+  MergeRegions();
+
+  CRect changed;
+  for (unsigned int j = 0; j < m_dirty.size(); j++)
+    changed.Union(m_dirty[j]);
+  m_changed[1] = m_changed[0];
+  m_changed[0] = changed;
+
+  m_tracking = false;
+}
+
+bool CDirtyRegionTracker::NeedsPresent() const
+{
+  if (m_redrawAll)
+    return true;
+  if (m_algorithm == SKIP_UNCHANGED)
+    return m_dirty.size() > 0;
+  return !m_redraw.IsEmpty();
+}
+
+void CDirtyRegionTracker::BeginControl(const void *control)
+{
+  if (!m_tracking)
+    return;
+
+  Scope scope = { control, HASH_SEED, CRect(), false };
+  m_scopes.push_back(scope);
+}
+
+void CDirtyRegionTracker::EndControl()
+{
+  if (!m_tracking || !m_scopes.size())
+    return;
+
+  Scope scope = m_scopes.back();
+  m_scopes.pop_back();
+
+  map<const void *, Drawn>::iterator i = m_drawn.find(scope.control);
+  if (i == m_drawn.end())
+  {
+    if (!scope.drawn)
+      return; // draws nothing itself, eg a group
+
+    MarkDirty(scope.bounds);
+    Drawn drawn = { scope.hash, scope.bounds, m_frame };
+    m_drawn.insert(make_pair(scope.control, drawn));
+    return;
+  }
+
+  if (!scope.drawn)
+  { // drew something last time but nothing now
+    MarkDirty(i->second.bounds);
+    m_drawn.erase(i);
+    return;
+  }
+
+  // a control drawn more than once a frame never matches itself, which errs on the safe side
+  if (i->second.hash != scope.hash || i->second.bounds != scope.bounds)
+  {
+    MarkDirty(i->second.bounds);
+    MarkDirty(scope.bounds);
+  }
+  i->second.hash = scope.hash;
+  i->second.bounds = scope.bounds;
+  i->second.frame = m_frame;
+}
+
+void CDirtyRegionTracker::AddVerticesInternal(const float *x, const float *y, const float *z, unsigned int count)
+{
+  Scope &scope = m_scopes.back();
+  for (unsigned int i = 0; i < count; i++)
+  {
+    // we can't follow a perspective projection, so anything off the z = 0 plane may be anywhere
+    CRect point = (z && z[i] != 0) ? m_screen : CRect(x[i], y[i], x[i], y[i]);
+    if (!scope.drawn)
+    {
+      scope.bounds = point;
+      scope.drawn = true;
+    }
+    else
+    {
+      if (point.x1 < scope.bounds.x1) scope.bounds.x1 = point.x1;
+      if (point.y1 < scope.bounds.y1) scope.bounds.y1 = point.y1;
+      if (point.x2 > scope.bounds.x2) scope.bounds.x2 = point.x2;
+      if (point.y2 > scope.bounds.y2) scope.bounds.y2 = point.y2;
+    }
+    Hash(scope.hash, &x[i], sizeof(float));
+    Hash(scope.hash, &y[i], sizeof(float));
+  }
+}
+
+void CDirtyRegionTracker::Hash(uint32_t &hash, const void *data, unsigned int size)
+{
+  // FNV-1a
+  const unsigned char *bytes = (const unsigned char *)data;
+  for (unsigned int i = 0; i < size; i++)
+  {
+    hash ^= bytes[i];
+    hash *= 16777619u;
+  }
+}
+
+void CDirtyRegionTracker::MarkDirty(const CRect &rect)
+{
+  if (!m_tracking)
+    return;
+
+  // geometry can be a line or a point, which still covers pixels
+  CRect dirty(rect.x1 - DIRTY_REGION_MARGIN, rect.y1 - DIRTY_REGION_MARGIN, rect.x2 + DIRTY_REGION_MARGIN, rect.y2 + DIRTY_REGION_MARGIN);
+  dirty.Intersect(m_screen);
+  if (!dirty.IsEmpty())
+    m_dirty.push_back(dirty);
+}
+
+void CDirtyRegionTracker::MarkDirty()
+{
+  MarkDirty(m_screen);
+}
+
+void CDirtyRegionTracker::MergeRegions()
+{
+  // fold together regions that overlap, until none do
+  bool merged = true;
+  while (merged && m_dirty.size() > 1)
+  {
+    merged = false;
+    for (unsigned int i = 0; i < m_dirty.size() && !merged; i++)
+    {
+      for (unsigned int j = i + 1; j < m_dirty.size(); j++)
+      {
+        if (m_dirty[i].Intersects(m_dirty[j]))
+        {
+          m_dirty[i].Union(m_dirty[j]);
+          m_dirty.erase(m_dirty.begin() + j);
+          merged = true;
+          break;
+        }
+      }
+    }
+  }
+
+  if (m_dirty.size() > MAX_DIRTY_REGIONS)
+  {
+    CRect all;
+    for (unsigned int i = 0; i < m_dirty.size(); i++)
+      all.Union(m_dirty[i]);
+    m_dirty.clear();
+    m_dirty.push_back(all);
+  }
+}
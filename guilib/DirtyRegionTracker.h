@@ -0,0 +1,145 @@
+/*
+ *      Copyright (C) 2005-2010 Team XBMC
+ *      http://www.xbmc.org
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, write to
+ *  the Free Software Foundation, 675 Mass Ave, Cambridge, MA 02139, USA.
+ *  http://www.gnu.org/copyleft/gpl.html
+ *
+ */
+
+#ifndef GUILIB_DIRTYREGIONTRACKER_H__
+#define GUILIB_DIRTYREGIONTRACKER_H__
+#pragma once
+
+#include <map>
+#include <vector>
+#include <stdint.h>
+#include "Geometry.h"
+
+typedef std::vector<CRect> CDirtyRegionList;
+
+/*!
+ \ingroup graphics
+ \brief Works out which parts of the screen change from one frame to the next.
+
+ Controls don't need to say when they change.  Everything drawn while a control renders
+ (texture quads and glyphs, in screen coordinates) is summed up per control, and a control
+ whose sum differs from last frame's, or that was drawn last frame and not this one, marks
+ both where it was and where it is now as dirty.  Anything drawn some other way (video,
+ visualisations and the like) has to call MarkDirty() itself.
+
+ Controls are only seen as they render, so the dirty regions of a frame are known once it
+ has been drawn.  Depending on the algorithm that's used to skip presenting frames that
+ didn't change, or to restrict drawing to what changed over the last two frames, which
+ covers what's stale in a double buffered back buffer.  Something that changes while
+ drawing is restricted that way shows up a frame late.
+ */
+class CDirtyRegionTracker
+{
+public:
+  enum ALGORITHM
+  {
+    REDRAW_ALWAYS = 0,  ///< draw and present every frame, nothing is tracked
+    SKIP_UNCHANGED,     ///< draw the whole screen, but only present frames that changed
+    REDRAW_CHANGED      ///< only draw the parts of the screen that changed, needs a double buffered back buffer
+  };
+
+  CDirtyRegionTracker();
+
+  /*! \brief Start tracking a frame
+   \param algorithm one of the ALGORITHM values
+   \param screen the area of the screen we draw to
+   \param redrawAll set to draw and present the whole screen this frame, eg for fullscreen video
+   \return the region of the screen that needs drawing, empty if none
+   */
+  CRect BeginFrame(int algorithm, const CRect &screen, bool redrawAll);
+  void EndFrame();
+
+  /*! \brief Whether the frame just drawn needs presenting
+   */
+  bool NeedsPresent() const;
+
+  /*! \brief Regions of the screen that changed in the frame just drawn
+   */
+  const CDirtyRegionList &GetDirtyRegions() const { return m_dirty; };
+
+  void BeginControl(const void *control);
+  void EndControl();
+
+  /*! \brief Add geometry drawn by the current control, in screen coordinates
+   */
+  inline void AddVertices(const float *x, const float *y, const float *z, unsigned int count)
+  {
+    if (m_tracking)
+      AddVerticesInternal(x, y, z, count);
+  };
+
+  /*! \brief Add whatever else decides what the current control looks like, eg texture and color
+   */
+  inline void AddState(const void *data, unsigned int size)
+  {
+    if (m_tracking)
+      Hash(m_scopes.back().hash, data, size);
+  };
+
+  /*! \brief Mark part of the screen as changed this frame
+   */
+  void MarkDirty(const CRect &rect);
+
+  /*! \brief Mark the whole screen as changed this frame
+   */
+  void MarkDirty();
+
+  /*! \brief Forget what's on screen and draw everything again, eg after a resolution change
+   */
+  void Invalidate() { m_invalidated = true; };
+
+  bool IsTracking() const { return m_tracking; };  ///< true between BeginFrame() and EndFrame() when tracking
+
+private:
+  struct Scope
+  {
+    const void *control;
+    uint32_t    hash;
+    CRect       bounds;
+    bool        drawn;
+  };
+
+  struct Drawn
+  {
+    uint32_t     hash;
+    CRect        bounds;
+    unsigned int frame;
+  };
+
+  void AddVerticesInternal(const float *x, const float *y, const float *z, unsigned int count);
+  static void Hash(uint32_t &hash, const void *data, unsigned int size);
+  void MergeRegions();
+
+  int          m_algorithm;
+  bool         m_tracking;
+  bool         m_redrawAll;
+  bool         m_invalidated;
+  unsigned int m_frame;
+  CRect        m_screen;
+  CRect        m_redraw;       ///< what we drew this frame
+  CRect        m_changed[2];   ///< bounding boxes of what changed the last two frames
+
+  std::vector<Scope>             m_scopes;
+  std::map<const void *, Drawn>  m_drawn;
+  CDirtyRegionList               m_dirty;
+};
+
+#endif
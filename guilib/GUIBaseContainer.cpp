@@ -32,6 +32,7 @@
 #include "GUIStaticItem.h"
 #include "Key.h"
 #include "MathUtils.h"
+#include "GUILargeTextureManager.h"
 
 using namespace std;
 
@@ -60,6 +61,8 @@ CGUIBaseContainer::CGUIBaseContainer(int parentID, int controlID, float posX, fl
   m_layout = NULL;
   m_focusedLayout = NULL;
   m_cacheItems = preloadItems;
+  m_prefetchOffset = -1;
+  m_prefetchDirection = 1;
 }
 
 CGUIBaseContainer::~CGUIBaseContainer(void)
@@ -86,6 +89,8 @@ void CGUIBaseContainer::Render()
   if ((int)m_items.size() > m_itemsPerPage + cacheBefore + cacheAfter)
     FreeMemory(CorrectOffset(offset - cacheBefore, 0), CorrectOffset(offset + m_itemsPerPage + 1 + cacheAfter, 0));
 
+  PrefetchImages(offset, m_itemsPerPage + 1, cacheBefore, cacheAfter);
+
   if (g_graphicsContext.SetClipRegion(m_posX, m_posY, m_width, m_height))
   {
     CPoint origin = CPoint(m_posX, m_posY) + m_renderOffset;
@@ -910,6 +915,7 @@ void CGUIBaseContainer::Reset()
   m_wasReset = true;
   m_items.clear();
   m_lastItem = NULL;
+  m_prefetchOffset = -1;
 }
 
 void CGUIBaseContainer::LoadLayout(TiXmlElement *layout)
@@ -1114,6 +1120,30 @@ int CGUIBaseContainer::GetCurrentPage() const
   return m_offset / m_itemsPerPage + 1;
 }
 
+/* all arguments count items rather than rows, so that panels can prefetch whole rows */
+void CGUIBaseContainer::PrefetchImages(int item, int pageItems, int cacheBefore, int cacheAfter)
+{
+  if (item == m_prefetchOffset)
+    return;
+
+  m_prefetchDirection = (item > m_prefetchOffset) ? 1 : -1;
+  m_prefetchOffset = item;
+
+  // ask for the images of the page beyond what we're keeping around, in the direction we're moving
+  int start = (m_prefetchDirection > 0) ? item + pageItems + cacheAfter : item - cacheBefore - pageItems;
+  vector<CStdString> images;
+  for (int i = 0; i < pageItems; i++)
+  {
+    int current = (m_prefetchDirection > 0) ? start + i : start + pageItems - 1 - i;
+    int itemNo = CorrectOffset(0, current);
+    if (itemNo < 0 || itemNo >= (int)m_items.size())
+      continue;
+    CGUIListItemLayout *layout = m_items[itemNo]->GetLayout();
+    (layout ? layout : m_layout)->GetItemImages(m_items[itemNo].get(), images);
+  }
+  g_largeTextureManager.PrefetchImages(images);
+}
+
 void CGUIBaseContainer::GetCacheOffsets(int &cacheBefore, int &cacheAfter)
 {
   if (m_scrollSpeed > 0)
@@ -173,6 +173,7 @@ protected:
 
   void UpdateScrollByLetter();
   void GetCacheOffsets(int &cacheBefore, int &cacheAfter);
+  void PrefetchImages(int item, int pageItems, int cacheBefore, int cacheAfter);
   bool ScrollingDown() const { return m_scrollSpeed > 0; };
   bool ScrollingUp() const { return m_scrollSpeed < 0; };
   void OnNextLetter();
@@ -183,6 +184,8 @@ protected:
 private:
   int m_cacheItems;
   float m_scrollSpeed;
+  int m_prefetchOffset;     // first visible item when we last asked for images ahead of it
+  int m_prefetchDirection;  // direction we were last moving in
   CStopWatch m_scrollTimer;
   CStopWatch m_pageChangeTimer;
 
@@ -144,7 +144,9 @@ void CGUIControl::DoRender(unsigned int currentTime)
   if (IsVisible())
   {
     GUIPROFILER_RENDER_BEGIN(this);
+    g_graphicsContext.GetDirtyRegions().BeginControl(this);
     Render();
+    g_graphicsContext.GetDirtyRegions().EndControl();
     GUIPROFILER_RENDER_END(this);
   }
   if (m_hasCamera)
@@ -158,6 +160,12 @@ void CGUIControl::Render()
   m_hasRendered = true;
 }
 
+void CGUIControl::MarkDirtyRegion()
+{
+  CRect rect(m_posX, m_posY, m_posX + m_width, m_posY + m_height);
+  g_graphicsContext.GetDirtyRegions().MarkDirty(g_graphicsContext.ScaleFinalRect(rect));
+}
+
 bool CGUIControl::OnAction(const CAction &action)
 {
   switch (action.GetID())
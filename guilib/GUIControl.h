@@ -190,6 +190,11 @@ public:
   virtual void SetInitialVisibility();
   virtual void SetEnabled(bool bEnable);
   virtual void SetInvalid() { m_bInvalidated = true; };
+
+  /*! \brief Mark the area the control covers as changed this frame
+   For controls whose content changes without going through a GUI texture or font, eg video.
+   */
+  void MarkDirtyRegion();
   virtual void SetPulseOnSelect(bool pulse) { m_pulseOnSelect = pulse; };
   virtual CStdString GetDescription() const { return ""; };
 
@@ -205,6 +210,8 @@ public:
 
   // push information updates
   virtual void UpdateInfo(const CGUIListItem *item = NULL) {};
+  // images this control would show for item, so they can be loaded ahead of time
+  virtual void GetItemImages(const CGUIListItem *item, std::vector<CStdString> &images) const {};
   virtual void SetPushUpdates(bool pushUpdates) { m_pushedUpdates = pushUpdates; };
 
   virtual bool IsGroup() const { return false; };
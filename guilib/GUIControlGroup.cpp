@@ -296,6 +296,12 @@ void CGUIControlGroup::SetInitialVisibility()
     (*it)->SetInitialVisibility();
 }
 
+void CGUIControlGroup::GetItemImages(const CGUIListItem *item, vector<CStdString> &images) const
+{
+  for (ciControls it = m_children.begin(); it != m_children.end(); ++it)
+    (*it)->GetItemImages(item, images);
+}
+
 void CGUIControlGroup::QueueAnimation(ANIMATION_TYPE animType)
 {
   CGUIControl::QueueAnimation(animType);
@@ -55,6 +55,7 @@ public:
   virtual void UnfocusFromPoint(const CPoint &point);
 
   virtual void SetInitialVisibility();
+  virtual void GetItemImages(const CGUIListItem *item, std::vector<CStdString> &images) const;
 
   virtual void DoRender(unsigned int currentTime);
   virtual bool IsAnimating(ANIMATION_TYPE anim);
@@ -22,6 +22,7 @@
 #include "GUIControlProfiler.h"
 #include "tinyXML/tinyxml.h"
 #include "utils/TimeUtils.h"
+#include "utils/GUIInfoManager.h"
 
 bool CGUIControlProfiler::m_bIsRunning = false;
 
@@ -264,6 +265,7 @@ void CGUIControlProfiler::Start(void)
   m_bIsRunning = true;
   m_pLastItem = NULL;
   m_ItemHead.Reset(this);
+  g_infoManager.ResetConditionProfile();
 }
 
 void CGUIControlProfiler::BeginVisibility(CGUIControl *pControl)
@@ -354,5 +356,6 @@ bool CGUIControlProfiler::SaveResults(void)
   doc.LinkEndChild(root);
 
   m_ItemHead.SaveToXML(root);
+  g_infoManager.SaveConditionProfile(root);
   return doc.SaveFile(m_strOutputFile);
 }
@@ -280,6 +280,31 @@ void CGUIFont::End()
   m_font->End();
 }
 
+unsigned int CGUIFont::GetVertexCount() const
+{
+  if (!m_font) return 0;
+  return m_font->m_vertex_count;
+}
+
+void CGUIFont::GetVertices(unsigned int start, std::vector<SVertex> &vertices) const
+{
+  vertices.clear();
+  if (!m_font || start >= (unsigned int)m_font->m_vertex_count) return;
+  vertices.assign(m_font->m_vertex + start, m_font->m_vertex + m_font->m_vertex_count);
+}
+
+void CGUIFont::AddVertices(const std::vector<SVertex> &vertices)
+{
+  if (!m_font || !vertices.size()) return;
+  m_font->AddVertices(&vertices[0], vertices.size());
+}
+
+unsigned int CGUIFont::GetGeneration() const
+{
+  if (!m_font) return 0;
+  return m_font->m_generation;
+}
+
 void CGUIFont::SetFont(CGUIFontTTFBase *font)
 {
   if (m_font == font)
@@ -36,6 +36,13 @@ typedef uint32_t color_t;
 typedef std::vector<character_t> vecText;
 typedef std::vector<color_t> vecColors;
 
+typedef struct _SVertex
+{
+  float u, v;
+  unsigned char r, g, b, a;
+  float x, y, z;
+} SVertex;
+
 class CGUIFontTTFBase;
 
 // flags for alignment
@@ -141,6 +148,20 @@ public:
   void Begin();
   void End();
 
+  /*! \brief Glyph quads laid out since Begin(), for drawing unchanged text again with AddVertices()
+   \param start number of vertices there were before the text of interest was drawn
+   \param vertices [out] the vertices laid out since then
+   \sa GetVertexCount, GetGeneration
+   */
+  void GetVertices(unsigned int start, std::vector<SVertex> &vertices) const;
+  unsigned int GetVertexCount() const;
+  void AddVertices(const std::vector<SVertex> &vertices);
+
+  /*! \brief Changes whenever vertices from GetVertices() can no longer be drawn again,
+   eg when the glyph texture is rebuilt
+   */
+  unsigned int GetGeneration() const;
+
   uint32_t GetStyle() const { return m_style; };
 
   static wchar_t RemapGlyph(wchar_t letter);
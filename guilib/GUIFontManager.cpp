@@ -403,6 +403,20 @@ CGUIFont* GUIFontManager::GetDefaultFont(bool border)
   return m_vecFonts[font13index];
 }
 
+void GUIFontManager::CacheCommonGlyphs()
+{
+  // fonts sharing a file and style share glyphs, so the later ones find them all cached
+  for (unsigned int i = 0; i < m_vecFonts.size(); i++)
+  {
+    CGUIFont *font = m_vecFonts[i];
+    character_t style = (font->GetStyle() & 3) << 24;
+    vecText text;
+    for (character_t letter = 32; letter < 127; letter++)
+      text.push_back(style | letter);
+    font->GetTextWidth(text);
+  }
+}
+
 void GUIFontManager::Clear()
 {
   for (int i = 0; i < (int)m_vecFonts.size(); ++i)
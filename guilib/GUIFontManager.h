@@ -77,6 +77,11 @@ public:
   void Clear();
   void FreeFontFile(CGUIFontTTFBase *pFont);
 
+  /*! \brief Render the printable ascii glyphs of every loaded font into their glyph textures
+   Saves growing the glyph textures a few letters at a time during the first frames drawn.
+   */
+  void CacheCommonGlyphs();
+
   bool IsFontSetUnicode() { return m_fontsetUnicode; }
   bool IsFontSetUnicode(const CStdString& strFontSet);
   bool GetFirstFontSetUnicode(CStdString& strFontSet);
@@ -50,6 +50,9 @@ using namespace std;
 #define CHARS_PER_TEXTURE_LINE 20 // number of characters to cache per texture line
 #define CHAR_CHUNK    64      // 64 chars allocated at a time (1024 bytes)
 
+unsigned int CGUIFontTTFBase::s_nextGeneration = 0;
+CGUIFontTTFBase *CGUIFontTTFBase::s_batchFont = NULL;
+
 int CGUIFontTTFBase::justification_word_weight = 6;   // weight of word spacing over letter spacing when justifying.
                                                   // A larger number means more of the "dead space" is placed between
                                                   // words rather than between letters.
@@ -165,6 +168,7 @@ CGUIFontTTFBase::CGUIFontTTFBase(const CStdString& strFileName)
   m_nestedBeginCount = 0;
 
   m_bTextureLoaded = false;
+  m_generation = ++s_nextGeneration;
   m_vertex_size   = 4*1024;
   m_vertex        = (SVertex*)malloc(m_vertex_size * sizeof(SVertex));
 
@@ -206,6 +210,10 @@ void CGUIFontTTFBase::RemoveReference()
 
 void CGUIFontTTFBase::ClearCharacterCache()
 {
+  if (s_batchFont == this)
+    FlushBatch();
+  m_generation = ++s_nextGeneration;
+
   delete(m_texture);
 
   DeleteHardwareTexture();
@@ -242,6 +250,10 @@ void CGUIFontTTFBase::Clear()
     g_freeTypeLibrary.ReleaseStroker(m_stroker);
   m_stroker = NULL;
 
+  // whatever was held back for drawing goes with us
+  if (s_batchFont == this)
+    s_batchFont = NULL;
+
   free(m_vertex);
   m_vertex = NULL;
   m_vertex_count = 0;
@@ -329,6 +341,7 @@ bool CGUIFontTTFBase::Load(const CStdString& strFile, float height, float aspect
 void CGUIFontTTFBase::DrawTextInternal(float x, float y, const vecColors &colors, const vecText &text, uint32_t alignment, float maxPixelWidth, bool scrolling)
 {
   Begin();
+  int start = m_vertex_count;
 
   // save the origin, which is scaled separately
   m_originX = x;
@@ -431,9 +444,52 @@ void CGUIFontTTFBase::DrawTextInternal(float x, float y, const vecColors &colors
       cursorX += ch->advance;
   }
 
+  TrackVertices(start);
   End();
 }
 
+void CGUIFontTTFBase::AddVertices(const SVertex *vertices, int count)
+{
+  int start = m_vertex_count;
+  if (m_vertex_count + count > m_vertex_size)
+  {
+    while (m_vertex_count + count > m_vertex_size)
+      m_vertex_size *= 2;
+    m_vertex = (SVertex*)realloc(m_vertex, m_vertex_size * sizeof(SVertex));
+  }
+  memcpy(m_vertex + m_vertex_count, vertices, count * sizeof(SVertex));
+  for (int i = 0; i + 3 < count; i += 4)
+    RenderInternal(m_vertex + m_vertex_count + i);
+  m_vertex_count += count;
+
+  TrackVertices(start);
+}
+
+void CGUIFontTTFBase::TrackVertices(int start) const
+{
+  CDirtyRegionTracker &dirtyRegions = g_graphicsContext.GetDirtyRegions();
+  if (!dirtyRegions.IsTracking())
+    return;
+
+  for (int i = start; i < m_vertex_count; i++)
+  {
+    const SVertex &v = m_vertex[i];
+    dirtyRegions.AddVertices(&v.x, &v.y, &v.z, 1);
+    dirtyRegions.AddState(&v, offsetof(SVertex, x)); // texture coordinates and color
+  }
+}
+
+void CGUIFontTTFBase::FlushBatch()
+{
+  if (!s_batchFont)
+    return;
+
+  CGUIFontTTFBase *font = s_batchFont;
+  s_batchFont = NULL;
+  font->RenderBatch();
+  font->m_vertex_count = 0;
+}
+
 // this routine assumes a single line (i.e. it was called from GUITextLayout)
 float CGUIFontTTFBase::GetTextWidthInternal(vecText::const_iterator start, vecText::const_iterator end)
 {
@@ -608,6 +664,7 @@ bool CGUIFontTTFBase::CacheCharacter(wchar_t letter, uint32_t style, Character *
         return false;
       }
 
+      unsigned int oldHeight = m_textureHeight;
       CBaseTexture* newTexture = NULL;
       newTexture = ReallocTexture(newHeight);
       if(newTexture == NULL)
@@ -617,6 +674,15 @@ bool CGUIFontTTFBase::CacheCharacter(wchar_t letter, uint32_t style, Character *
         return false;
       }
       m_texture = newTexture;
+
+      // text laid out already, and not yet drawn, has coordinates for the old height
+      if (oldHeight)
+      {
+        float scale = (float)oldHeight / m_textureHeight;
+        for (int i = 0; i < m_vertex_count; i++)
+          m_vertex[i].v *= scale;
+      }
+      m_generation = ++s_nextGeneration;
     }
   }
 
@@ -28,6 +28,8 @@
  *
  */
 
+#include "GUIFont.h"
+
 // forward definition
 class CBaseTexture;
 
@@ -52,15 +54,6 @@ typedef std::vector<color_t> vecColors;
  \ingroup textures
  \brief
  */
-
-typedef struct _SVertex
-{
-  float u, v;
-  unsigned char r, g, b, a;
-  float x, y, z;
-} SVertex;
-
-
 class CGUIFontTTFBase
 {
   friend class CGUIFont;
@@ -77,6 +70,13 @@ public:
   virtual void Begin() = 0;
   virtual void End() = 0;
 
+  /*! \brief Draw the text held back by the last font to End(), if any
+   Backends that batch keep the vertices of consecutive text draws with one font and draw
+   them together once something else needs drawing.
+   \sa CGraphicContext::FlushBatches
+   */
+  static void FlushBatch();
+
   const CStdString& GetFileName() const { return m_strFileName; };
 
 protected:
@@ -107,11 +107,14 @@ protected:
   bool CacheCharacter(wchar_t letter, uint32_t style, Character *ch);
   void RenderCharacter(float posX, float posY, const Character *ch, color_t color, bool roundX);
   void ClearCharacterCache();
+  void AddVertices(const SVertex *vertices, int count);
+  void TrackVertices(int start) const;
 
   virtual CBaseTexture* ReallocTexture(unsigned int& newHeight) = 0;
   virtual bool CopyCharToTexture(FT_BitmapGlyph bitGlyph, Character *ch) = 0;
   virtual void DeleteHardwareTexture() = 0;
   virtual void RenderInternal(SVertex* v) = 0;
+  virtual void RenderBatch() {};
 
   // modifying glyphs
   void EmboldenGlyph(FT_GlyphSlot slot);
@@ -152,6 +155,10 @@ protected:
   int      m_vertex_count;
   int      m_vertex_size;
 
+  unsigned int m_generation;            // changes when vertices laid out before are no longer valid
+  static unsigned int s_nextGeneration;
+  static CGUIFontTTFBase *s_batchFont;  // font whose vertices are waiting for RenderBatch()
+
   float    m_textureScaleX;
   float    m_textureScaleY;
 
@@ -29,7 +29,9 @@
 #pragma once
 
 
+#include <vector>
 #include "GUIFontTTF.h"
+#include "system.h" // for GLuint
 
 
 /*!
@@ -50,7 +52,17 @@ protected:
   virtual bool CopyCharToTexture(FT_BitmapGlyph bitGlyph, Character *ch);
   virtual void DeleteHardwareTexture();
   virtual void RenderInternal(SVertex* v) {}
+  virtual void RenderBatch();
 
+private:
+  void UploadVertices(const SVertex *vertices, unsigned int count);
+  void DeleteVertexBuffer();
+
+  GLuint       m_vertexBuffer;      ///< persistent buffer object the batch is drawn from
+  unsigned int m_vertexBufferSize;  ///< in bytes
+#ifndef HAS_GL
+  std::vector<SVertex> m_triangles; ///< the batch as triangles, as GLES can't draw quads
+#endif
 };
 
 #endif
@@ -80,6 +80,17 @@ void CGUIImage::UpdateInfo(const CGUIListItem *item)
     SetFileName(m_info.GetLabel(m_parentID, true));
 }
 
+void CGUIImage::GetItemImages(const CGUIListItem *item, vector<CStdString> &images) const
+{
+  if (m_info.IsConstant() || !item)
+    return;
+
+  // only large textures are loaded in the background, so only they are worth asking for early
+  CStdString image = m_info.GetItemLabel(item, true);
+  if (!image.IsEmpty() && (m_texture.IsLazyLoaded() || !g_TextureManager.CanLoad(image)))
+    images.push_back(image);
+}
+
 void CGUIImage::AllocateOnDemand()
 {
   // if we're hidden, we can free our resources and return
@@ -79,6 +79,7 @@ public:
   virtual void SetLazyLoaded() { m_texture.SetLazyLoaded(); }
   virtual bool CanFocus() const;
   virtual void UpdateInfo(const CGUIListItem *item = NULL);
+  virtual void GetItemImages(const CGUIListItem *item, std::vector<CStdString> &images) const;
 
   virtual void SetInfo(const CGUIInfoLabel &info);
   virtual void SetFileName(const CStdString& strFileName, bool setConstant = false);
@@ -29,6 +29,7 @@ using namespace std;
 
 CGUIIncludes::CGUIIncludes()
 {
+  m_conditions = NULL;
 }
 
 CGUIIncludes::~CGUIIncludes()
@@ -151,7 +152,10 @@ void CGUIIncludes::ResolveIncludes(TiXmlElement *node, const CStdString &type)
     const char *condition = include->Attribute("condition");
     if (condition)
     { // check this condition
-      if (!g_infoManager.GetBool(g_infoManager.TranslateString(condition)))
+      bool value = g_infoManager.GetBool(g_infoManager.TranslateString(condition));
+      if (m_conditions)
+        m_conditions->push_back(make_pair(CStdString(condition), value));
+      if (!value)
       {
         include = include->NextSiblingElement("include");
         continue;
@@ -182,6 +186,18 @@ void CGUIIncludes::ResolveIncludes(TiXmlElement *node, const CStdString &type)
   }
 }
 
+void CGUIIncludes::ResolveAllIncludes(TiXmlElement *node, vector< pair<CStdString, bool> > &conditions)
+{
+  if (!node) return;
+
+  m_conditions = &conditions;
+  ResolveIncludes(node, "");
+  m_conditions = NULL;
+
+  for (TiXmlElement *child = node->FirstChildElement(); child; child = child->NextSiblingElement())
+    ResolveAllIncludes(child, conditions);
+}
+
 bool CGUIIncludes::ResolveConstant(const CStdString &constant, float &value) const
 {
   map<CStdString, float>::const_iterator it = m_constants.find(constant);
@@ -24,6 +24,7 @@
 #include "StdString.h"
 
 #include <map>
+#include <vector>
 
 // forward definitions
 class TiXmlElement;
@@ -40,6 +41,15 @@ public:
   bool ResolveConstant(const CStdString &constant, float &value) const;
   bool LoadIncludesFromXML(const TiXmlElement *root);
 
+  /*! \brief Resolve the includes of a node and everything below it
+   \param conditions [out] conditions the result depends on, with their current value
+   */
+  void ResolveAllIncludes(TiXmlElement *node, std::vector< std::pair<CStdString, bool> > &conditions);
+
+  /*! \brief Include files loaded so far
+   */
+  const std::vector<CStdString> &GetFiles() const { return m_files; };
+
 private:
   bool HasIncludeFile(const CStdString &includeFile) const;
   std::map<CStdString, TiXmlElement> m_includes;
@@ -47,5 +57,7 @@ private:
   std::map<CStdString, float> m_constants;
   std::vector<CStdString> m_files;
   typedef std::vector<CStdString>::const_iterator iFiles;
+
+  std::vector< std::pair<CStdString, bool> > *m_conditions; ///< where ResolveIncludes() records conditions, if anywhere
 };
 
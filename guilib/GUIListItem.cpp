@@ -22,6 +22,36 @@
 #include "GUIListItem.h"
 #include "GUIListItemLayout.h"
 #include "utils/Archive.h"
+#include "utils/SingleLock.h"
+
+#include <algorithm>
+#include <deque>
+
+namespace
+{
+  // Every property name we've ever seen. Names match case-insensitively, and keep the
+  // spelling they were first seen with.
+  struct PropertyKeyTable
+  {
+    std::map<CStdString, CGUIListItem::PropertyKey, CGUIListItem::icompare> keys;
+    std::deque<CStdString> names; // push_back leaves references to older names alone
+    CCriticalSection lock;
+  };
+
+  PropertyKeyTable &GetPropertyKeyTable()
+  {
+    static PropertyKeyTable *table = new PropertyKeyTable;
+    return *table;
+  }
+
+  struct PropertyKeyLess
+  {
+    bool operator()(const CGUIListItem::Property &property, CGUIListItem::PropertyKey key) const
+    {
+      return property.first < key;
+    }
+  };
+}
 
 CGUIListItem::CGUIListItem(const CGUIListItem& item)
 {
@@ -245,10 +275,10 @@ void CGUIListItem::Serialize(CArchive &ar)
     ar << m_bSelected;
     ar << m_overlayIcon;
     ar << (int)m_mapProperties.size();
-    for (std::map<CStdString, CStdString, icompare>::const_iterator it = m_mapProperties.begin(); it != m_mapProperties.end(); it++)
+    for (PropertyMap::const_iterator it = m_mapProperties.begin(); it != m_mapProperties.end(); it++)
     {
-      ar << it->first;
-      ar << it->second;
+      ar << GetPropertyName(it->first);
+      ar << *it->second;
     }
   }
   else
@@ -329,39 +359,116 @@ void CGUIListItem::SetInvalid()
   if (m_focusedLayout) m_focusedLayout->SetInvalid();
 }
 
+CGUIListItem::PropertyKey CGUIListItem::GetPropertyKey(const CStdString &strKey)
+{
+  PropertyKeyTable &table = GetPropertyKeyTable();
+  CSingleLock lock(table.lock);
+
+  std::map<CStdString, PropertyKey, icompare>::const_iterator i = table.keys.find(strKey);
+  if (i != table.keys.end())
+    return i->second;
+
+  PropertyKey key = table.names.size();
+  table.names.push_back(strKey);
+  table.keys[strKey] = key;
+  return key;
+}
+
+bool CGUIListItem::FindPropertyKey(const CStdString &strKey, PropertyKey &key)
+{
+  // Lookups don't add to the table; a name nobody ever set can't be on any item.
+  PropertyKeyTable &table = GetPropertyKeyTable();
+  CSingleLock lock(table.lock);
+
+  std::map<CStdString, PropertyKey, icompare>::const_iterator i = table.keys.find(strKey);
+  if (i == table.keys.end())
+    return false;
+
+  key = i->second;
+  return true;
+}
+
+const CStdString &CGUIListItem::GetPropertyName(PropertyKey key)
+{
+  PropertyKeyTable &table = GetPropertyKeyTable();
+  CSingleLock lock(table.lock);
+  return table.names[key];
+}
+
+const CGUIListItem::PropertyValue *CGUIListItem::FindProperty(PropertyKey key) const
+{
+  PropertyMap::const_iterator i = std::lower_bound(m_mapProperties.begin(), m_mapProperties.end(), key, PropertyKeyLess());
+  if (i == m_mapProperties.end() || i->first != key)
+    return NULL;
+
+  return &i->second;
+}
+
+void CGUIListItem::SetProperty(PropertyKey key, const PropertyValue &value)
+{
+  PropertyMap::iterator i = std::lower_bound(m_mapProperties.begin(), m_mapProperties.end(), key, PropertyKeyLess());
+  if (i != m_mapProperties.end() && i->first == key)
+    i->second = value;
+  else
+    m_mapProperties.insert(i, Property(key, value));
+}
+
+void CGUIListItem::SetProperty(const CStdString &strKey, const PropertyValue &value)
+{
+  SetProperty(GetPropertyKey(strKey), value);
+}
+
 void CGUIListItem::SetProperty(const CStdString &strKey, const char *strValue)
 {
-  m_mapProperties[strKey] = strValue;
+  SetProperty(GetPropertyKey(strKey), MakePropertyValue(strValue));
 }
 
 void CGUIListItem::SetProperty(const CStdString &strKey, const CStdString &strValue)
 {
-  m_mapProperties[strKey] = strValue;
+  SetProperty(GetPropertyKey(strKey), MakePropertyValue(strValue));
+}
+
+CStdString CGUIListItem::GetProperty(PropertyKey key) const
+{
+  const PropertyValue *value = FindProperty(key);
+  if (value == NULL)
+    return "";
+
+  return **value;
+}
+
+bool CGUIListItem::HasProperty(PropertyKey key) const
+{
+  return FindProperty(key) != NULL;
 }
 
 CStdString CGUIListItem::GetProperty(const CStdString &strKey) const
 {
-  PropertyMap::const_iterator iter = m_mapProperties.find(strKey);
-  if (iter == m_mapProperties.end())
+  PropertyKey key;
+  if (!FindPropertyKey(strKey, key))
     return "";
 
-  return iter->second;
+  return GetProperty(key);
 }
 
 bool CGUIListItem::HasProperty(const CStdString &strKey) const
 {
-  PropertyMap::const_iterator iter = m_mapProperties.find(strKey);
-  if (iter == m_mapProperties.end())
+  PropertyKey key;
+  if (!FindPropertyKey(strKey, key))
     return false;
 
-  return true;
+  return HasProperty(key);
 }
 
 void CGUIListItem::ClearProperty(const CStdString &strKey)
 {
-  PropertyMap::iterator iter = m_mapProperties.find(strKey);
-  if (iter != m_mapProperties.end())
-    m_mapProperties.erase(iter);
+  PropertyKey key;
+  if (!FindPropertyKey(strKey, key))
+    return;
+
+  PropertyMap::iterator i = std::lower_bound(m_mapProperties.begin(), m_mapProperties.end(), key, PropertyKeyLess());
+  if (i != m_mapProperties.end() && i->first == key)
+    m_mapProperties.erase(i);
 }
 
 void CGUIListItem::ClearProperties()
@@ -35,6 +35,8 @@
 #include <string>
 #include <vector>
 
+#include <boost/shared_ptr.hpp>
+
 //  Forward
 class CGUIListItemLayout;
 class CArchive;
@@ -110,8 +112,24 @@ public:
 
   bool m_bIsFolder;     ///< is item a folder or a file
 
+  /*! \brief Property names are interned into a process-wide table, so an item only holds small
+   integer keys. Hot lookups (e.g. from the skin) should resolve the key once and use the
+   PropertyKey overloads.
+   */
+  typedef unsigned int PropertyKey;
+  typedef boost::shared_ptr<const CStdString> PropertyValue;
+  static PropertyKey GetPropertyKey(const CStdString &strKey);
+  static const CStdString &GetPropertyName(PropertyKey key);
+
+  /*! \brief Make a value that can be shared between many items, e.g. one that's the same
+   for every item in a listing.
+   */
+  static PropertyValue MakePropertyValue(const CStdString &strValue) { return PropertyValue(new CStdString(strValue)); }
+
   void SetProperty(const CStdString &strKey, const char *strValue);
   void SetProperty(const CStdString &strKey, const CStdString &strValue);
+  void SetProperty(const CStdString &strKey, const PropertyValue &value);
+  void SetProperty(PropertyKey key, const PropertyValue &value);
   void SetProperty(const CStdString &strKey, int nVal);
   void SetProperty(const CStdString &strKey, bool bVal);
   void SetProperty(const CStdString &strKey, double dVal);
@@ -129,6 +147,8 @@ public:
   void       ClearProperty(const CStdString &strKey);
 
   CStdString GetProperty(const CStdString &strKey) const;
+  CStdString GetProperty(PropertyKey key) const;
+  bool       HasProperty(PropertyKey key) const;
   bool       GetPropertyBOOL(const CStdString &strKey) const;
   int        GetPropertyInt(const CStdString &strKey) const;
   double     GetPropertyDouble(const CStdString &strKey) const;
@@ -154,13 +174,19 @@ public:
       return s1.CompareNoCase(s2) < 0;
     }
   };
-  typedef std::map<CStdString, CStdString, icompare> PropertyMap;
+
+  /// Properties as (key, value) pairs, kept sorted by key.
+  typedef std::pair<PropertyKey, PropertyValue> Property;
+  typedef std::vector<Property> PropertyMap;
 
 protected:
   PropertyMap m_mapProperties;
 
+  const PropertyValue *FindProperty(PropertyKey key) const;
+  static bool FindPropertyKey(const CStdString &strKey, PropertyKey &key);
+
 public:
-  PropertyMap& GetPropertyDict() { return m_mapProperties; }
+  const PropertyMap& GetPropertyDict() const { return m_mapProperties; }
 
 private:
   CStdString m_sortLabel;     // text for sorting
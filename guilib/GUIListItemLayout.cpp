@@ -94,6 +94,11 @@ void CGUIListItemLayout::Render(CGUIListItem *item, int parentID, unsigned int t
   m_group.DoRender(time);
 }
 
+void CGUIListItemLayout::GetItemImages(const CGUIListItem *item, vector<CStdString> &images) const
+{
+  m_group.GetItemImages(item, images);
+}
+
 void CGUIListItemLayout::SetFocusedItem(unsigned int focus)
 {
   m_group.SetFocusedItem(focus);
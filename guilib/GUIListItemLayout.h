@@ -53,6 +53,7 @@ public:
   bool MoveRight();
 
   int GetCondition() const { return m_condition; };
+  void GetItemImages(const CGUIListItem *item, std::vector<CStdString> &images) const;
 #ifdef _DEBUG
   virtual void DumpTextureUse();
 #endif
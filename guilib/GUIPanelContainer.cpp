@@ -57,6 +57,8 @@ void CGUIPanelContainer::Render()
   // Free memory not used on screen at the moment, do this first so there's more memory for the new items.
   FreeMemory(CorrectOffset(offset - cacheBefore, 0), CorrectOffset(offset + cacheAfter + m_itemsPerPage + 1, 0));
 
+  PrefetchImages(CorrectOffset(offset, 0), (m_itemsPerPage + 1) * m_itemsPerRow, cacheBefore * m_itemsPerRow, cacheAfter * m_itemsPerRow);
+
   g_graphicsContext.SetClipRegion(m_posX, m_posY, m_width, m_height);
   CPoint origin = CPoint(m_posX, m_posY) + m_renderOffset;
   float pos = (m_orientation == VERTICAL) ? origin.y : origin.x;
@@ -87,6 +87,7 @@ void CGUIRenderingControl::Render()
     // the addon renders, so the best we can do is attempt to define
     // a viewport??
     g_graphicsContext.SetViewPort(m_posX, m_posY, m_width, m_height);
+    MarkDirtyRegion(); // the addon may draw something new every frame
     g_graphicsContext.CaptureStateBlock();
     m_addon->Render();
     g_graphicsContext.ApplyStateBlock();
@@ -53,6 +53,7 @@ CGUITextLayout::CGUITextLayout(CGUIFont *font, bool wrap, float fHeight, CGUIFon
   m_maxHeight = fHeight;
   m_textWidth = 0;
   m_textHeight = 0;
+  m_renderCached = false;
 }
 
 void CGUITextLayout::SetWrap(bool bWrap)
@@ -81,24 +82,59 @@ void CGUITextLayout::Render(float x, float y, float angle, color_t color, color_
     y -= m_font->GetTextHeight(m_lines.size()) * 0.5f;;
     alignment &= ~XBFONT_CENTER_Y;
   }
+  CRenderKey key;
+  key.x = x;
+  key.y = y;
+  key.color = color;
+  key.shadowColor = shadowColor;
+  key.alignment = alignment;
+  key.maxWidth = maxWidth;
+  key.solid = solid;
+  key.guiScaleX = g_graphicsContext.GetGUIScaleX();
+  key.generation = m_font->GetGeneration();
+  key.clip = g_graphicsContext.GetClipRegion();
+  key.transform = g_graphicsContext.GetFinalTransform();
+
   m_font->Begin();
-  for (vector<CGUIString>::iterator i = m_lines.begin(); i != m_lines.end(); i++)
+  if (m_renderCached && key == m_renderKey)
+    m_font->AddVertices(m_renderCache);
+  else
   {
-    const CGUIString &string = *i;
-    uint32_t align = alignment;
-    if (align & XBFONT_JUSTIFIED && string.m_carriageReturn)
-      align &= ~XBFONT_JUSTIFIED;
-    if (solid)
-      m_font->DrawText(x, y, m_colors[0], shadowColor, string.m_text, align, maxWidth);
-    else
-      m_font->DrawText(x, y, m_colors, shadowColor, string.m_text, align, maxWidth);
-    y += m_font->GetLineHeight();
+    unsigned int start = m_font->GetVertexCount();
+    for (vector<CGUIString>::iterator i = m_lines.begin(); i != m_lines.end(); i++)
+    {
+      const CGUIString &string = *i;
+      uint32_t align = alignment;
+      if (align & XBFONT_JUSTIFIED && string.m_carriageReturn)
+        align &= ~XBFONT_JUSTIFIED;
+      if (solid)
+        m_font->DrawText(x, y, m_colors[0], shadowColor, string.m_text, align, maxWidth);
+      else
+        m_font->DrawText(x, y, m_colors, shadowColor, string.m_text, align, maxWidth);
+      y += m_font->GetLineHeight();
+    }
+    m_font->GetVertices(start, m_renderCache);
+
+    // laying out may have grown the glyph texture
+    key.generation = m_font->GetGeneration();
+    m_renderKey = key;
+    m_renderCached = true;
   }
   m_font->End();
   if (angle)
     g_graphicsContext.RemoveTransform();
 }
 
+bool CGUITextLayout::CRenderKey::operator==(const CRenderKey &right) const
+{
+  return x == right.x && y == right.y &&
+         color == right.color && shadowColor == right.shadowColor &&
+         alignment == right.alignment && maxWidth == right.maxWidth &&
+         solid == right.solid && guiScaleX == right.guiScaleX &&
+         generation == right.generation && clip == right.clip &&
+         transform == right.transform;
+}
+
 
 void CGUITextLayout::RenderScrolling(float x, float y, float angle, color_t color, color_t shadowColor, uint32_t alignment, float maxWidth, CScrollInfo &scrollInfo)
 {
@@ -215,6 +251,7 @@ void CGUITextLayout::SetText(const CStdStringW &text, float maxWidth, bool force
   vecText parsedText;
 
   // empty out our previous string
+  m_renderCached = false;
   m_lines.clear();
   m_colors.clear();
   m_colors.push_back(m_textColor);
@@ -621,6 +658,7 @@ void CGUITextLayout::AppendToUTF32(const CStdString &utf8, character_t colStyle,
 
 void CGUITextLayout::Reset()
 {
+  m_renderCached = false;
   m_lines.clear();
   m_lastText.Empty();
   m_textWidth = m_textHeight = 0;
@@ -22,6 +22,9 @@
  */
 
 #include "StdString.h"
+#include "GUIFont.h"
+#include "Geometry.h"
+#include "TransformMatrix.h"
 
 #include <vector>
 
@@ -125,6 +128,27 @@ protected:
   CStdString m_lastText;
   float m_textWidth;
   float m_textHeight;
+
+  // everything that decides where Render() puts the glyphs
+  struct CRenderKey
+  {
+    float x, y;
+    color_t color, shadowColor;
+    uint32_t alignment;
+    float maxWidth;
+    bool solid;
+    float guiScaleX;
+    unsigned int generation;
+    CRect clip;
+    TransformMatrix transform;
+
+    bool operator==(const CRenderKey &right) const;
+  };
+
+  // the glyphs from the last Render(), drawn again while nothing that placed them has changed
+  CRenderKey m_renderKey;
+  bool m_renderCached;
+  std::vector<SVertex> m_renderCache;
 private:
   inline bool IsSpace(character_t letter) const XBMC_FORCE_INLINE
   {
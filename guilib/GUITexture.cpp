@@ -174,7 +174,20 @@ void CGUITextureBase::Render()
   if (m_alpha != 0xFF) color = MIX_ALPHA(m_alpha, m_diffuseColor);
   color = g_graphicsContext.MergeAlpha(color);
 
-  // setup our renderer
+  // what we draw with decides what we look like as much as where we draw
+  CDirtyRegionTracker &dirtyRegions = g_graphicsContext.GetDirtyRegions();
+  if (dirtyRegions.IsTracking())
+  {
+    CBaseTexture *texture = m_texture.m_textures[m_currentFrame];
+    CBaseTexture *diffuse = m_diffuse.size() ? m_diffuse.m_textures[0] : NULL;
+    dirtyRegions.AddState(&texture, sizeof(texture));
+    dirtyRegions.AddState(&diffuse, sizeof(diffuse));
+    dirtyRegions.AddState(&color, sizeof(color));
+  }
+
+  // setup our renderer, after any text that's been drawn before us. Textures batch up
+  // themselves, so are left for Begin() to flush if need be
+  g_graphicsContext.FlushTextBatch();
   Begin(color);
 
   // compute the texture coordinates
@@ -244,6 +257,7 @@ void CGUITextureBase::Render(float left, float top, float right, float bottom, f
 
   int orientation = GetOrientation();
   OrientateTexture(texture, u3, v3, orientation);
+  texture += m_texCoordsOffset;
 
   if (m_diffuse.size())
   {
@@ -253,6 +267,7 @@ void CGUITextureBase::Render(float left, float top, float right, float bottom, f
     diffuse.y1 *= m_diffuseScaleV / v3; diffuse.y2 *= m_diffuseScaleV / v3;
     diffuse += m_diffuseOffset;
     OrientateTexture(diffuse, m_diffuseU, m_diffuseV, m_info.orientation);
+    diffuse += m_diffuseAtlasOffset;
   }
 
   float x[4], y[4], z[4];
@@ -275,6 +290,15 @@ void CGUITextureBase::Render(float left, float top, float right, float bottom, f
   if (y[2] == y[0]) y[2] += 1.0f; if (x[2] == x[0]) x[2] += 1.0f;
   if (y[3] == y[1]) y[3] += 1.0f; if (x[3] == x[1]) x[3] += 1.0f;
 
+  CDirtyRegionTracker &dirtyRegions = g_graphicsContext.GetDirtyRegions();
+  if (dirtyRegions.IsTracking())
+  {
+    dirtyRegions.AddVertices(x, y, z, 4);
+    dirtyRegions.AddState(&texture, sizeof(texture));
+    dirtyRegions.AddState(&diffuse, sizeof(diffuse));
+    dirtyRegions.AddState(&orientation, sizeof(orientation));
+  }
+
   Draw(x, y, z, texture, diffuse, orientation);
 }
 
@@ -354,6 +378,10 @@ void CGUITextureBase::CalculateSize()
 
   m_texCoordsScaleU = 1.0f / m_texture.m_texWidth;
   m_texCoordsScaleV = 1.0f / m_texture.m_texHeight;
+  if (m_texture.m_texCoordsArePixels)
+    m_texCoordsOffset = CPoint((float)m_texture.m_atlasX, (float)m_texture.m_atlasY);
+  else
+    m_texCoordsOffset = CPoint(m_texture.m_atlasX * m_texCoordsScaleU, m_texture.m_atlasY * m_texCoordsScaleV);
 
   if (m_width == 0)
     m_width = m_frameWidth;
@@ -412,11 +440,13 @@ void CGUITextureBase::CalculateSize()
     {
       m_diffuseU = float(m_diffuse.m_width);
       m_diffuseV = float(m_diffuse.m_height);
+      m_diffuseAtlasOffset = CPoint(float(m_diffuse.m_atlasX), float(m_diffuse.m_atlasY));
     }
     else
     {
       m_diffuseU = float(m_diffuse.m_width) / float(m_diffuse.m_texWidth);
       m_diffuseV = float(m_diffuse.m_height) / float(m_diffuse.m_texHeight);
+      m_diffuseAtlasOffset = CPoint(float(m_diffuse.m_atlasX) / float(m_diffuse.m_texWidth), float(m_diffuse.m_atlasY) / float(m_diffuse.m_texHeight));
     }
 
     if (m_aspect.scaleDiffuse)
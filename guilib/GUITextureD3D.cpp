@@ -21,6 +21,7 @@
 
 #include "Texture.h"
 #include "GUITextureD3D.h"
+#include "GraphicContext.h"
 #include "WindowingFactory.h"
 
 #ifdef HAS_DX
@@ -175,6 +176,19 @@ void CGUITextureD3D::DrawQuad(const CRect &rect, color_t color, CBaseTexture *te
       FLOAT tu2, tv2;
   };
 
+  g_graphicsContext.FlushBatches();
+
+  CDirtyRegionTracker &dirtyRegions = g_graphicsContext.GetDirtyRegions();
+  if (texture)
+    dirtyRegions.MarkDirty(rect); // may be a render target that changes under us
+  else if (dirtyRegions.IsTracking())
+  {
+    float x[4] = { rect.x1, rect.x2, rect.x2, rect.x1 };
+    float y[4] = { rect.y1, rect.y1, rect.y2, rect.y2 };
+    dirtyRegions.AddVertices(x, y, NULL, 4);
+    dirtyRegions.AddState(&color, sizeof(color));
+  }
+
   LPDIRECT3DDEVICE9 p3DDevice = g_Windowing.Get3DDevice();
 
   if (texture)
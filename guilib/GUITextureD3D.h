@@ -38,6 +38,7 @@ class CGUITextureD3D : public CGUITextureBase
 public:
   CGUITextureD3D(float posX, float posY, float width, float height, const CTextureInfo& texture, float minWidth=0.0f);
   static void DrawQuad(const CRect &coords, color_t color, CBaseTexture *texture = NULL, const CRect *texCoords = NULL);
+  static void FlushBatch() {}; ///< textures are drawn as they're rendered
 protected:
   void Begin(color_t color);
   void Draw(float *x, float *y, float *z, const CRect &texture, const CRect &diffuse, int orientation);
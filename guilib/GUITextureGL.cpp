@@ -24,13 +24,18 @@
 #include "GUITextureGL.h"
 #endif
 #include "Texture.h"
+#include "GraphicContext.h"
 #include "utils/log.h"
 
 #if defined(HAS_GL)
 
+CBaseTexture *CGUITextureGL::s_batchTexture = NULL;
+std::vector<CGUITextureGL::SBatchVertex> CGUITextureGL::s_batch;
+
 CGUITextureGL::CGUITextureGL(float posX, float posY, float width, float height, const CTextureInfo &texture, float minWidth)
 : CGUITextureBase(posX, posY, width, height, texture, minWidth)
 {
+  m_batching = false;
 }
 
 void CGUITextureGL::Begin(color_t color)
@@ -40,7 +45,13 @@ void CGUITextureGL::Begin(color_t color)
   m_col[2] = (GLubyte)GET_B(color);
   m_col[3] = (GLubyte)GET_A(color);
 
+  // a diffuse needs the second texture unit set up as well, so those are drawn on their own
   CBaseTexture* texture = m_texture.m_textures[m_currentFrame];
+  m_batching = !m_diffuse.size();
+  if (m_batching && s_batchTexture == texture)
+    return; // the state is already set up for the batch we're adding to
+
+  FlushBatch();
   glActiveTextureARB(GL_TEXTURE0_ARB);
   texture->LoadToGPU();
   if (m_diffuse.size())
@@ -75,6 +86,11 @@ void CGUITextureGL::Begin(color_t color)
     glTexEnvf(GL_TEXTURE_ENV, GL_OPERAND1_RGB, GL_SRC_COLOR);
     VerifyGLState();
   }
+  if (m_batching)
+  {
+    s_batchTexture = texture;
+    return;
+  }
   //glDisable(GL_TEXTURE_2D); // uncomment these 2 lines to switch to wireframe rendering
   //glBegin(GL_LINE_LOOP);
   glBegin(GL_QUADS);
@@ -82,6 +98,10 @@ void CGUITextureGL::Begin(color_t color)
 
 void CGUITextureGL::End()
 {
+  // batched quads are left for FlushBatch()
+  if (m_batching)
+    return;
+
   glEnd();
   if (m_diffuse.size())
   {
@@ -93,6 +113,24 @@ void CGUITextureGL::End()
 
 void CGUITextureGL::Draw(float *x, float *y, float *z, const CRect &texture, const CRect &diffuse, int orientation)
 {
+  if (m_batching)
+  {
+    // clockwise from the top-left corner, as below
+    float u[4] = { texture.x1, texture.x2, texture.x2, texture.x1 };
+    float v[4] = { texture.y1, texture.y1, texture.y2, texture.y2 };
+    if (orientation & 4)
+    {
+      u[1] = texture.x1; v[1] = texture.y2;
+      u[3] = texture.x2; v[3] = texture.y1;
+    }
+    for (int i = 0; i < 4; i++)
+    {
+      SBatchVertex vertex = { u[i], v[i], m_col[0], m_col[1], m_col[2], m_col[3], x[i], y[i], z[i] };
+      s_batch.push_back(vertex);
+    }
+    return;
+  }
+
   // Top-left vertex (corner)
   glColor4ub(m_col[0], m_col[1], m_col[2], m_col[3]);
   glMultiTexCoord2fARB(GL_TEXTURE0_ARB, texture.x1, texture.y1);
@@ -138,8 +176,38 @@ void CGUITextureGL::Draw(float *x, float *y, float *z, const CRect &texture, con
   glVertex3f(x[3], y[3], z[3]);
 }
 
+void CGUITextureGL::FlushBatch()
+{
+  if (!s_batchTexture)
+    return;
+  s_batchTexture = NULL;
+
+  if (s_batch.size())
+  {
+    glPushClientAttrib(GL_CLIENT_VERTEX_ARRAY_BIT);
+    glInterleavedArrays(GL_T2F_C4UB_V3F, 0, &s_batch[0]);
+    glDrawArrays(GL_QUADS, 0, s_batch.size());
+    glPopClientAttrib();
+    s_batch.clear();
+  }
+  glDisable(GL_TEXTURE_2D);
+}
+
 void CGUITextureGL::DrawQuad(const CRect &rect, color_t color, CBaseTexture *texture, const CRect *texCoords)
 {
+  g_graphicsContext.FlushBatches();
+
+  CDirtyRegionTracker &dirtyRegions = g_graphicsContext.GetDirtyRegions();
+  if (texture)
+    dirtyRegions.MarkDirty(rect); // may be a render target that changes under us
+  else if (dirtyRegions.IsTracking())
+  {
+    float x[4] = { rect.x1, rect.x2, rect.x2, rect.x1 };
+    float y[4] = { rect.y1, rect.y1, rect.y2, rect.y2 };
+    dirtyRegions.AddVertices(x, y, NULL, 4);
+    dirtyRegions.AddState(&color, sizeof(color));
+  }
+
   if (texture)
   {
     glActiveTextureARB(GL_TEXTURE0_ARB);
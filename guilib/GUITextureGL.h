@@ -30,18 +30,37 @@
  */
 
 #include "GUITexture.h"
+#include <vector>
 
 class CGUITextureGL : public CGUITextureBase
 {
 public:
   CGUITextureGL(float posX, float posY, float width, float height, const CTextureInfo& texture, float minWidth=0.0f);
   static void DrawQuad(const CRect &coords, color_t color, CBaseTexture *texture = NULL, const CRect *texCoords = NULL);
+
+  /*! \brief Draw the quads held back since the texture they use was bound, if any
+   Consecutive textures drawn from the same texture without a diffuse, such as images packed
+   into the same atlas page, go out in one draw call.
+   \sa CGraphicContext::FlushBatches
+   */
+  static void FlushBatch();
 protected:
   void Begin(color_t color);
   void Draw(float *x, float *y, float *z, const CRect &texture, const CRect &diffuse, int orientation);
   void End();
 private:
+  struct SBatchVertex   ///< laid out as GL_T2F_C4UB_V3F
+  {
+    GLfloat u, v;
+    GLubyte r, g, b, a;
+    GLfloat x, y, z;
+  };
+
   GLubyte m_col[4];
+  bool m_batching;      ///< Draw() adds to the batch rather than drawing immediately
+
+  static CBaseTexture *s_batchTexture;  // texture bound for the quads in s_batch
+  static std::vector<SBatchVertex> s_batch;
 };
 
 #endif
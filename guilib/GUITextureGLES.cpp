@@ -24,6 +24,7 @@
 #include "GUITextureGLES.h"
 #endif
 #include "Texture.h"
+#include "GraphicContext.h"
 #include "utils/log.h"
 #include "WindowingFactory.h"
 
@@ -198,6 +199,19 @@ void CGUITextureGLES::Draw(float *x, float *y, float *z, const CRect &texture, c
 
 void CGUITextureGLES::DrawQuad(const CRect &rect, color_t color, CBaseTexture *texture, const CRect *texCoords)
 {
+  g_graphicsContext.FlushBatches();
+
+  CDirtyRegionTracker &dirtyRegions = g_graphicsContext.GetDirtyRegions();
+  if (texture)
+    dirtyRegions.MarkDirty(rect); // may be a render target that changes under us
+  else if (dirtyRegions.IsTracking())
+  {
+    float x[4] = { rect.x1, rect.x2, rect.x2, rect.x1 };
+    float y[4] = { rect.y1, rect.y1, rect.y2, rect.y2 };
+    dirtyRegions.AddVertices(x, y, NULL, 4);
+    dirtyRegions.AddState(&color, sizeof(color));
+  }
+
   if (texture)
   {
     glActiveTexture(GL_TEXTURE0);
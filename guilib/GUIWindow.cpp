@@ -25,9 +25,11 @@
 #include "Key.h"
 #include "LocalizeStrings.h"
 #include "Settings.h"
+#include "AdvancedSettings.h"
 #include "GUIControlFactory.h"
 #include "GUIControlGroup.h"
 #include "GUIControlProfiler.h"
+#include "GUIWindowCache.h"
 #ifdef PRE_SKIN_VERSION_9_10_COMPATIBILITY
 #include "GUIEditControl.h"
 #endif
@@ -116,13 +118,21 @@ bool CGUIWindow::Load(const CStdString& strFileName, bool bContainsPath)
 bool CGUIWindow::LoadXML(const CStdString &strPath, const CStdString &strLowerPath)
 {
   TiXmlDocument xmlDoc;
-  if ( !xmlDoc.LoadFile(strPath) && !xmlDoc.LoadFile(CStdString(strPath).ToLower()) && !xmlDoc.LoadFile(strLowerPath))
+  bool useCache = g_advancedSettings.m_guiSkinCache;
+  if (useCache && CGUIWindowCache::Load(strPath, xmlDoc))
+    return Load(xmlDoc);
+
+  CStdString loadedPath = strPath;
+  if (!xmlDoc.LoadFile(loadedPath) && !xmlDoc.LoadFile(loadedPath = CStdString(strPath).ToLower()) && !xmlDoc.LoadFile(loadedPath = strLowerPath))
   {
     CLog::Log(LOGERROR, "unable to load:%s, Line %d\n%s", strPath.c_str(), xmlDoc.ErrorRow(), xmlDoc.ErrorDesc());
     SetID(WINDOW_INVALID);
     return false;
   }
 
+  if (useCache)
+    CGUIWindowCache::Save(strPath, loadedPath, xmlDoc);
+
   return Load(xmlDoc);
 }
 
@@ -0,0 +1,289 @@
+/*
+ *      Copyright (C) 2005-2010 Team XBMC
+ *      http://www.xbmc.org
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, write to
+ *  the Free Software Foundation, 675 Mass Ave, Cambridge, MA 02139, USA.
+ *  http://www.gnu.org/copyleft/gpl.html
+ *
+ */
+
+#include "system.h"
+#include "GUIWindowCache.h"
+#include "Crc32.h"
+#include "addons/Skin.h"
+#include "FileSystem/File.h"
+#include "FileSystem/Directory.h"
+#include "utils/GUIInfoManager.h"
+#include "utils/MappedFile.h"
+#include "utils/log.h"
+#include "tinyXML/tinyxml.h"
+
+#include <map>
+#include <vector>
+
+using namespace std;
+using namespace XFILE;
+
+#define WINDOW_CACHE_PATH    "special://temp/skincache/"
+#define WINDOW_CACHE_VERSION 1
+
+// builds the file in memory, strings are shared as most of them are tag names
+class CGUIWindowCache::CWriter
+{
+public:
+  CWriter() { AddString(""); }
+
+  uint32_t AddString(const string &str)
+  {
+    map<string, uint32_t>::const_iterator i = m_stringIndex.find(str);
+    if (i != m_stringIndex.end())
+      return i->second;
+    uint32_t offset = (uint32_t)m_strings.size();
+    m_strings.append(str.c_str(), str.size() + 1);
+    m_stringIndex.insert(make_pair(str, offset));
+    return offset;
+  }
+
+  void AddNode(const TiXmlNode *node)
+  {
+    Node entry = { NODE_ELEMENT, 0, (uint32_t)m_attributes.size(), 0, 0 };
+    const TiXmlText *text = node->ToText();
+    if (text)
+      entry.type = text->CDATA() ? NODE_CDATA : NODE_TEXT;
+    entry.value = AddString(node->ValueStr());
+
+    const TiXmlElement *element = node->ToElement();
+    for (const TiXmlAttribute *attribute = element ? element->FirstAttribute() : NULL; attribute; attribute = attribute->Next())
+    {
+      Attribute attr = { AddString(attribute->Name()), AddString(attribute->Value()) };
+      m_attributes.push_back(attr);
+      entry.attributes++;
+    }
+
+    size_t index = m_nodes.size();
+    m_nodes.push_back(entry);
+    for (const TiXmlNode *child = node->FirstChild(); child; child = child->NextSibling())
+    { // comments and the like aren't needed to create the window
+      if (child->ToElement() || child->ToText())
+      {
+        AddNode(child);
+        m_nodes[index].children++;
+      }
+    }
+  }
+
+  vector<Dependency> m_dependencies;
+  vector<Condition>  m_conditions;
+  vector<Node>       m_nodes;
+  vector<Attribute>  m_attributes;
+  string             m_strings;
+
+private:
+  map<string, uint32_t> m_stringIndex;
+};
+
+CStdString CGUIWindowCache::GetCacheFile(const CStdString &path)
+{
+  Crc32 crc;
+  crc.Compute(path);
+
+  CStdString file;
+  file.Format(WINDOW_CACHE_PATH "%08x.bin", (uint32_t)crc);
+  return file;
+}
+
+bool CGUIWindowCache::Stat(const CStdString &path, int64_t &mtime, int64_t &size)
+{
+  struct __stat64 st;
+  if (CFile::Stat(path, &st) != 0)
+    return false;
+  mtime = st.st_mtime;
+  size = st.st_size;
+  return true;
+}
+
+bool CGUIWindowCache::Load(const CStdString &path, TiXmlDocument &doc)
+{
+  CMappedFile file;
+  if (!file.Open(GetCacheFile(path)))
+    return false;
+
+  const uint8_t *data = file.GetData();
+  size_t size = file.GetSize();
+  if (size < sizeof(Header))
+    return false;
+
+  const Header &header = *(const Header *)data;
+  if (memcmp(header.magic, "XBWC", 4) || header.version != WINDOW_CACHE_VERSION || header.size != size)
+    return false;
+
+  // everything is read in place, so make sure the tables fit before touching them
+  uint64_t tables = sizeof(Header) + (uint64_t)header.dependencies * sizeof(Dependency)
+                                   + (uint64_t)header.conditions * sizeof(Condition)
+                                   + (uint64_t)header.nodes * sizeof(Node)
+                                   + (uint64_t)header.attributes * sizeof(Attribute);
+  if (!header.nodes || !header.strings || tables + header.strings != size)
+    return false;
+
+  const Dependency *dependencies = (const Dependency *)(data + sizeof(Header));
+  const Condition  *conditions   = (const Condition *)(dependencies + header.dependencies);
+  const Node       *nodes        = (const Node *)(conditions + header.conditions);
+  const Attribute  *attributes   = (const Attribute *)(nodes + header.nodes);
+  const char       *strings      = (const char *)(attributes + header.attributes);
+  if (strings[header.strings - 1] != 0 || header.source >= header.strings || path != strings + header.source)
+    return false;
+
+  for (uint32_t i = 0; i < header.dependencies; i++)
+  {
+    int64_t mtime, fileSize;
+    if (dependencies[i].path >= header.strings || !Stat(strings + dependencies[i].path, mtime, fileSize) ||
+        mtime != dependencies[i].mtime || fileSize != dependencies[i].size)
+    {
+      CLog::Log(LOGDEBUG, "%s - %s is out of date", __FUNCTION__, path.c_str());
+      return false;
+    }
+  }
+
+  for (uint32_t i = 0; i < header.conditions; i++)
+  {
+    if (conditions[i].condition >= header.strings)
+      return false;
+    bool value = g_infoManager.GetBool(g_infoManager.TranslateString(strings + conditions[i].condition));
+    if (value != (conditions[i].value != 0))
+      return false;
+  }
+
+  uint32_t node = 0;
+  if (!BuildNode(&doc, header, nodes, attributes, strings, node) || node != header.nodes || !doc.RootElement())
+  {
+    CLog::Log(LOGERROR, "%s - %s is corrupt", __FUNCTION__, GetCacheFile(path).c_str());
+    doc.Clear();
+    return false;
+  }
+  return true;
+}
+
+bool CGUIWindowCache::BuildNode(TiXmlNode *parent, const Header &header, const Node *nodes, const Attribute *attributes, const char *strings, uint32_t &node)
+{
+  if (node >= header.nodes)
+    return false;
+
+  const Node &entry = nodes[node++];
+  if (entry.value >= header.strings)
+    return false;
+
+  if (entry.type != NODE_ELEMENT)
+  {
+    TiXmlText text(strings + entry.value);
+    text.SetCDATA(entry.type == NODE_CDATA);
+    return entry.children == 0 && parent->InsertEndChild(text) != NULL;
+  }
+
+  if ((uint64_t)entry.attribute + entry.attributes > header.attributes)
+    return false;
+
+  TiXmlElement *element = new TiXmlElement(strings + entry.value);
+  parent->LinkEndChild(element);
+  for (uint32_t i = 0; i < entry.attributes; i++)
+  {
+    const Attribute &attr = attributes[entry.attribute + i];
+    if (attr.name >= header.strings || attr.value >= header.strings)
+      return false;
+    element->SetAttribute(strings + attr.name, strings + attr.value);
+  }
+
+  for (uint32_t i = 0; i < entry.children; i++)
+  {
+    if (!BuildNode(element, header, nodes, attributes, strings, node))
+      return false;
+  }
+  return true;
+}
+
+void CGUIWindowCache::Save(const CStdString &path, const CStdString &loadedPath, TiXmlDocument &doc)
+{
+  TiXmlElement *root = doc.RootElement();
+  if (!root)
+    return;
+
+  vector< pair<CStdString, bool> > conditions;
+  g_SkinInfo->ResolveAllIncludes(root, conditions);
+
+  CWriter writer;
+
+  // anything the resolved window came from, which includes files loaded for other windows
+  vector<CStdString> files(g_SkinInfo->GetIncludeFiles());
+  files.push_back(loadedPath);
+  for (unsigned int i = 0; i < files.size(); i++)
+  {
+    Dependency dependency = { writer.AddString(files[i]), 0, 0, 0 };
+    if (!Stat(files[i], dependency.mtime, dependency.size))
+      return;
+    writer.m_dependencies.push_back(dependency);
+  }
+
+  // the same condition is often checked more than once
+  map<CStdString, bool> values;
+  for (unsigned int i = 0; i < conditions.size(); i++)
+  {
+    if (!values.insert(conditions[i]).second)
+      continue;
+    Condition condition = { writer.AddString(conditions[i].first), conditions[i].second ? 1u : 0u };
+    writer.m_conditions.push_back(condition);
+  }
+
+  writer.AddNode(root);
+
+  Header header;
+  memcpy(header.magic, "XBWC", 4);
+  header.version = WINDOW_CACHE_VERSION;
+  header.source = writer.AddString(path);
+  header.dependencies = writer.m_dependencies.size();
+  header.conditions = writer.m_conditions.size();
+  header.nodes = writer.m_nodes.size();
+  header.attributes = writer.m_attributes.size();
+  header.strings = writer.m_strings.size();
+  header.reserved = 0;
+  header.size = sizeof(Header) + header.dependencies * sizeof(Dependency) + header.conditions * sizeof(Condition)
+              + header.nodes * sizeof(Node) + header.attributes * sizeof(Attribute) + header.strings;
+
+  string data;
+  data.reserve(header.size);
+  data.append((const char *)&header, sizeof(Header));
+  if (header.dependencies)
+    data.append((const char *)&writer.m_dependencies[0], header.dependencies * sizeof(Dependency));
+  if (header.conditions)
+    data.append((const char *)&writer.m_conditions[0], header.conditions * sizeof(Condition));
+  data.append((const char *)&writer.m_nodes[0], header.nodes * sizeof(Node));
+  if (header.attributes)
+    data.append((const char *)&writer.m_attributes[0], header.attributes * sizeof(Attribute));
+  data.append(writer.m_strings);
+
+  // write under another name so a window being loaded elsewhere never sees half a file
+  CStdString cacheFile = GetCacheFile(path);
+  CStdString tempFile = cacheFile + ".tmp";
+  CDirectory::Create(WINDOW_CACHE_PATH);
+  CFile file;
+  if (!file.OpenForWrite(tempFile, true))
+    return;
+  bool written = file.Write(data.c_str(), data.size()) == (int)data.size();
+  file.Close();
+
+  if (!written || (CFile::Exists(cacheFile, false) && !CFile::Delete(cacheFile)) || !CFile::Rename(tempFile, cacheFile))
+  {
+    CLog::Log(LOGWARNING, "%s - unable to write %s", __FUNCTION__, cacheFile.c_str());
+    CFile::Delete(tempFile);
+  }
+}
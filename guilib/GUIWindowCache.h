@@ -0,0 +1,123 @@
+/*!
+\file GUIWindowCache.h
+\brief
+*/
+
+#ifndef GUILIB_GUIWINDOWCACHE_H
+#define GUILIB_GUIWINDOWCACHE_H
+
+#pragma once
+
+/*
+ *      Copyright (C) 2005-2010 Team XBMC
+ *      http://www.xbmc.org
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, write to
+ *  the Free Software Foundation, 675 Mass Ave, Cambridge, MA 02139, USA.
+ *  http://www.gnu.org/copyleft/gpl.html
+ *
+ */
+
+#include "StdString.h"
+#include <stdint.h>
+#include <string>
+
+class TiXmlDocument;
+class TiXmlNode;
+class TiXmlElement;
+
+/*!
+ \ingroup winman
+ \brief Keeps skin windows with their includes resolved in a compact binary form.
+
+ Parsing a window's XML and expanding its includes is most of the cost of opening a
+ window on slow machines, and windows are loaded again each time they're opened.  The
+ first time a window is loaded the resolved tree is written to special://temp/skincache/,
+ along with the files and include conditions it was built from.  Later loads map that file
+ and build the document straight from it, as long as none of those files have been
+ modified and the conditions still have the same values.
+
+ The file is laid out as offsets into itself, so it needs no fixing up once mapped.
+ */
+class CGUIWindowCache
+{
+public:
+  /*! \brief Build a window from the cache
+   \param path the window's XML file
+   \param doc [out] document to fill with the resolved window
+   \return true if the cache held an up to date copy of the window
+   */
+  static bool Load(const CStdString &path, TiXmlDocument &doc);
+
+  /*! \brief Resolve the includes in a freshly parsed window and cache the result
+   \param path the window's XML file, as passed to Load()
+   \param loadedPath the file the window was actually read from
+   \param doc the parsed window, which has its includes resolved on return
+   */
+  static void Save(const CStdString &path, const CStdString &loadedPath, TiXmlDocument &doc);
+
+private:
+  struct Header
+  {
+    char     magic[4];
+    uint32_t version;
+    uint32_t size;           ///< of the whole file, to spot a truncated one
+    uint32_t source;         ///< string, the window's XML file
+    uint32_t dependencies;   ///< number of Dependency entries
+    uint32_t conditions;     ///< number of Condition entries
+    uint32_t nodes;          ///< number of Node entries
+    uint32_t attributes;     ///< number of Attribute entries
+    uint32_t strings;        ///< size of the string table
+    uint32_t reserved;
+  };
+
+  struct Dependency
+  {
+    uint32_t path;           ///< string
+    uint32_t reserved;
+    int64_t  mtime;
+    int64_t  size;
+  };
+
+  struct Condition
+  {
+    uint32_t condition;      ///< string
+    uint32_t value;
+  };
+
+  enum NODE_TYPE { NODE_ELEMENT = 0, NODE_TEXT, NODE_CDATA };
+
+  struct Node                ///< stored depth first, children follow their parent
+  {
+    uint32_t type;
+    uint32_t value;          ///< string, the tag name or text
+    uint32_t attribute;      ///< index of the first Attribute
+    uint32_t attributes;
+    uint32_t children;
+  };
+
+  struct Attribute
+  {
+    uint32_t name;           ///< string
+    uint32_t value;          ///< string
+  };
+
+  class CWriter;
+
+  static CStdString GetCacheFile(const CStdString &path);
+  static bool Stat(const CStdString &path, int64_t &mtime, int64_t &size);
+  static bool BuildNode(TiXmlNode *parent, const Header &header, const Node *nodes, const Attribute *attributes, const char *strings, uint32_t &node);
+};
+
+#endif
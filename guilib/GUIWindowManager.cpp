@@ -909,6 +909,19 @@ bool CGUIWindowManager::IsWindowTopMost(const CStdString &xmlFile) const
   return false;
 }
 
+uint32_t CGUIWindowManager::GetStateHash() const
+{
+  CSingleLock lock(g_graphicsContext);
+  uint32_t hash = (uint32_t)GetActiveWindow();
+  for (ciDialog it = m_activeDialogs.begin(); it != m_activeDialogs.end(); ++it)
+  {
+    CGUIWindow *window = *it;
+    hash = hash * 31 + (uint32_t)window->GetID();
+    hash = hash * 31 + (window->IsAnimating(ANIM_TYPE_WINDOW_CLOSE) ? 1 : 0);
+  }
+  return hash;
+}
+
 void CGUIWindowManager::ClearWindowHistory()
 {
   while (m_windowHistory.size())
@@ -111,6 +111,11 @@ public:
   bool IsWindowActive(const CStdString &xmlFile, bool ignoreClosing = true) const;
   bool IsWindowVisible(const CStdString &xmlFile) const;
   bool IsWindowTopMost(const CStdString &xmlFile) const;
+
+  /*! \brief Summarise the active window and dialogs, to tell when they change
+   \return a value that changes whenever a window or dialog comes, goes or starts closing
+   */
+  uint32_t GetStateHash() const;
   bool IsOverlayAllowed() const;
   void ShowOverlay(CGUIWindow::OVERLAY_STATE state);
   void GetActiveModelessWindows(std::vector<int> &ids);
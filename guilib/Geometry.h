@@ -120,6 +120,25 @@ public:
     return *this;
   };
 
+  const CRect &Union(const CRect &rect)
+  {
+    if (IsEmpty())
+      *this = rect;
+    else if (!rect.IsEmpty())
+    {
+      if (rect.x1 < x1) x1 = rect.x1;
+      if (rect.y1 < y1) y1 = rect.y1;
+      if (rect.x2 > x2) x2 = rect.x2;
+      if (rect.y2 > y2) y2 = rect.y2;
+    }
+    return *this;
+  };
+
+  bool Intersects(const CRect &rect) const
+  {
+    return x1 < rect.x2 && rect.x1 < x2 && y1 < rect.y2 && rect.y1 < y2;
+  };
+
   inline bool IsEmpty() const XBMC_FORCE_INLINE
   {
     return (x2 - x1) * (y2 - y1) == 0;
@@ -144,6 +163,11 @@ public:
     return false;
   };
 
+  bool operator ==(const CRect &rect) const
+  {
+    return !(*this != rect);
+  };
+
   float x1, y1, x2, y2;
 };
 
@@ -29,6 +29,8 @@
 #include "cores/VideoRenderers/RenderManager.h"
 #include "WindowingFactory.h"
 #include "TextureManager.h"
+#include "GUIFontTTF.h"
+#include "GUITexture.h"
 #include "MouseStat.h"
 #include "GUIWindowManager.h"
 #include "SystemGlobals.h"
@@ -52,6 +54,7 @@ CGraphicContext::CGraphicContext(void)
   m_guiScaleX = m_guiScaleY = 1.0f;
   m_windowResolution = RES_INVALID;
   m_bFullScreenRoot = false;
+  m_hasScissors = false;
 }
 
 CGraphicContext::~CGraphicContext(void)
@@ -100,6 +103,17 @@ bool CGraphicContext::SetClipRegion(float x, float y, float w, float h)
   return true;
 }
 
+CRect CGraphicContext::GetClipRegion() const
+{
+  if (!m_clipRegions.size())
+    return CRect();
+
+  CRect clipRegion(m_clipRegions.top());
+  if (m_origins.size())
+    clipRegion -= m_origins.top();
+  return clipRegion;
+}
+
 void CGraphicContext::RestoreClipRegion()
 {
   if (m_clipRegions.size())
@@ -207,7 +221,10 @@ bool CGraphicContext::SetViewPort(float fx, float fy, float fwidth, float fheigh
   ASSERT(newTop < newBottom);
 
   CRect newviewport((float)newLeft, (float)newTop, (float)newRight, (float)newBottom);
+  FlushBatches();
   g_Windowing.SetViewPort(newviewport);
+  if (m_hasScissors)
+    SetScissors(m_scissors);
 
   m_viewStack.push(oldviewport);
 
@@ -220,13 +237,36 @@ void CGraphicContext::RestoreViewPort()
   if (!m_viewStack.size()) return;
 
   CRect oldviewport = m_viewStack.top();
+  FlushBatches();
   g_Windowing.SetViewPort(oldviewport);
+  if (m_hasScissors)
+    SetScissors(m_scissors);
 
   m_viewStack.pop();
 
   UpdateCameraPosition(m_cameras.top());
 }
 
+void CGraphicContext::SetScissors(const CRect &rect)
+{
+  FlushBatches();
+  m_scissors = rect;
+  m_hasScissors = true;
+
+  // setting the viewport resets the scissor box, so keep it within both
+  CRect viewport;
+  g_Windowing.GetViewPort(viewport);
+  viewport.Intersect(rect);
+  g_Windowing.SetScissors(viewport);
+}
+
+void CGraphicContext::ResetScissors()
+{
+  FlushBatches();
+  m_hasScissors = false;
+  g_Windowing.ResetScissors();
+}
+
 const CRect& CGraphicContext::GetViewWindow() const
 {
   return m_videoRect;
@@ -371,6 +411,9 @@ void CGraphicContext::SetVideoResolution(RESOLUTION res, bool forceUpdate)
 
   SetFullScreenViewWindow(res);
 
+  // the back buffers are new, so nothing drawn before can be kept
+  m_dirtyRegions.Invalidate();
+
   Unlock();
 }
 
@@ -525,11 +568,24 @@ float CGraphicContext::GetPixelRatio(RESOLUTION iRes) const
 
 void CGraphicContext::Clear(color_t color)
 {
+  FlushBatches();
   g_Windowing.ClearBuffers(color);
 }
 
+void CGraphicContext::FlushBatches()
+{
+  CGUIFontTTF::FlushBatch();
+  CGUITexture::FlushBatch();
+}
+
+void CGraphicContext::FlushTextBatch()
+{
+  CGUIFontTTF::FlushBatch();
+}
+
 void CGraphicContext::CaptureStateBlock()
 {
+  FlushBatches();
   g_Windowing.CaptureStateBlock();
 }
 
@@ -675,6 +731,7 @@ void CGraphicContext::RestoreCameraPosition()
 //       to cut down on one setting)
 void CGraphicContext::UpdateCameraPosition(const CPoint &camera)
 {
+  FlushBatches();
   g_Windowing.SetCameraPosition(camera, m_iScreenWidth, m_iScreenHeight);
 }
 
@@ -686,6 +743,28 @@ bool CGraphicContext::RectIsAngled(float x1, float y1, float x2, float y2) const
   return false;
 }
 
+CRect CGraphicContext::ScaleFinalRect(const CRect &rect) const
+{
+  float x[4], y[4];
+  x[0] = x[3] = rect.x1;
+  x[1] = x[2] = rect.x2;
+  y[0] = y[1] = rect.y1;
+  y[2] = y[3] = rect.y2;
+  CRect result;
+  for (int i = 0; i < 4; i++)
+  {
+    float z = 0;
+    ScaleFinalCoords(x[i], y[i], z);
+    if (i == 0)
+      result = CRect(x[i], y[i], x[i], y[i]);
+    if (x[i] < result.x1) result.x1 = x[i];
+    if (x[i] > result.x2) result.x2 = x[i];
+    if (y[i] < result.y1) result.y1 = y[i];
+    if (y[i] > result.y2) result.y2 = y[i];
+  }
+  return result;
+}
+
 float CGraphicContext::GetFPS() const
 {
   if (m_Resolution != RES_INVALID)
@@ -757,16 +836,19 @@ void CGraphicContext::SetMediaDir(const CStdString &strMediaDir)
 
 void CGraphicContext::Flip()
 {
+  FlushBatches();
   g_Windowing.PresentRender();
 }
 
 void CGraphicContext::ApplyHardwareTransform()
 {
+  FlushBatches();
   g_Windowing.ApplyHardwareTransform(m_finalTransform);
 }
 
 void CGraphicContext::RestoreHardwareTransform()
 {
+  FlushBatches();
   g_Windowing.RestoreHardwareTransform();
 }
 
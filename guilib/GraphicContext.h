@@ -46,6 +46,7 @@
 #include "gui3d.h"
 #include "StdString.h"
 #include "Resolution.h"
+#include "DirtyRegionTracker.h"
 
 enum VIEW_TYPE { VIEW_TYPE_NONE = 0,
                  VIEW_TYPE_LIST,
@@ -79,6 +80,14 @@ public:
   bool IsWidescreen() const { return m_bWidescreen; }
   bool SetViewPort(float fx, float fy , float fwidth, float fheight, bool intersectPrevious = false);
   void RestoreViewPort();
+
+  /*! \brief Restrict all drawing, including clears, to part of the screen
+   The scissor region is in screen coordinates and survives viewport changes, which only
+   ever draw inside of it.  Used to draw just the dirty regions of a frame.
+   \sa ResetScissors, GetDirtyRegions
+   */
+  void SetScissors(const CRect &rect);
+  void ResetScissors();
   const CRect& GetViewWindow() const;
   void SetViewWindow(float left, float top, float right, float bottom);
   bool IsFullScreenRoot() const;
@@ -103,6 +112,18 @@ public:
   void CaptureStateBlock();
   void ApplyStateBlock();
   void Clear(color_t color = 0);
+
+  /*! \brief Draw anything batched up so far
+   Text, and textures drawn one after another from the same texture, are held back so that
+   runs of them go out in one draw call.  Anything that draws other than through a GUI
+   texture or font, or changes render state, must call this first.
+   */
+  void FlushBatches();
+
+  /*! \brief Draw any text batched up so far, leaving textures batched
+   \sa FlushBatches
+   */
+  void FlushTextBatch();
   void GetAllowedResolutions(std::vector<RESOLUTION> &res);
 
   // output scaling
@@ -115,7 +136,9 @@ public:
   inline float ScaleFinalYCoord(float x, float y) const XBMC_FORCE_INLINE { return m_finalTransform.TransformYCoord(x, y, 0); }
   inline float ScaleFinalZCoord(float x, float y) const XBMC_FORCE_INLINE { return m_finalTransform.TransformZCoord(x, y, 0); }
   inline void ScaleFinalCoords(float &x, float &y, float &z) const XBMC_FORCE_INLINE { m_finalTransform.TransformPosition(x, y, z); }
+  const TransformMatrix &GetFinalTransform() const { return m_finalTransform; };
   bool RectIsAngled(float x1, float y1, float x2, float y2) const;
+  CRect ScaleFinalRect(const CRect &rect) const; ///< screen bounding box of a rect in GUI coordinates
 
   inline float GetGUIScaleX() const XBMC_FORCE_INLINE { return m_guiScaleX; }
   inline float GetGUIScaleY() const XBMC_FORCE_INLINE { return m_guiScaleY; }
@@ -162,6 +185,12 @@ public:
     \sa SetClipRegion
     */
   void RestoreClipRegion();
+
+  /*! \brief The clip region that applies to what's drawn at the current origin
+   \return the clip region, or an empty rect if nothing is clipped
+   \sa SetClipRegion
+   */
+  CRect GetClipRegion() const;
   void ApplyHardwareTransform();
   void RestoreHardwareTransform();
   void ClipRect(CRect &vertex, CRect &texture, CRect *diffuse = NULL);
@@ -193,6 +222,8 @@ public:
   }
   void UpdateDisplayBlanking();
 
+  CDirtyRegionTracker &GetDirtyRegions() { return m_dirtyRegions; };
+
 protected:
   void SetFullScreenViewWindow(RESOLUTION &res);
 
@@ -219,6 +250,9 @@ private:
   std::stack<CPoint> m_cameras;
   std::stack<CPoint> m_origins;
   std::stack<CRect>  m_clipRegions;
+  CRect              m_scissors;
+  bool               m_hasScissors;
+  CDirtyRegionTracker m_dirtyRegions;
 
   TransformMatrix m_guiTransform;
   TransformMatrix m_finalTransform;
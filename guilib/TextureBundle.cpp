@@ -87,6 +87,26 @@ bool CTextureBundle::LoadTexture(const CStdString& Filename, CBaseTexture** ppTe
   }
 }
 
+unsigned int CTextureBundle::PreloadTextures(const std::vector<CStdString>& names, std::vector<CBaseTexture*>& textures)
+{
+  // m_useXBT is left to HasFile() on the app thread
+  if (m_useXPR)
+  {
+    textures.assign(names.size(), NULL);
+    return 0;
+  }
+  return m_tbXBT.LoadTextures(names, textures);
+}
+
+bool CTextureBundle::GetAtlasRect(const CStdString& name, CStdString& page, int &x, int &y, int &width, int &height)
+{
+  if (m_useXBT)
+  {
+    return m_tbXBT.GetAtlasRect(name, page, x, y, width, height);
+  }
+  return false;
+}
+
 int CTextureBundle::LoadAnim(const CStdString& Filename, CBaseTexture*** ppTextures,
                               int &width, int &height, int& nLoops, int** ppDelays)
 {
@@ -42,6 +42,16 @@ public:
 
   int LoadAnim(const CStdString& Filename, CBaseTexture*** ppTextures, int &width, int &height, int& nLoops, int** ppDelays);
 
+  /*! \brief Decode textures from a thread other than the app thread.
+   Only .xbt bundles support this, textures in an .xpr bundle are left for LoadTexture().
+   \param textures [out] a texture for each name, NULL for those not decoded
+   \return the number of textures decoded */
+  unsigned int PreloadTextures(const std::vector<CStdString>& names, std::vector<CBaseTexture*>& textures);
+
+  /*! \brief Find a texture that's packed into an atlas page, which only .xbt bundles have
+   \sa CTextureBundleXBT::GetAtlasRect */
+  bool GetAtlasRect(const CStdString& name, CStdString& page, int &x, int &y, int &width, int &height);
+
 private:
   CTextureBundleXPR m_tbXPR;
   CTextureBundleXBT m_tbXBT;
@@ -32,6 +32,12 @@
 #include "utils/EndianSwap.h"
 #include "XBTF.h"
 #include "WindowingFactory.h"
+#include "utils/SingleLock.h"
+#include "utils/Event.h"
+#include "utils/JobManager.h"
+#include "utils/CPUInfo.h"
+#include "utils/MappedFile.h"
+#include <algorithm>
 #ifndef _LINUX
 #include "lib/liblzo/LZO1X.H"
 #else
@@ -42,9 +48,108 @@
 #pragma comment(lib,"../../xbmc/lib/liblzo/lzo.lib")
 #endif
 
+// most bundles have a frame or two that aren't worth handing to another thread
+#define MIN_FRAMES_PER_JOB 2
+
+/*! \brief Frames to be decoded together.
+ The frames are claimed one at a time by the thread wanting them and by helper jobs, so
+ the caller only ever waits for frames that are already being decoded, never for a job
+ that hasn't started.  Jobs starting after that find nothing left to do.
+ */
+class CTextureBundleXBT::CFrameBatch
+{
+public:
+  CFrameBatch(CTextureBundleXBT *bundle, unsigned int generation) : m_done(true)
+  {
+    m_bundle = bundle;
+    m_generation = generation;
+    m_next = 0;
+    m_busy = 0;
+    m_decoded = 0;
+  }
+
+  void Add(const CStdString &name, const CXBTFFrame &frame)
+  {
+    Frame entry = { name, frame, NULL };
+    m_frames.push_back(entry);
+  }
+
+  size_t GetCount() const { return m_frames.size(); }
+  const CXBTFFrame &GetFrame(size_t i) const { return m_frames[i].frame; }
+  CBaseTexture *GetTexture(size_t i) const { return m_frames[i].texture; }
+
+  /*! \brief Decode the frames, sharing them with the job workers
+   \return number of frames decoded */
+  unsigned int Decode(const boost::shared_ptr<CFrameBatch> &self)
+  {
+    if (m_frames.empty())
+      return 0;
+
+    size_t helpers = std::min(m_frames.size() / MIN_FRAMES_PER_JOB, (size_t)std::max(g_cpuInfo.getCPUCount() - 1, 0));
+    for (size_t i = 0; i < helpers; i++)
+      CJobManager::GetInstance().AddJob(new CFrameJob(self), NULL, CJob::PRIORITY_HIGH);
+
+    while (DecodeNext()) {}
+    m_done.Wait();
+    return m_decoded;
+  }
+
+  bool DecodeNext()
+  {
+    CSingleLock lock(m_section);
+    if (m_next >= m_frames.size())
+      return false;
+    Frame &entry = m_frames[m_next++];
+    m_busy++;
+    m_done.Reset();
+    lock.Leave();
+
+    bool decoded = m_bundle->ConvertFrameToTexture(entry.name, entry.frame, m_generation, &entry.texture);
+
+    lock.Enter();
+    if (decoded)
+      m_decoded++;
+    if (--m_busy == 0 && m_next >= m_frames.size())
+      m_done.Set();
+    return true;
+  }
+
+private:
+  class CFrameJob : public CJob
+  {
+  public:
+    CFrameJob(const boost::shared_ptr<CFrameBatch> &batch) : m_batch(batch) {};
+    virtual const char *GetType() const { return "texturedecode"; };
+    virtual bool DoWork()
+    {
+      while (m_batch->DecodeNext()) {}
+      return true;
+    }
+  private:
+    boost::shared_ptr<CFrameBatch> m_batch;
+  };
+
+  struct Frame
+  {
+    CStdString name;
+    CXBTFFrame frame;
+    CBaseTexture *texture;
+  };
+
+  CTextureBundleXBT *m_bundle;
+  unsigned int m_generation;    // of the bundle the frames were taken from
+  std::vector<Frame> m_frames;
+  CCriticalSection m_section;
+  size_t m_next;
+  unsigned int m_busy;
+  unsigned int m_decoded;
+  CEvent m_done;
+};
+
 CTextureBundleXBT::CTextureBundleXBT(void)
 {
   m_themeBundle = false;
+  m_generation = 0;
 }
 
 CTextureBundleXBT::~CTextureBundleXBT(void)
@@ -102,6 +207,7 @@ bool CTextureBundleXBT::OpenBundle()
 
 bool CTextureBundleXBT::HasFile(const CStdString& Filename)
 {
+  CSingleLock lock(m_section);
   if (!m_XBTFReader.IsOpen() && !OpenBundle())
     return false;
 
@@ -121,6 +227,7 @@ void CTextureBundleXBT::GetTexturesFromPath(const CStdString &path, std::vector<
   if (path.GetLength() > 1 && path[1] == ':')
     return;
 
+  CSingleLock lock(m_section);
   if (!m_XBTFReader.IsOpen() && !OpenBundle())
     return;
 
@@ -142,6 +249,7 @@ bool CTextureBundleXBT::LoadTexture(const CStdString& Filename, CBaseTexture** p
 {
   CStdString name = Normalize(Filename);
 
+  CSingleLock lock(m_section);
   CXBTFFile* file = m_XBTFReader.Find(name);
   if (!file)
     return false;
@@ -149,8 +257,15 @@ bool CTextureBundleXBT::LoadTexture(const CStdString& Filename, CBaseTexture** p
   if (file->GetFrames().size() == 0)
     return false;
 
-  CXBTFFrame& frame = file->GetFrames().at(0);
-  if (!ConvertFrameToTexture(Filename, frame, ppTexture))
+  // the bundle may be reopened while we decode, so work from a copy
+  CXBTFFrame frame = file->GetFrames().at(0);
+  unsigned int generation = m_generation;
+  lock.Leave();
+
+  if (frame.IsAtlased())
+    return false;
+
+  if (!ConvertFrameToTexture(Filename, frame, generation, ppTexture))
   {
     return false;
   }
@@ -166,58 +281,126 @@ int CTextureBundleXBT::LoadAnim(const CStdString& Filename, CBaseTexture*** ppTe
 {
   CStdString name = Normalize(Filename);
 
+  CSingleLock lock(m_section);
   CXBTFFile* file = m_XBTFReader.Find(name);
   if (!file)
     return false;
 
-  if (file->GetFrames().size() == 0)
+  if (file->GetFrames().size() == 0 || file->GetFrames()[0].IsAtlased())
+    return false;
+
+  boost::shared_ptr<CFrameBatch> batch(new CFrameBatch(this, m_generation));
+  std::vector<CXBTFFrame>& frames = file->GetFrames();
+  for (size_t i = 0; i < frames.size(); i++)
+    batch->Add(Filename, frames[i]);
+  int loops = file->GetLoop();
+  lock.Leave();
+
+  if (batch->Decode(batch) < batch->GetCount())
+  {
+    for (size_t i = 0; i < batch->GetCount(); i++)
+      delete batch->GetTexture(i);
     return false;
+  }
 
-  size_t nTextures = file->GetFrames().size();
+  size_t nTextures = batch->GetCount();
   *ppTextures = new CBaseTexture*[nTextures];
   *ppDelays = new int[nTextures];
 
   for (size_t i = 0; i < nTextures; i++)
   {
-    CXBTFFrame& frame = file->GetFrames().at(i);
+    (*ppTextures)[i] = batch->GetTexture(i);
+    (*ppDelays)[i] = batch->GetFrame(i).GetDuration();
+  }
+
+  width = batch->GetFrame(0).GetWidth();
+  height = batch->GetFrame(0).GetHeight();
+  nLoops = loops;
+
+  return nTextures;
+}
+
+unsigned int CTextureBundleXBT::LoadTextures(const std::vector<CStdString>& names, std::vector<CBaseTexture*>& textures)
+{
+  textures.assign(names.size(), NULL);
+
+  CSingleLock lock(m_section);
+  if (!m_XBTFReader.IsOpen() && !OpenBundle())
+    return 0;
 
-    if (!ConvertFrameToTexture(Filename, frame, &((*ppTextures)[i])))
+  boost::shared_ptr<CFrameBatch> batch(new CFrameBatch(this, m_generation));
+  std::vector<size_t> index;
+  for (size_t i = 0; i < names.size(); i++)
+  {
+    CXBTFFile* file = m_XBTFReader.Find(Normalize(names[i]));
+    if (file && file->GetFrames().size() && !file->GetFrames()[0].IsAtlased())
     {
-      return false;
+      batch->Add(names[i], file->GetFrames()[0]);
+      index.push_back(i);
     }
-
-    (*ppDelays)[i] = frame.GetDuration();
   }
+  lock.Leave();
 
-  width = file->GetFrames().at(0).GetWidth();
-  height = file->GetFrames().at(0).GetHeight();
-  nLoops = file->GetLoop();
+  unsigned int loaded = batch->Decode(batch);
+  for (size_t i = 0; i < batch->GetCount(); i++)
+    textures[index[i]] = batch->GetTexture(i);
 
-  return nTextures;
+  return loaded;
 }
 
-bool CTextureBundleXBT::ConvertFrameToTexture(const CStdString& name, CXBTFFrame& frame, CBaseTexture** ppTexture)
+bool CTextureBundleXBT::GetAtlasRect(const CStdString& name, CStdString& page, int &x, int &y, int &width, int &height)
 {
-  // found texture - allocate the necessary buffers
-  squish::u8 *buffer = new squish::u8[(size_t)frame.GetPackedSize()];
-  if (buffer == NULL)
-  {
-    CLog::Log(LOGERROR, "Out of memory loading texture: %s (need %"PRIu64" bytes)", name.c_str(), frame.GetPackedSize());
+  CSingleLock lock(m_section);
+  CXBTFFile* file = m_XBTFReader.Find(Normalize(name));
+  if (!file || file->GetFrames().empty())
     return false;
-  }
 
-  // load the compressed texture
-  if (!m_XBTFReader.Load(frame, buffer))
-  {
-    CLog::Log(LOGERROR, "Error loading texture: %s", name.c_str());
-    delete[] buffer;
+  const CXBTFFrame& frame = file->GetFrames()[0];
+  if (!frame.IsAtlased())
+    return false;
+
+  // the reader has checked the page exists and holds the whole frame
+  page = m_XBTFReader.GetFiles()[frame.GetAtlasFile()].GetPath();
+  x = frame.GetAtlasX();
+  y = frame.GetAtlasY();
+  width = frame.GetWidth();
+  height = frame.GetHeight();
+  return true;
+}
+
+bool CTextureBundleXBT::ConvertFrameToTexture(const CStdString& name, const CXBTFFrame& frame, unsigned int generation, CBaseTexture** ppTexture)
+{
+  // read the frame in place from the mapped bundle if we can, keeping hold of the mapping
+  // in case the bundle is closed while we decompress
+  squish::u8 *buffer = NULL;
+  CSingleLock lock(m_section);
+  if (generation != m_generation)
+  { // the frame's offset and sizes are those of a bundle that has since been closed
+    lock.Leave();
+    CLog::Log(LOGDEBUG, "%s - bundle was reopened, not loading %s", __FUNCTION__, name.c_str());
     return false;
   }
+  boost::shared_ptr<CMappedFile> mapping = m_XBTFReader.GetMapping();
+  const squish::u8 *packed = m_XBTFReader.GetFrameData(frame);
+  if (!packed)
+  {
+    buffer = new squish::u8[(size_t)frame.GetPackedSize()];
+    if (!m_XBTFReader.IsOpen() || !m_XBTFReader.Load(frame, buffer))
+    {
+      lock.Leave();
+      CLog::Log(LOGERROR, "Error loading texture: %s", name.c_str());
+      delete[] buffer;
+      return false;
+    }
+    packed = buffer;
+  }
+  lock.Leave();
 
   // check if it's packed with lzo
+  squish::u8 *unpacked = NULL;
   if (frame.IsPacked())
   { // unpack
-    squish::u8 *unpacked = new squish::u8[(size_t)frame.GetUnpackedSize()];
+    unpacked = new squish::u8[(size_t)frame.GetUnpackedSize()];
     if (unpacked == NULL)
     {
       CLog::Log(LOGERROR, "Out of memory unpacking texture: %s (need %"PRIu64" bytes)", name.c_str(), frame.GetUnpackedSize());
@@ -225,7 +408,7 @@ bool CTextureBundleXBT::ConvertFrameToTexture(const CStdString& name, CXBTFFrame
       return false;
     }
     lzo_uint s = (lzo_uint)frame.GetUnpackedSize();
-    if (lzo1x_decompress(buffer, (lzo_uint)frame.GetPackedSize(), unpacked, &s, NULL) != LZO_E_OK ||
+    if (lzo1x_decompress_safe(packed, (lzo_uint)frame.GetPackedSize(), unpacked, &s, NULL) != LZO_E_OK ||
         s != frame.GetUnpackedSize())
     {
       CLog::Log(LOGERROR, "Error loading texture: %s: Decompression error", name.c_str());
@@ -233,21 +416,22 @@ bool CTextureBundleXBT::ConvertFrameToTexture(const CStdString& name, CXBTFFrame
       delete[] unpacked;
       return false;
     }
-    delete[] buffer;
-    buffer = unpacked;
   }
 
   // create an xbmc texture
   *ppTexture = new CTexture();
-  (*ppTexture)->LoadFromMemory(frame.GetWidth(), frame.GetHeight(), 0, frame.GetFormat(), buffer);
+  (*ppTexture)->LoadFromMemory(frame.GetWidth(), frame.GetHeight(), 0, frame.GetFormat(), unpacked ? unpacked : (unsigned char *)packed);
 
   delete[] buffer;
+  delete[] unpacked;
 
   return true;
 }
 
 void CTextureBundleXBT::Cleanup()
 {
+  CSingleLock lock(m_section);
+  m_generation++;
   if (m_XBTFReader.IsOpen())
   {
     m_XBTFReader.Close();
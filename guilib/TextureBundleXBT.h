@@ -24,6 +24,7 @@
 #include "StdString.h"
 #include <map>
 #include "XBTFReader.h"
+#include "utils/CriticalSection.h"
 
 class CBaseTexture;
 
@@ -45,14 +46,40 @@ public:
   int LoadAnim(const CStdString& Filename, CBaseTexture*** ppTextures,
                 int &width, int &height, int& nLoops, int** ppDelays);
 
+  /*! \brief Load the first frame of several textures, decompressing them in parallel
+   Safe to call from any thread.
+   \param names the textures to load
+   \param textures [out] a texture for each name, NULL for those that couldn't be loaded
+   \return the number of textures loaded
+   */
+  unsigned int LoadTextures(const std::vector<CStdString>& names, std::vector<CBaseTexture*>& textures);
+
+  /*! \brief Find where a texture packed into an atlas lies
+   Atlased textures have no frames of their own, so they aren't loaded by the other Load
+   functions. The page is loaded as a texture in its own right and drawn from in place.
+   \param name the texture to look for
+   \param page [out] name of the atlas page holding it
+   \param x,y [out] position of the texture within the page, in pixels
+   \param width,height [out] size of the texture
+   \return true if the texture is in an atlas
+   */
+  bool GetAtlasRect(const CStdString& name, CStdString& page, int &x, int &y, int &width, int &height);
+
 private:
+  class CFrameBatch;
+
   bool OpenBundle();
-  bool ConvertFrameToTexture(const CStdString& name, CXBTFFrame& frame, CBaseTexture** ppTexture);
+  bool ConvertFrameToTexture(const CStdString& name, const CXBTFFrame& frame, unsigned int generation, CBaseTexture** ppTexture);
 
   time_t m_TimeStamp;
 
   bool m_themeBundle;
   CXBTFReader m_XBTFReader;
+  unsigned int m_generation;  ///< bumped whenever the reader is closed, so frames taken from it can be told apart
+
+  // textures may be decoded from worker threads while the app thread looks up others, so
+  // this guards the reader. Decompressing a frame is done outside of it.
+  CCriticalSection m_section;
 };
 
 
@@ -28,12 +28,12 @@
 #include "utils/log.h"
 #include "utils/log.h"
 #include "addons/Skin.h"
-#ifdef _DEBUG
 #include "utils/TimeUtils.h"
-#endif
 #include "../xbmc/Util.h"
 #include "../xbmc/FileSystem/File.h"
 #include "../xbmc/FileSystem/Directory.h"
+#include "../xbmc/Crc32.h"
+#include "../xbmc/TextureCache.h"
 #include <assert.h>
 
 using namespace std;
@@ -51,6 +51,8 @@ CTextureArray::CTextureArray(int width, int height, int loops,  bool texCoordsAr
   m_orientation = 0;
   m_texWidth = 0;
   m_texHeight = 0;
+  m_atlasX = 0;
+  m_atlasY = 0;
   m_texCoordsArePixels = false;
 }
 
@@ -80,6 +82,8 @@ void CTextureArray::Reset()
   m_orientation = 0;
   m_texWidth = 0;
   m_texHeight = 0;
+  m_atlasX = 0;
+  m_atlasY = 0;
   m_texCoordsArePixels = false;
 }
 
@@ -108,6 +112,8 @@ void CTextureArray::Set(CBaseTexture *texture, int width, int height)
 void CTextureArray::Free()
 {
   CSingleLock lock(g_graphicsContext);
+  // anything still waiting to be drawn may use these
+  g_graphicsContext.FlushBatches();
   for (unsigned int i = 0; i < m_textures.size(); i++)
   {
     delete m_textures[i];
@@ -194,7 +200,15 @@ void CTextureMap::Flush()
 
 void CTextureMap::FreeTexture()
 {
-  m_texture.Free();
+  if (m_atlasPage)
+  { // the page isn't ours to delete, it goes when the last texture in it lets go
+    CSingleLock lock(g_graphicsContext);
+    g_graphicsContext.FlushBatches();
+    m_texture.Reset();
+    m_atlasPage.reset();
+  }
+  else
+    m_texture.Free();
 }
 
 bool CTextureMap::IsEmpty() const
@@ -207,7 +221,19 @@ void CTextureMap::Add(CBaseTexture* texture, int delay)
   m_texture.Add(texture, delay);
 
   if (texture)
-    m_memUsage += sizeof(CTexture) + (texture->GetTextureWidth() * texture->GetTextureHeight() * 4);
+    m_memUsage += sizeof(CTexture) + texture->GetPitch() * texture->GetRows();
+}
+
+void CTextureMap::SetAtlas(const boost::shared_ptr<CBaseTexture> &page, int x, int y)
+{
+  m_atlasPage = page;
+  m_texture.Add(page.get(), 100);
+  m_texture.m_atlasX = x;
+  m_texture.m_atlasY = y;
+
+  // our share of the page
+  if (page && page->GetWidth() && page->GetHeight())
+    m_memUsage += (uint32_t)((uint64_t)page->GetPitch() * page->GetRows() * m_texture.m_width * m_texture.m_height / (page->GetWidth() * page->GetHeight()));
 }
 
 /************************************************************************/
@@ -217,6 +243,10 @@ CGUITextureManager::CGUITextureManager(void)
 {
   // we set the theme bundle to be the first bundle (thus prioritizing it)
   m_TexBundle[0].SetThemeBundle(true);
+  m_unusedBytes = 0;
+  m_preloadGeneration = 0;
+  m_preloadedBytes = 0;
+  m_lookups = 0;
 }
 
 CGUITextureManager::~CGUITextureManager(void)
@@ -228,18 +258,65 @@ const CTextureArray& CGUITextureManager::GetTexture(const CStdString& strTexture
 {
   static CTextureArray emptyTexture;
   //  CLog::Log(LOGINFO, " refcount++ for  GetTexture(%s)\n", strTextureName.c_str());
-  for (int i = 0; i < (int)m_vecTextures.size(); ++i)
+  CSingleLock lock(g_graphicsContext);
+  CTextureMap *pMap = FindTexture(strTextureName);
+  if (pMap)
   {
-    CTextureMap *pMap = m_vecTextures[i];
-    if (pMap->GetName() == strTextureName)
-    {
-      //CLog::Log(LOGDEBUG, "Total memusage %u", GetMemoryUsage());
-      return pMap->GetTexture();
+    if (!pMap->IsInUse())
+    { // wanted again before we got around to freeing it
+      for (UnusedTextures::iterator i = m_unusedTextures.begin(); i != m_unusedTextures.end(); ++i)
+      {
+        if (i->second == pMap)
+        {
+          m_unusedBytes -= pMap->GetMemoryUsage();
+          m_unusedTextures.erase(i);
+          break;
+        }
+      }
     }
+    //CLog::Log(LOGDEBUG, "Total memusage %u", GetMemoryUsage());
+    return pMap->GetTexture();
   }
   return emptyTexture;
 }
 
+unsigned int CGUITextureManager::GetNameHash(const CStdString &textureName)
+{
+  Crc32 crc;
+  crc.Compute(textureName);
+  return crc;
+}
+
+CTextureMap *CGUITextureManager::FindTexture(const CStdString &textureName) const
+{
+  m_lookups++;
+  pair<TextureIndex::const_iterator, TextureIndex::const_iterator> range = m_textures.equal_range(GetNameHash(textureName));
+  for (TextureIndex::const_iterator i = range.first; i != range.second; ++i)
+  {
+    if (i->second->GetName() == textureName)
+      return i->second;
+  }
+  return NULL;
+}
+
+void CGUITextureManager::AddTexture(CTextureMap *pMap)
+{
+  m_textures.insert(make_pair(GetNameHash(pMap->GetName()), pMap));
+}
+
+void CGUITextureManager::RemoveTexture(CTextureMap *pMap)
+{
+  pair<TextureIndex::iterator, TextureIndex::iterator> range = m_textures.equal_range(GetNameHash(pMap->GetName()));
+  for (TextureIndex::iterator i = range.first; i != range.second; ++i)
+  {
+    if (i->second == pMap)
+    {
+      m_textures.erase(i);
+      return;
+    }
+  }
+}
+
 /************************************************************************/
 /*                                                                      */
 /************************************************************************/
@@ -270,14 +347,10 @@ bool CGUITextureManager::HasTexture(const CStdString &textureName, CStdString *p
 
   // Check our loaded and bundled textures - we store in bundles using \\.
   CStdString bundledName = CTextureBundle::Normalize(textureName);
-  for (int i = 0; i < (int)m_vecTextures.size(); ++i)
+  if (FindTexture(textureName))
   {
-    CTextureMap *pMap = m_vecTextures[i];
-    if (pMap->GetName() == textureName)
-    {
-      if (size) *size = 1;
-      return true;
-    }
+    if (size) *size = 1;
+    return true;
   }
 
   for (int i = 0; i < 2; i++)
@@ -389,7 +462,7 @@ int CGUITextureManager::Load(const CStdString& strTextureName, bool checkBundleO
     OutputDebugString(temp);
 #endif
 
-    m_vecTextures.push_back(pMap);
+    AddTexture(pMap);
     return 1;
   } // of if (strPath.Right(4).ToLower()==".gif")
 
@@ -397,7 +470,13 @@ int CGUITextureManager::Load(const CStdString& strTextureName, bool checkBundleO
   int width = 0, height = 0;
   if (bundle >= 0)
   {
-    if (FAILED(m_TexBundle[bundle].LoadTexture(strTextureName, &pTexture, width, height)))
+    CStdString page;
+    int x, y;
+    if (m_TexBundle[bundle].GetAtlasRect(strTextureName, page, x, y, width, height))
+      return LoadFromAtlas(strTextureName, bundle, page, x, y, width, height) ? 1 : 0;
+
+    if (!TakePreloaded(strTextureName, pTexture, width, height) &&
+        FAILED(m_TexBundle[bundle].LoadTexture(strTextureName, &pTexture, width, height)))
     {
       CLog::Log(LOGERROR, "Texture manager unable to load bundled file: %s", strTextureName.c_str());
       return 0;
@@ -406,7 +485,7 @@ int CGUITextureManager::Load(const CStdString& strTextureName, bool checkBundleO
   else
   {
     pTexture = new CTexture();
-    if(!pTexture->LoadFromFile(strPath))
+    if(!pTexture->LoadFromFile(CTextureCache::Get().GetDDSImage(strPath)))
       return 0;
     width = pTexture->GetWidth();
     height = pTexture->GetHeight();
@@ -416,7 +495,7 @@ int CGUITextureManager::Load(const CStdString& strTextureName, bool checkBundleO
 
   CTextureMap* pMap = new CTextureMap(strTextureName, width, height, 0);
   pMap->Add(pTexture, 100);
-  m_vecTextures.push_back(pMap);
+  AddTexture(pMap);
 
 #ifdef _DEBUG_TEXTURES
   int64_t end, freq;
@@ -430,28 +509,138 @@ int CGUITextureManager::Load(const CStdString& strTextureName, bool checkBundleO
   return 1;
 }
 
+bool CGUITextureManager::LoadFromAtlas(const CStdString &textureName, int bundle, const CStdString &page, int x, int y, int width, int height)
+{
+  CStdString pageName;
+  pageName.Format("%i:%s", bundle, page.c_str());
+  boost::shared_ptr<CBaseTexture> texture = m_atlasPages[pageName].lock();
+  if (!texture)
+  {
+    CBaseTexture *pTexture = NULL;
+    int pageWidth = 0, pageHeight = 0;
+    if (!m_TexBundle[bundle].LoadTexture(page, &pTexture, pageWidth, pageHeight) || !pTexture)
+    {
+      CLog::Log(LOGERROR, "Texture manager unable to load atlas page %s for %s", page.c_str(), textureName.c_str());
+      return false;
+    }
+    texture.reset(pTexture);
+    m_atlasPages[pageName] = texture;
+  }
+
+  CTextureMap* pMap = new CTextureMap(textureName, width, height, 0);
+  pMap->SetAtlas(texture, x, y);
+  AddTexture(pMap);
+  return true;
+}
+
+unsigned int CGUITextureManager::Preload(const vector<CStdString> &textureNames)
+{
+  vector<CStdString> names;
+  unsigned int generation;
+  {
+    CSingleLock lock(m_preloadSection);
+    for (unsigned int i = 0; i < textureNames.size(); i++)
+    {
+      if (!CanLoad(textureNames[i]) || CUtil::GetExtension(textureNames[i]).Equals(".gif", false))
+        continue;
+      CStdString bundledName = CTextureBundle::Normalize(textureNames[i]);
+      if (m_preloaded.find(bundledName) == m_preloaded.end())
+        names.push_back(bundledName);
+    }
+    generation = m_preloadGeneration;
+  }
+
+  // same order as HasTexture(), the theme bundle first. Loaded textures aren't checked as that
+  // can only be done from the app thread, so one that's already in use may be decoded again
+  unsigned int decoded = 0;
+  for (int i = 0; i < 2 && names.size(); i++)
+  {
+    vector<CBaseTexture*> textures;
+    m_TexBundle[i].PreloadTextures(names, textures);
+
+    vector<CStdString> missing;
+    CSingleLock lock(m_preloadSection);
+    for (unsigned int j = 0; j < names.size(); j++)
+    {
+      if (!textures[j])
+      {
+        missing.push_back(names[j]);
+        continue;
+      }
+      PreloadedTexture preloaded = { textures[j], (int)textures[j]->GetWidth(), (int)textures[j]->GetHeight(),
+                                     textures[j]->GetPitch() * textures[j]->GetRows() };
+      if (generation != m_preloadGeneration || m_preloadedBytes + preloaded.bytes > PRELOAD_BYTES ||
+          !m_preloaded.insert(make_pair(names[j], preloaded)).second)
+        delete textures[j];
+      else
+      {
+        m_preloadedBytes += preloaded.bytes;
+        decoded++;
+      }
+    }
+    names.swap(missing);
+  }
+  return decoded;
+}
+
+bool CGUITextureManager::TakePreloaded(const CStdString &textureName, CBaseTexture *&texture, int &width, int &height)
+{
+  CSingleLock lock(m_preloadSection);
+  if (m_preloaded.empty())
+    return false;
+
+  map<CStdString, PreloadedTexture>::iterator i = m_preloaded.find(CTextureBundle::Normalize(textureName));
+  if (i == m_preloaded.end())
+    return false;
+
+  texture = i->second.texture;
+  width = i->second.width;
+  height = i->second.height;
+  m_preloadedBytes -= i->second.bytes;
+  m_preloaded.erase(i);
+  return true;
+}
+
+void CGUITextureManager::ClearPreloaded()
+{
+  CSingleLock lock(m_preloadSection);
+  for (map<CStdString, PreloadedTexture>::iterator i = m_preloaded.begin(); i != m_preloaded.end(); ++i)
+    delete i->second.texture;
+  if (m_preloaded.size())
+    CLog::Log(LOGDEBUG, "%s - dropping %u preloaded textures (%u bytes) that weren't used", __FUNCTION__, (unsigned int)m_preloaded.size(), m_preloadedBytes);
+  m_preloaded.clear();
+  m_preloadedBytes = 0;
+  m_preloadGeneration++;
+}
 
 void CGUITextureManager::ReleaseTexture(const CStdString& strTextureName)
 {
   CSingleLock lock(g_graphicsContext);
 
-  ivecTextures i;
-  i = m_vecTextures.begin();
-  while (i != m_vecTextures.end())
+  CTextureMap* pMap = FindTexture(strTextureName);
+  if (pMap)
   {
-    CTextureMap* pMap = *i;
-    if (pMap->GetName() == strTextureName)
+    if (pMap->Release())
     {
-      if (pMap->Release())
-      {
-        //CLog::Log(LOGINFO, "  cleanup:%s", strTextureName.c_str());
-        // add to our textures to free
-        m_unusedTextures.push_back(pMap);
-        i = m_vecTextures.erase(i);
+      //CLog::Log(LOGINFO, "  cleanup:%s", strTextureName.c_str());
+      UnusedTextures::iterator i = m_unusedTextures.begin();
+      while (i != m_unusedTextures.end() && i->second != pMap)
+        ++i;
+
+      if (pMap->IsEmpty())
+      { // nothing worth keeping, so add to our textures to free
+        if (i != m_unusedTextures.end())
+          m_unusedTextures.erase(i);
+        RemoveTexture(pMap);
+        m_freeTextures.push_back(pMap);
+      }
+      else if (i == m_unusedTextures.end())
+      { // keep it around in case it's wanted again soon
+        m_unusedTextures.push_back(make_pair(CTimeUtils::GetFrameTime(), pMap));
+        m_unusedBytes += pMap->GetMemoryUsage();
       }
-      return;
     }
-    ++i;
+    return;
   }
   CLog::Log(LOGWARNING, "%s: Unable to release texture %s", __FUNCTION__, strTextureName.c_str());
 }
@@ -459,24 +648,44 @@ void CGUITextureManager::ReleaseTexture(const CStdString& strTextureName)
 void CGUITextureManager::FreeUnusedTextures()
 {
   CSingleLock lock(g_graphicsContext);
-  for (ivecTextures i = m_unusedTextures.begin(); i != m_unusedTextures.end(); ++i)
+  for (vector<CTextureMap*>::iterator i = m_freeTextures.begin(); i != m_freeTextures.end(); ++i)
     delete *i;
-  m_unusedTextures.clear();
+  m_freeTextures.clear();
+
+  // free the textures that haven't been wanted for a while, or that take us over budget
+  unsigned int now = CTimeUtils::GetFrameTime();
+  while (m_unusedTextures.size())
+  {
+    unsigned int timeUnused = m_unusedTextures.front().first;
+    CTextureMap* pMap = m_unusedTextures.front().second;
+    if (now - timeUnused < UNUSED_TEXTURE_TIME && m_unusedBytes <= UNUSED_TEXTURE_BYTES)
+      break;
+
+    m_unusedBytes -= pMap->GetMemoryUsage();
+    m_unusedTextures.pop_front();
+    RemoveTexture(pMap);
+    delete pMap;
+  }
 }
 
 void CGUITextureManager::Cleanup()
 {
   CSingleLock lock(g_graphicsContext);
 
-  ivecTextures i;
-  i = m_vecTextures.begin();
-  while (i != m_vecTextures.end())
+  for (TextureIndex::iterator i = m_textures.begin(); i != m_textures.end(); ++i)
   {
-    CTextureMap* pMap = *i;
-    CLog::Log(LOGWARNING, "%s: Having to cleanup texture %s", __FUNCTION__, pMap->GetName().c_str());
+    CTextureMap* pMap = i->second;
+    if (pMap->IsInUse())
+      CLog::Log(LOGWARNING, "%s: Having to cleanup texture %s", __FUNCTION__, pMap->GetName().c_str());
     delete pMap;
-    i = m_vecTextures.erase(i);
   }
+  m_textures.clear();
+  m_unusedTextures.clear();
+  m_unusedBytes = 0;
+  FreeUnusedTextures();
+  ClearPreloaded();
+  m_atlasPages.clear();
+
   for (int i = 0; i < 2; i++)
     m_TexBundle[i].Cleanup();
 }
@@ -484,12 +693,12 @@ void CGUITextureManager::Cleanup()
 void CGUITextureManager::Dump() const
 {
   CStdString strLog;
-  strLog.Format("total texturemaps size:%i\n", m_vecTextures.size());
+  strLog.Format("total texturemaps size:%i (%i unused, %i lookups)\n", m_textures.size(), m_unusedTextures.size(), m_lookups);
   OutputDebugString(strLog.c_str());
 
-  for (int i = 0; i < (int)m_vecTextures.size(); ++i)
+  for (TextureIndex::const_iterator i = m_textures.begin(); i != m_textures.end(); ++i)
   {
-    const CTextureMap* pMap = m_vecTextures[i];
+    const CTextureMap* pMap = i->second;
     if (!pMap->IsEmpty())
       pMap->Dump();
   }
@@ -499,16 +708,19 @@ void CGUITextureManager::Flush()
 {
   CSingleLock lock(g_graphicsContext);
 
-  ivecTextures i;
-  i = m_vecTextures.begin();
-  while (i != m_vecTextures.end())
+  // everything that isn't in use is freed here, so there's nothing left to keep around
+  m_unusedTextures.clear();
+  m_unusedBytes = 0;
+
+  TextureIndex::iterator i = m_textures.begin();
+  while (i != m_textures.end())
   {
-    CTextureMap* pMap = *i;
+    CTextureMap* pMap = i->second;
     pMap->Flush();
     if (pMap->IsEmpty() )
     {
       delete pMap;
-      i = m_vecTextures.erase(i);
+      m_textures.erase(i++);
     }
     else
     {
@@ -520,9 +732,9 @@ void CGUITextureManager::Flush()
 unsigned int CGUITextureManager::GetMemoryUsage() const
 {
   unsigned int memUsage = 0;
-  for (int i = 0; i < (int)m_vecTextures.size(); ++i)
+  for (TextureIndex::const_iterator i = m_textures.begin(); i != m_textures.end(); ++i)
   {
-    memUsage += m_vecTextures[i]->GetMemoryUsage();
+    memUsage += i->second->GetMemoryUsage();
   }
   return memUsage;
 }
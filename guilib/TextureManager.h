@@ -27,8 +27,13 @@
 #ifndef GUILIB_TEXTUREMANAGER_H
 #define GUILIB_TEXTUREMANAGER_H
 
+#include <list>
+#include <map>
 #include <vector>
 #include "TextureBundle.h"
+#include "utils/CriticalSection.h"
+#include "boost/shared_ptr.hpp"
+#include "boost/weak_ptr.hpp"
 
 #pragma once
 
@@ -58,6 +63,8 @@ public:
   int m_loops;
   int m_texWidth;
   int m_texHeight;
+  int m_atlasX;      ///< position of the frames within their texture, for those in an atlas page
+  int m_atlasY;
   bool m_texCoordsArePixels;
 };
 
@@ -76,7 +83,14 @@ public:
   virtual ~CTextureMap();
 
   void Add(CBaseTexture* texture, int delay);
+
+  /*! \brief Draw from a block of an atlas page, which is shared with the other textures in it
+   \param page the atlas page, freed along with the last texture using it
+   \param x,y position of the texture within the page
+   */
+  void SetAtlas(const boost::shared_ptr<CBaseTexture> &page, int x, int y);
   bool Release();
+  bool IsInUse() const { return m_referenceCount > 0; }
 
   const CStdString& GetName() const;
   const CTextureArray& GetTexture();
@@ -89,6 +103,7 @@ protected:
 
   CStdString m_textureName;
   CTextureArray m_texture;
+  boost::shared_ptr<CBaseTexture> m_atlasPage;
   unsigned int m_referenceCount;
   uint32_t m_memUsage;
 };
@@ -123,10 +138,66 @@ public:
   void RemoveTexturePath(const CStdString &texturePath); ///< Remove a path from the paths to check when loading media
 
   void FreeUnusedTextures(); ///< Free textures (called from app thread only)
+
+  /*! \brief Decode bundled textures ahead of them being needed
+   Safe to call from any thread. Only the decoded pixels are kept, the next Load() of a
+   texture takes them and the upload to the GPU is left to the render thread as usual.
+   \return the number of textures decoded
+   */
+  unsigned int Preload(const std::vector<CStdString> &textureNames);
+
+  /*! \brief Free textures decoded by Preload() that haven't been loaded
+   Called once the window they were decoded for is up, as anything still left is for
+   controls that aren't shown. Preloads still running are discarded too.
+   */
+  void ClearPreloaded();
+
+  unsigned int GetTextureCount() const { return m_textures.size(); } ///< Loaded textures, including unused ones kept around
+  unsigned int GetUnusedCount() const { return m_unusedTextures.size(); }
+  unsigned int GetLookupCount() const { return m_lookups; }          ///< Name lookups since startup
+
+  static unsigned int GetNameHash(const CStdString &textureName);
 protected:
-  std::vector<CTextureMap*> m_vecTextures;
-  std::vector<CTextureMap*> m_unusedTextures;
-  typedef std::vector<CTextureMap*>::iterator ivecTextures;
+  /*! \brief Find a loaded texture, in use or not
+   */
+  CTextureMap *FindTexture(const CStdString &textureName) const;
+  void AddTexture(CTextureMap *pMap);
+  void RemoveTexture(CTextureMap *pMap);
+  bool TakePreloaded(const CStdString &textureName, CBaseTexture *&texture, int &width, int &height);
+  bool LoadFromAtlas(const CStdString &textureName, int bundle, const CStdString &page, int x, int y, int width, int height);
+
+  // Textures are looked up by a hash of their name, many times per frame
+  typedef std::multimap<unsigned int, CTextureMap*> TextureIndex;
+  TextureIndex m_textures;
+
+  // Released textures are kept for a little while (oldest first) in case they're wanted
+  // again, e.g. when scrolling back through a list, before being freed from the app thread
+  static const unsigned int UNUSED_TEXTURE_TIME = 5000;
+  static const unsigned int UNUSED_TEXTURE_BYTES = 32 * 1024 * 1024;
+  typedef std::list< std::pair<unsigned int, CTextureMap*> > UnusedTextures;
+  UnusedTextures m_unusedTextures;
+  uint32_t m_unusedBytes;
+  std::vector<CTextureMap*> m_freeTextures;
+
+  // Textures decoded by Preload(), which are dropped if the skin is unloaded before they're used.
+  // Once PRELOAD_BYTES are waiting any more are left to be decoded when they're loaded
+  static const unsigned int PRELOAD_BYTES = 64 * 1024 * 1024;
+  struct PreloadedTexture
+  {
+    CBaseTexture *texture;
+    int width;
+    int height;
+    unsigned int bytes;
+  };
+  std::map<CStdString, PreloadedTexture> m_preloaded;
+  unsigned int m_preloadedBytes;
+  unsigned int m_preloadGeneration;
+  CCriticalSection m_preloadSection;
+
+  // Atlas pages in use, by bundle and page name, shared by the textures drawn from them
+  std::map<CStdString, boost::weak_ptr<CBaseTexture> > m_atlasPages;
+
+  mutable unsigned int m_lookups;
   // we have 2 texture bundles (one for the base textures, one for the theme)
   CTextureBundle m_TexBundle[2];
 
@@ -141,6 +141,17 @@ public:
     return *this;
   }
 
+  // comparison operators
+  bool operator ==(const TransformMatrix &right) const
+  {
+    return memcmp(m, right.m, 12*sizeof(float)) == 0 && alpha == right.alpha;
+  }
+
+  bool operator !=(const TransformMatrix &right) const
+  {
+    return !(*this == right);
+  }
+
   // multiplication operators
   const TransformMatrix &operator *=(const TransformMatrix &right)
   {
@@ -29,6 +29,10 @@ CXBTFFrame::CXBTFFrame()
   m_unpackedSize = 0;
   m_offset = 0;
   m_format = XB_FMT_UNKNOWN;
+  m_duration = 0;
+  m_atlasFile = XBTF_NO_ATLAS;
+  m_atlasX = 0;
+  m_atlasY = 0;
 }
 
 uint32_t CXBTFFrame::GetWidth() const
@@ -106,7 +110,34 @@ void CXBTFFrame::SetDuration(uint32_t duration)
   m_duration = duration;
 }
 
-uint64_t CXBTFFrame::GetHeaderSize() const
+void CXBTFFrame::SetAtlas(uint32_t atlasFile, uint32_t x, uint32_t y)
+{
+  m_atlasFile = atlasFile;
+  m_atlasX = x;
+  m_atlasY = y;
+}
+
+uint32_t CXBTFFrame::GetAtlasFile() const
+{
+  return m_atlasFile;
+}
+
+uint32_t CXBTFFrame::GetAtlasX() const
+{
+  return m_atlasX;
+}
+
+uint32_t CXBTFFrame::GetAtlasY() const
+{
+  return m_atlasY;
+}
+
+bool CXBTFFrame::IsAtlased() const
+{
+  return m_atlasFile != XBTF_NO_ATLAS;
+}
+
+uint64_t CXBTFFrame::GetHeaderSize(char version) const
 {
   uint64_t result =
     sizeof(m_width) +
@@ -117,6 +148,14 @@ uint64_t CXBTFFrame::GetHeaderSize() const
     sizeof(m_offset) +
     sizeof(m_duration);
 
+  if (version >= '3')
+  {
+    result +=
+      sizeof(m_atlasFile) +
+      sizeof(m_atlasX) +
+      sizeof(m_atlasY);
+  }
+
   return result;
 }
 
@@ -159,7 +198,7 @@ std::vector<CXBTFFrame>& CXBTFFile::GetFrames()
   return m_frames;
 }
 
-uint64_t CXBTFFile::GetHeaderSize() const
+uint64_t CXBTFFile::GetHeaderSize(char version) const
 {
   uint64_t result =
     sizeof(m_path) +
@@ -168,7 +207,7 @@ uint64_t CXBTFFile::GetHeaderSize() const
 
   for (size_t i = 0; i < m_frames.size(); i++)
   {
-    result += m_frames[i].GetHeaderSize();
+    result += m_frames[i].GetHeaderSize(version);
   }
 
   return result;
@@ -176,6 +215,7 @@ uint64_t CXBTFFile::GetHeaderSize() const
 
 CXBTF::CXBTF()
 {
+  m_version = XBTF_VERSION[0];
 }
 
 uint64_t CXBTF::GetHeaderSize() const
@@ -187,7 +227,7 @@ uint64_t CXBTF::GetHeaderSize() const
 
   for (size_t i = 0; i < m_files.size(); i++)
   {
-    result += m_files[i].GetHeaderSize();
+    result += m_files[i].GetHeaderSize(m_version);
   }
 
   return result;
@@ -197,3 +237,13 @@ std::vector<CXBTFFile>& CXBTF::GetFiles()
 {
   return m_files;
 }
+
+char CXBTF::GetVersion() const
+{
+  return m_version;
+}
+
+void CXBTF::SetVersion(char version)
+{
+  m_version = version;
+}
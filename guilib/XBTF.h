@@ -26,7 +26,10 @@
 #include <stdint.h>
 
 #define XBTF_MAGIC "XBTF"
-#define XBTF_VERSION "2"
+#define XBTF_VERSION "3"
+
+// frames that aren't part of an atlas page
+#define XBTF_NO_ATLAS 0xffffffff
 
 #define XB_FMT_DXT_MASK   15
 #define XB_FMT_UNKNOWN     0
@@ -53,11 +56,21 @@ public:
   void SetPackedSize(uint64_t size);
   uint64_t GetOffset() const;
   void SetOffset(uint64_t offset);
-  uint64_t GetHeaderSize() const;
+  uint64_t GetHeaderSize(char version) const;
   uint32_t GetDuration() const;
   void SetDuration(uint32_t duration);
   bool IsPacked() const;
 
+  /*! \brief Small images may be packed into a larger atlas page rather than stored on their own.
+   Such frames have no content of their own, they're the width x height block at x,y in the
+   first frame of the file at index atlasFile.
+   */
+  void SetAtlas(uint32_t atlasFile, uint32_t x, uint32_t y);
+  uint32_t GetAtlasFile() const;
+  uint32_t GetAtlasX() const;
+  uint32_t GetAtlasY() const;
+  bool IsAtlased() const;
+
 private:
   uint32_t m_width;
   uint32_t m_height;
@@ -66,6 +79,9 @@ private:
   uint64_t m_unpackedSize;
   uint64_t m_offset;
   uint32_t m_duration;
+  uint32_t m_atlasFile;
+  uint32_t m_atlasX;
+  uint32_t m_atlasY;
 };
 
 class CXBTFFile
@@ -78,7 +94,7 @@ public:
   uint32_t GetLoop() const;
   void SetLoop(uint32_t loop);
   std::vector<CXBTFFrame>& GetFrames();
-  uint64_t GetHeaderSize() const;
+  uint64_t GetHeaderSize(char version) const;
 
 private:
   char         m_path[256];
@@ -92,9 +108,12 @@ public:
   CXBTF();
   uint64_t GetHeaderSize() const;
   std::vector<CXBTFFile>& GetFiles();
+  char GetVersion() const;
+  void SetVersion(char version);
 
 private:
   std::vector<CXBTFFile> m_files;
+  char m_version;
 };
 
 #endif
@@ -23,6 +23,7 @@
 #include "XBTFReader.h"
 #include "EndianSwap.h"
 #include "CharsetConverter.h"
+#include "MappedFile.h"
 #ifdef _WIN32
 #include "FileSystem/SpecialProtocol.h"
 #include "PlatformDefs.h" //for PRIdS, PRId64
@@ -79,10 +80,12 @@ bool CXBTFReader::Open(const CStdString& fileName)
   char version[1];
   READ_STR(version, 1, m_file);
 
-  if (strncmp(version, XBTF_VERSION, sizeof(version)) != 0)
+  // version 2 bundles are the same, less the atlas fields
+  if (version[0] < '2' || version[0] > XBTF_VERSION[0])
   {
     return false;
   }
+  m_xbtf.SetVersion(version[0]);
 
   unsigned int nofFiles;
   READ_U32(nofFiles, m_file);
@@ -118,6 +121,15 @@ bool CXBTFReader::Open(const CStdString& fileName)
       READ_U64(u64, m_file);
       frame.SetOffset(u64);
 
+      if (version[0] >= '3')
+      {
+        unsigned int atlasFile, atlasX, atlasY;
+        READ_U32(atlasFile, m_file);
+        READ_U32(atlasX, m_file);
+        READ_U32(atlasY, m_file);
+        frame.SetAtlas(atlasFile, atlasX, atlasY);
+      }
+
       file.GetFrames().push_back(frame);
     }
 
@@ -134,6 +146,33 @@ bool CXBTFReader::Open(const CStdString& fileName)
     return false;
   }
 
+  // an atlased frame must lie within a page that is stored on its own
+  std::vector<CXBTFFile>& files = m_xbtf.GetFiles();
+  for (size_t i = 0; i < files.size(); i++)
+  {
+    std::vector<CXBTFFrame>& frames = files[i].GetFrames();
+    for (size_t j = 0; j < frames.size(); j++)
+    {
+      const CXBTFFrame& frame = frames[j];
+      if (!frame.IsAtlased())
+        continue;
+
+      if (frame.GetAtlasFile() >= files.size() || files[frame.GetAtlasFile()].GetFrames().empty())
+        return false;
+
+      const CXBTFFrame& page = files[frame.GetAtlasFile()].GetFrames()[0];
+      if (page.IsAtlased() ||
+          (uint64_t)frame.GetAtlasX() + frame.GetWidth() > page.GetWidth() ||
+          (uint64_t)frame.GetAtlasY() + frame.GetHeight() > page.GetHeight())
+        return false;
+    }
+  }
+
+  // frames are read from a mapping where we can get one, and from m_file where we can't
+  m_mapping.reset(new CMappedFile);
+  if (!m_mapping->Open(m_fileName))
+    m_mapping.reset();
+
   return true;
 }
 
@@ -144,6 +183,7 @@ void CXBTFReader::Close()
     fclose(m_file);
     m_file = NULL;
   }
+  m_mapping.reset();
 
   m_xbtf.GetFiles().clear();
   m_filesMap.clear();
@@ -181,12 +221,36 @@ CXBTFFile* CXBTFReader::Find(const CStdString& name)
   return &(iter->second);
 }
 
+const unsigned char* CXBTFReader::GetFrameData(const CXBTFFrame& frame) const
+{
+  if (!m_mapping)
+  {
+    return NULL;
+  }
+
+  uint64_t size = m_mapping->GetSize();
+  if (frame.GetOffset() > size || frame.GetPackedSize() > size - frame.GetOffset())
+  {
+    return NULL;
+  }
+
+  return m_mapping->GetData() + frame.GetOffset();
+}
+
 bool CXBTFReader::Load(const CXBTFFrame& frame, unsigned char* buffer)
 {
   if (!m_file)
   {
     return false;
   }
+
+  const unsigned char* data = GetFrameData(frame);
+  if (data)
+  {
+    memcpy(buffer, data, (size_t)frame.GetPackedSize());
+    return true;
+  }
+
 #if defined(__APPLE__)
     if (fseeko(m_file, (off_t)frame.GetOffset(), SEEK_SET) == -1)
 #else
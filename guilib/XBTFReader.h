@@ -26,6 +26,9 @@
 #include <map>
 #include "StdString.h"
 #include "XBTF.h"
+#include "boost/shared_ptr.hpp"
+
+class CMappedFile;
 
 class CXBTFReader
 {
@@ -40,11 +43,22 @@ public:
   bool Load(const CXBTFFrame& frame, unsigned char* buffer);
   std::vector<CXBTFFile>&  GetFiles();
 
+  /*! \brief The packed data of a frame, read in place from the mapped bundle
+   \return NULL if the bundle isn't mapped or the frame lies outside of it.  The data stays
+   valid for as long as the mapping from GetMapping() is held.
+   */
+  const unsigned char* GetFrameData(const CXBTFFrame& frame) const;
+
+  /*! \brief The bundle mapped into memory, which outlives Close() for whoever holds it
+   */
+  boost::shared_ptr<CMappedFile> GetMapping() const { return m_mapping; }
+
 private:
   CXBTF      m_xbtf;
   CStdString m_fileName;
   FILE*      m_file;
   std::map<CStdString, CXBTFFile> m_filesMap;
+  boost::shared_ptr<CMappedFile> m_mapping;
 };
 
 #endif
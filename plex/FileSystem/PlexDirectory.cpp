@@ -34,6 +34,8 @@
 #include "Picture.h"
 #include "PlexLibrarySectionManager.h"
 #include "PlexServerManager.h"
+#include "PlexDirectoryCache.h"
+#include "Application.h"
 
 using namespace std;
 using namespace XFILE;
@@ -53,6 +55,16 @@ CPlexDirectory::CPlexDirectory(bool parseResults, bool displayDialog)
 , m_bParseResults(parseResults)
 , m_bReplaceLocalhost(true)
 , m_dirCacheType(DIR_CACHE_ALWAYS)
+, m_containerStart(0)
+, m_containerSize(0)
+, m_parser(this)
+, m_items(0)
+, m_bLocalServer(false)
+, m_bGotType(false)
+, m_lastMediaNode(0)
+, m_bReadDiskCache(true)
+, m_bWritingDiskCache(false)
+, m_bServedFromDisk(false)
 {
   m_timeout = 300;
   
@@ -67,6 +79,16 @@ CPlexDirectory::CPlexDirectory(bool parseResults, bool displayDialog, bool repla
   , m_bParseResults(parseResults)
   , m_bReplaceLocalhost(replaceLocalhost)
   , m_dirCacheType(DIR_CACHE_ALWAYS)
+  , m_containerStart(0)
+  , m_containerSize(0)
+  , m_parser(this)
+  , m_items(0)
+  , m_bLocalServer(false)
+  , m_bGotType(false)
+  , m_lastMediaNode(0)
+  , m_bReadDiskCache(true)
+  , m_bWritingDiskCache(false)
+  , m_bServedFromDisk(false)
 {
   m_timeout = 300;
 
@@ -77,12 +99,14 @@ CPlexDirectory::CPlexDirectory(bool parseResults, bool displayDialog, bool repla
 ///////////////////////////////////////////////////////////////////////////////////////////////////
 CPlexDirectory::~CPlexDirectory()
 {
+  delete m_lastMediaNode;
 }
 
 ///////////////////////////////////////////////////////////////////////////////////////////////////
 bool CPlexDirectory::GetDirectory(const CStdString& path, CFileItemList &items)
 {
   CStdString strPath = path;
+  m_path = path;
   
   // Hackish, but a few special directories.
   if (strPath == "plex://shared")
@@ -147,74 +171,115 @@ bool CPlexDirectory::ReallyGetDirectory(const CStdString& strPath, CFileItemList
 
   strRoot.Replace(" ", "%20");
 
-  // Start the download thread running.
+  // The caller may only want the first page of a big container.
+  if (m_containerSize == 0 && items.m_pageSize > 0)
+  {
+    m_containerStart = 0;
+    m_containerSize = items.m_pageSize;
+  }
+  
   CLog::Log(LOGNOTICE, "PlexDirectory::GetDirectory(%s)", strRoot.c_str());
   m_url = strRoot;
-  CThread::Create(false, 0);
+  m_items = &items;
+  
+  // Plain listings get a copy kept on disk, keyed by the real URL and range.
+  m_diskCacheKey.clear();
+  m_bServedFromDisk = false;
+  if (m_bParseResults && m_body.empty() && m_dirCacheType == DIR_CACHE_ALWAYS)
+  {
+    m_diskCacheKey = strRoot;
+    if (m_containerSize > 0)
+      m_diskCacheKey.AppendFormat(";%d,%d", m_containerStart, m_containerSize);
+  }
+  
+  // The first time round after starting up, answer from the last run's copy.
+  if (m_diskCacheKey.empty() == false && m_bReadDiskCache && CPlexDirectoryCache::Get().IsCold(m_diskCacheKey))
+    m_bServedFromDisk = LoadDiskCache();
+  
+  if (m_bServedFromDisk)
+  {
+    dprintf("Plex Directory: Served %s from disk cache", m_url.c_str());
+  }
+  else if (m_allowPrompting == false || g_application.IsCurrentThread() == false)
+  {
+    // Already on a worker (job, content request, CGetDirectory), nobody to keep
+    // responsive, so make the request right here rather than on yet another thread.
+    //
+    Process();
+  }
+  else
+  {
+    // Start the download thread running.
+    CThread::Create(false, 0);
 
-  // Now display progress, look for cancel.
-  CGUIDialogProgress* dlgProgress = 0;
+    // Now display progress, look for cancel.
+    CGUIDialogProgress* dlgProgress = 0;
 
-  int time = CTimeUtils::GetTimeMS();
+    int time = CTimeUtils::GetTimeMS();
 
-  while (m_downloadEvent.WaitMSec(100) == false)
-  {
-    // If enough time has passed, display the dialog.
-    if (CTimeUtils::GetTimeMS() - time > 1000 && m_allowPrompting == true)
+    while (m_downloadEvent.WaitMSec(100) == false)
     {
-      dlgProgress = (CGUIDialogProgress*)g_windowManager.GetWindow(WINDOW_DIALOG_PROGRESS);
-      if (dlgProgress)
+      // If enough time has passed, display the dialog.
+      if (CTimeUtils::GetTimeMS() - time > 1000 && m_allowPrompting == true)
       {
-        dlgProgress->ShowProgressBar(false);
-        dlgProgress->SetHeading(40203);
-        dlgProgress->SetLine(0, 40204);
-        dlgProgress->SetLine(1, "");
-        dlgProgress->SetLine(2, "");
-        dlgProgress->StartModal();
+        dlgProgress = (CGUIDialogProgress*)g_windowManager.GetWindow(WINDOW_DIALOG_PROGRESS);
+        if (dlgProgress)
+        {
+          dlgProgress->ShowProgressBar(false);
+          dlgProgress->SetHeading(40203);
+          dlgProgress->SetLine(0, 40204);
+          dlgProgress->SetLine(1, "");
+          dlgProgress->SetLine(2, "");
+          dlgProgress->StartModal();
+        }
       }
-    }
 
-    if (dlgProgress)
-    {
-      dlgProgress->Progress();
-      if (dlgProgress->IsCanceled())
+      if (dlgProgress)
       {
-        items.m_wasListingCancelled = true;
-        m_http.Cancel();
-        StopThread();
+        dlgProgress->Progress();
+        if (dlgProgress->IsCanceled())
+        {
+          items.m_wasListingCancelled = true;
+          m_http.Cancel();
+          StopThread();
+        }
       }
     }
-  }
 
-  if (dlgProgress)
-    dlgProgress->Close();
+    if (dlgProgress)
+      dlgProgress->Close();
 
-  // Wait for the thread to exit.
-  WaitForThreadExit(INFINITE);
-  StopThread();
+    // Wait for the thread to exit.
+    WaitForThreadExit(INFINITE);
+    StopThread();
+  }
 
   // See if we suceeded.
   if (m_bSuccess == false)
+  {
+    FinishDiskCache(false);
+    
+    // Don't hand back half a listing.
+    if (m_bParseResults)
+      items.Clear();
+    
     return false;
+  }
 
   // See if we're supposed to parse the results or not.
   if (m_bParseResults == false)
     return true;
 
-  // Parse returned xml.
-  TiXmlDocument doc;
-  doc.Parse(m_data.c_str());
-
-  TiXmlElement* root = doc.RootElement();
+  // The items were already built on the download thread, as the XML streamed in.
+  TiXmlElement* root = m_parser.GetRoot();
   if (root == 0)
   {
-    CLog::Log(LOGERROR, "%s - Unable to parse XML\n%s", __FUNCTION__, m_data.c_str());
+    FinishDiskCache(false);
+    CLog::Log(LOGERROR, "%s - Unable to parse XML from %s", __FUNCTION__, m_url.c_str());
     return false;
   }
 
-  // Is the server local?
-  CURL url(m_url);
-  bool localServer = Cocoa_IsHostLocal(url.GetHostName());
+  bool localServer = m_bLocalServer;
   
   // Save some properties.
   if (root->Attribute("updatedAt"))
@@ -226,6 +291,16 @@ bool CPlexDirectory::ReallyGetDirectory(const CStdString& strPath, CFileItemList
   if (root->Attribute("machineIdentifier"))
     items.SetProperty("machineIdentifier", root->Attribute("machineIdentifier"));
 
+  // Paged container? Remember how far we got, and don't cache a partial listing.
+  items.m_pageEnd = m_containerStart + m_parser.GetElementCount();
+  items.m_totalSize = 0;
+  if (m_containerSize > 0 && root->Attribute("totalSize"))
+  {
+    items.m_totalSize = boost::lexical_cast<int>(root->Attribute("totalSize"));
+    if (items.HasMorePages())
+      items.SetCacheToDisc(CFileItemList::CACHE_NEVER);
+  }
+
   // Get the fanart.
   const char* fanart = root->Attribute("art");
   string strFanart;
@@ -252,7 +327,7 @@ bool CPlexDirectory::ReallyGetDirectory(const CStdString& strPath, CFileItemList
   string strDirLabel = "%B";
   string strSecondDirLabel = "%Y";
 
-  Parse(m_url, root, items, strFileLabel, strSecondFileLabel, strDirLabel, strSecondDirLabel, localServer);
+  ComputeLabels(m_parseURL, strFileLabel, strSecondFileLabel, strDirLabel, strSecondDirLabel);
 
   // Check if any restrictions should be applied
   bool disableFanart = false;
@@ -294,6 +369,28 @@ bool CPlexDirectory::ReallyGetDirectory(const CStdString& strPath, CFileItemList
   if (pluginIdentifier)
     items.SetProperty("identifier", pluginIdentifier);
 
+  // The same strings go on every item, so share one copy of each between them.
+  CGUIListItem::PropertyValue containerKeyValue = CGUIListItem::MakePropertyValue(strPath);
+  CGUIListItem::PropertyValue httpCookiesValue, userAgentValue, communityRatingColorValue, pluginIdentifierValue, fanartFallbackValue;
+  if (httpCookies)
+    httpCookiesValue = CGUIListItem::MakePropertyValue(httpCookies);
+  if (userAgent)
+    userAgentValue = CGUIListItem::MakePropertyValue(userAgent);
+  if (communityRatingColor)
+    communityRatingColorValue = CGUIListItem::MakePropertyValue(communityRatingColor);
+  if (pluginIdentifier)
+    pluginIdentifierValue = CGUIListItem::MakePropertyValue(pluginIdentifier);
+
+  // Save the fallback fanart in case we need it while loading the real one, but only if
+  // we have it cached already.
+  //
+  if (strFanart.size() > 0)
+  {
+    CStdString cachedFanart = CFileItem::GetCachedPlexMediaServerFanart(strFanart);
+    if (CFile::Exists(cachedFanart))
+      fanartFallbackValue = CGUIListItem::MakePropertyValue(cachedFanart);
+  }
+
   // Set fanart on items if they don't have their own, or if individual item fanart
   // is disabled. Also set HTTP & rating info
   //
@@ -303,7 +400,7 @@ bool CPlexDirectory::ReallyGetDirectory(const CStdString& strPath, CFileItemList
     CFileItemPtr pItem = items[i];
 
     // Save the container URL.
-    pItem->SetProperty("containerKey", strPath);
+    pItem->SetProperty("containerKey", containerKeyValue);
     
     // See if this is a provider.
     if (pItem->GetProperty("provider") == "1")
@@ -323,13 +420,8 @@ bool CPlexDirectory::ReallyGetDirectory(const CStdString& strPath, CFileItemList
         pItem->SetProperty("fanart_fallback", "1");
     }
 
-    // Save the fallback fanart in case we need it while loading the real one.
-    if (strFanart.size() > 0)
-    {
-      // Only do this if we have it cached already.
-      if (CFile::Exists(CFileItem::GetCachedPlexMediaServerFanart(strFanart)))
-        pItem->SetProperty("fanart_image_fallback", CFileItem::GetCachedPlexMediaServerFanart(strFanart));
-    }
+    if (fanartFallbackValue)
+      pItem->SetProperty("fanart_image_fallback", fanartFallbackValue);
 
     // Fall back to directory thumb?
     if (strThumb.size() > 0 && pItem->GetThumbnailImage().size() == 0)
@@ -342,17 +434,17 @@ bool CPlexDirectory::ReallyGetDirectory(const CStdString& strPath, CFileItemList
 
     // See if there's a cookie property to set.
     if (httpCookies)
-      pItem->SetProperty("httpCookies", httpCookies);
+      pItem->SetProperty("httpCookies", httpCookiesValue);
 
     if (userAgent)
-      pItem->SetProperty("userAgent", userAgent);
+      pItem->SetProperty("userAgent", userAgentValue);
 
     if (communityRatingColor)
-      pItem->SetProperty("communityRatingColor", communityRatingColor);
+      pItem->SetProperty("communityRatingColor", communityRatingColorValue);
 
     if (pluginIdentifier)
     {
-      pItem->SetProperty("pluginIdentifier", pluginIdentifier);
+      pItem->SetProperty("pluginIdentifier", pluginIdentifierValue);
       
       CStdString identifier(pluginIdentifier);
       if (identifier == "com.plexapp.plugins.library")
@@ -470,6 +562,26 @@ bool CPlexDirectory::ReallyGetDirectory(const CStdString& strPath, CFileItemList
     m_dirCacheType = DIR_CACHE_NEVER;
   }
 
+  // Remember which version of the listing this is.
+  const char* machineIdentifier = root->Attribute("machineIdentifier");
+  const char* updatedAt = root->Attribute("updatedAt");
+  m_validator = machineIdentifier ? machineIdentifier : "";
+  if (updatedAt)
+    m_validator += string("@") + updatedAt;
+  else
+    m_validator += "#" + boost::lexical_cast<string>((uint32_t)m_crc);
+  
+  // Keep the response for the next cold start, if it's something we'd cache at all.
+  FinishDiskCache(m_dirCacheType == DIR_CACHE_ALWAYS);
+  
+  // What we served from disk might be stale, so check with the server behind the scenes.
+  if (m_bServedFromDisk)
+    CPlexDirectoryCache::Get().Revalidate(m_path, m_url, m_containerStart, m_containerSize, m_validator);
+  
+  // A partial listing mustn't end up in the memory cache.
+  if (items.HasMorePages())
+    m_dirCacheType = DIR_CACHE_NEVER;
+
   return true;
 }
 
@@ -1711,73 +1823,89 @@ PlexMediaNode* PlexMediaNode::Create(TiXmlElement* element)
 ///////////////////////////////////////////////////////////////////////////////////////////////////
 void CPlexDirectory::Parse(const CURL& url, TiXmlElement* root, CFileItemList &items, string& strFileLabel, string& strSecondFileLabel, string& strDirLabel, string& strSecondDirLabel, bool isLocal)
 {
-  PlexMediaNode* mediaNode = 0;
-
-  bool gotType = false;
+  m_bGotType = false;
   for (TiXmlElement* element = root->FirstChildElement(); element; element=element->NextSiblingElement())
+    ParseElement(url, element, items, isLocal);
+
+  ComputeLabels(url, strFileLabel, strSecondFileLabel, strDirLabel, strSecondDirLabel);
+}
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+void CPlexDirectory::ParseElement(const CURL& url, TiXmlElement* element, CFileItemList &items, bool isLocal)
+{
+  PlexMediaNode* mediaNode = PlexMediaNode::Create(element);
+  if (mediaNode != 0)
   {
-    mediaNode = PlexMediaNode::Create(element);
-    if (mediaNode != 0)
-    {
-      // Get the type.
-      const char* pType = element->Attribute("type");
-      string type;
+    // Get the type.
+    const char* pType = element->Attribute("type");
+    string type;
 
-      if (pType)
+    if (pType)
+    {
+      type = pType;
+
+      if (type == "show")
+        type = "tvshows";
+      else if (type == "season")
+        type = "seasons";
+      else if (type == "episode")
+        type = "episodes";
+      else if (type == "movie")
+        type = "movies";
+      else if (type == "artist")
+        type = "artists";
+      else if (type == "album")
+        type = "albums";
+      else if (type == "track")
+        type = "songs";
+
+      // Set the content type for the collection.
+      if (m_bGotType == false)
       {
-        type = pType;
-
-        if (type == "show")
-          type = "tvshows";
-        else if (type == "season")
-          type = "seasons";
-        else if (type == "episode")
-          type = "episodes";
-        else if (type == "movie")
-          type = "movies";
-        else if (type == "artist")
-          type = "artists";
-        else if (type == "album")
-          type = "albums";
-        else if (type == "track")
-          type = "songs";
-
-        // Set the content type for the collection.
-        if (gotType == false)
-        {
-          items.SetContent(type);
-          gotType = true;
-        }
+        items.SetContent(type);
+        m_bGotType = true;
       }
+    }
 
-      CFileItemPtr item = mediaNode->BuildFileItem(url, *element, isLocal);
-      if (item)
-      {
-        // Set the content type for the item.
-        if (!type.empty())
-          item->SetProperty("mediaType", type);
-
-        // Tags.
-        ParseTags(element, item, "Genre");
-        ParseTags(element, item, "Writer");
-        ParseTags(element, item, "Director");
-        ParseTags(element, item, "Role");
-        ParseTags(element, item, "Country");
-
-        items.Add(item);
-      }
+    CFileItemPtr item = mediaNode->BuildFileItem(url, *element, isLocal);
+    if (item)
+    {
+      // Set the content type for the item.
+      if (!type.empty())
+        item->SetProperty("mediaType", type);
+
+      // Tags.
+      ParseTags(element, item, "Genre");
+      ParseTags(element, item, "Writer");
+      ParseTags(element, item, "Director");
+      ParseTags(element, item, "Role");
+      ParseTags(element, item, "Country");
+
+      items.Add(item);
     }
-    
-    if (element->NextSiblingElement())
-      delete mediaNode;
   }
+  
+  // The node for the last element decides the labels for the whole listing.
+  delete m_lastMediaNode;
+  m_lastMediaNode = mediaNode;
+}
 
-  if (mediaNode != 0)
+///////////////////////////////////////////////////////////////////////////////////////////////////
+void CPlexDirectory::ComputeLabels(const CURL& url, string& strFileLabel, string& strSecondFileLabel, string& strDirLabel, string& strSecondDirLabel)
+{
+  if (m_lastMediaNode != 0)
   {
     CStdString strURL = url.Get();
-    mediaNode->ComputeLabels(strURL, strFileLabel, strSecondFileLabel, strDirLabel, strSecondDirLabel);
-    delete mediaNode;
-  }  
+    m_lastMediaNode->ComputeLabels(strURL, strFileLabel, strSecondFileLabel, strDirLabel, strSecondDirLabel);
+    delete m_lastMediaNode;
+    m_lastMediaNode = 0;
+  }
+}
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+void CPlexDirectory::OnElement(TiXmlElement* container, TiXmlElement* element)
+{
+  ParseElement(m_parseURL, element, *m_items, m_bLocalServer);
 }
 
 ///////////////////////////////////////////////////////////////////////////////////////////////////
@@ -1834,6 +1962,12 @@ void CPlexDirectory::Process()
   
   m_http.SetRequestHeader("X-Plex-Client-Identifier", g_guiSettings.GetString("system.uuid"));
   
+  if (m_containerSize > 0)
+  {
+    m_http.SetRequestHeader("X-Plex-Container-Start", (long)m_containerStart);
+    m_http.SetRequestHeader("X-Plex-Container-Size", (long)m_containerSize);
+  }
+  
   // Build a description of what we support.
   CStdString protocols = "protocols=shoutcast,webkit,http-video;videoDecoders=h264{profile:high&resolution:1080&level:51};audioDecoders=mp3,aac";
   
@@ -1847,10 +1981,17 @@ void CPlexDirectory::Process()
   }
   
   m_http.SetRequestHeader("X-Plex-Client-Capabilities", protocols);
-  m_http.UseOldHttpVersion(true);
+  
+  // Keep the connection alive so the next browse to the same server reuses the
+  // pooled curl session instead of paying for a new handshake, and let the
+  // server compress the (often large) XML response.
+  //
+  m_http.SetContentEncoding("gzip");
   m_http.SetTimeout(m_timeout);
   
-  if (m_body.empty() == false)
+  if (m_bParseResults)
+    m_bSuccess = StreamDirectory(url);
+  else if (m_body.empty() == false)
     m_bSuccess = m_http.Post(url.Get(), m_body, m_data);
   else
     m_bSuccess = m_http.Get(url.Get(), m_data);
@@ -1858,6 +1999,141 @@ void CPlexDirectory::Process()
   m_downloadEvent.Set();
 }
 
+///////////////////////////////////////////////////////////////////////////////////////////////////
+bool CPlexDirectory::StreamDirectory(const CURL& url)
+{
+  BeginParse();
+  
+  if (m_body.empty() == false)
+    m_http.SetPostData(m_body);
+  
+  if (m_http.Open(url) == false)
+  {
+    m_http.Close();
+    return false;
+  }
+  
+  // Tee the response to disk, under a name of our own until we know it's good.
+  if (m_diskCacheKey.empty() == false)
+  {
+    m_diskCacheTemp.Format("%s.%p", CPlexDirectoryCache::GetCacheFile(m_diskCacheKey).c_str(), this);
+    m_bWritingDiskCache = m_diskCacheFile.OpenForWrite(m_diskCacheTemp, true);
+    
+    // The file is named by a hash of the key, so the key itself goes first to catch collisions.
+    CStdString header = m_diskCacheKey + "\n";
+    if (m_bWritingDiskCache && m_diskCacheFile.Write(header.c_str(), header.size()) != (int)header.size())
+      FinishDiskCache(false);
+  }
+  
+  // Feed the parser as the data comes off the wire; items get built as each element closes.
+  char buffer[16384];
+  unsigned int bytesRead;
+  while (m_bStop == false && (bytesRead = m_http.Read(buffer, sizeof(buffer))) > 0)
+  {
+    if (FeedParser(buffer, bytesRead) == false)
+      break;
+  }
+  
+  m_http.Close();
+  
+  if (m_bStop)
+    return false;
+  
+  dprintf("Plex Directory: Streamed %d elements from %s", m_parser.GetElementCount(), m_url.c_str());
+  return m_parser.Finish();
+}
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+void CPlexDirectory::BeginParse()
+{
+  m_parser.Reset();
+  m_parseURL = CURL(m_url);
+  m_bLocalServer = Cocoa_IsHostLocal(m_parseURL.GetHostName());
+  m_bGotType = false;
+  m_crc.Reset();
+}
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+bool CPlexDirectory::FeedParser(const char* data, size_t len)
+{
+  m_crc.Compute(data, len);
+  
+  if (m_bWritingDiskCache && m_diskCacheFile.Write(data, len) != (int)len)
+  {
+    CLog::Log(LOGWARNING, "%s - Unable to write %s, not caching", __FUNCTION__, m_diskCacheTemp.c_str());
+    FinishDiskCache(false);
+  }
+  
+  return m_parser.Feed(data, len);
+}
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+bool CPlexDirectory::LoadDiskCache()
+{
+  CFile file;
+  if (file.Open(CPlexDirectoryCache::GetCacheFile(m_diskCacheKey)) == false)
+    return false;
+  
+  // Make sure it's ours, and not the response to a request whose key hashes the same.
+  char buffer[16384];
+  unsigned int bytesRead = file.Read(buffer, sizeof(buffer));
+  char* body = (char* )memchr(buffer, '\n', bytesRead);
+  if (body == 0 || m_diskCacheKey != CStdString(buffer, body - buffer))
+  {
+    file.Close();
+    return false;
+  }
+  
+  BeginParse();
+  
+  body++;
+  bytesRead -= body - buffer;
+  bool parsed = (bytesRead == 0 || FeedParser(body, bytesRead));
+  while (parsed && (bytesRead = file.Read(buffer, sizeof(buffer))) > 0)
+    parsed = FeedParser(buffer, bytesRead);
+  
+  file.Close();
+  
+  if (m_parser.Finish() == false)
+  {
+    // Truncated or otherwise bogus; forget it and ask the server.
+    CLog::Log(LOGWARNING, "%s - Ignoring bad disk cache for %s", __FUNCTION__, m_url.c_str());
+    CFile::Delete(CPlexDirectoryCache::GetCacheFile(m_diskCacheKey));
+    m_items->ClearItems();
+    return false;
+  }
+  
+  m_bSuccess = true;
+  return true;
+}
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+void CPlexDirectory::FinishDiskCache(bool keep)
+{
+  if (m_bWritingDiskCache == false)
+    return;
+  
+  m_diskCacheFile.Close();
+  m_bWritingDiskCache = false;
+  
+  CStdString cacheFile = CPlexDirectoryCache::GetCacheFile(m_diskCacheKey);
+  if (keep)
+  {
+    CFile::Delete(cacheFile);
+    keep = CFile::Rename(m_diskCacheTemp, cacheFile);
+  }
+  
+  if (keep == false)
+    CFile::Delete(m_diskCacheTemp);
+}
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+void CPlexDirectory::Cancel(bool wait)
+{
+  m_bStop = true;
+  m_http.Cancel(wait);
+}
+
 ///////////////////////////////////////////////////////////////////////////////////////////////////
 void CPlexDirectory::OnExit()
 {
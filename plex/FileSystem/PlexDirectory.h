@@ -8,14 +8,19 @@
  */
 #include <string>
 
+#include "Crc32.h"
+#include "File.h"
 #include "FileCurl.h"
 #include "FileItem.h"
 #include "IDirectory.h"
 #include "Thread.h"
 #include "SortFileItem.h"
+#include "URL.h"
+#include "PlexXMLStreamParser.h"
 
 class CURL;
 class TiXmlElement;
+class PlexMediaNode;
 using namespace std;
 using namespace XFILE;
 
@@ -34,7 +39,8 @@ using namespace XFILE;
 #define PLEX_METADATA_MIXED   100
 
 class CPlexDirectory : public IDirectory, 
-                       public CThread
+                       public CThread,
+                       public IPlexXMLStreamCallback
 {
  public:
   CPlexDirectory(bool parseResults, bool displayDialog, bool replaceLocalhost);
@@ -47,6 +53,19 @@ class CPlexDirectory : public IDirectory,
   virtual void SetTimeout(int timeout) { m_timeout = timeout; }
   void SetBody(const CStdString& body) { m_body = body; }
   
+  /// Only ask the server for [start, start+size) of the container.
+  void SetContainerRange(int start, int size) { m_containerStart = start; m_containerSize = size; }
+  
+  /// Abort a request in progress, from any thread. Without wait it only flags the transfer to
+  /// stop, and returns before it has.
+  void Cancel(bool wait = true);
+  
+  /// Whether a cold request may be answered from the last run's copy on disk.
+  void SetReadDiskCache(bool read) { m_bReadDiskCache = read; }
+  
+  /// Identifies the version of the listing we got: server plus updatedAt, or a checksum.
+  std::string GetValidator() const { return m_validator; }
+  
   std::string GetData() { return m_data; } 
   
   static std::string ProcessMediaElement(const std::string& parentPath, const char* mediaURL, int maxAge, bool local);
@@ -59,9 +78,17 @@ class CPlexDirectory : public IDirectory,
   virtual void Process();
   virtual void OnExit();
   virtual void StopThread();
+  virtual void OnElement(TiXmlElement* container, TiXmlElement* element);
   
   bool ReallyGetDirectory(const CStdString& strPath, CFileItemList &items);
+  bool StreamDirectory(const CURL& url);
+  void BeginParse();
+  bool FeedParser(const char* data, size_t len);
+  bool LoadDiskCache();
+  void FinishDiskCache(bool keep);
   void Parse(const CURL& url, TiXmlElement* root, CFileItemList &items, std::string& strFileLabel, std::string& strSecondFileLabel, std::string& strDirLabel, std::string& strSecondDirLabel, bool isLocal);
+  void ParseElement(const CURL& url, TiXmlElement* element, CFileItemList &items, bool isLocal);
+  void ComputeLabels(const CURL& url, std::string& strFileLabel, std::string& strSecondFileLabel, std::string& strDirLabel, std::string& strSecondDirLabel);
   void ParseTags(TiXmlElement* element, const CFileItemPtr& item, const std::string& name);
   
   CEvent     m_downloadEvent;
@@ -76,7 +103,27 @@ class CPlexDirectory : public IDirectory,
   int        m_timeout;
   CFileCurl  m_http;
   DIR_CACHE_TYPE m_dirCacheType;
+  int        m_containerStart;
+  int        m_containerSize;
+  
+  // Streaming parse state, items are built on the download thread as elements arrive.
+  CPlexXMLStreamParser m_parser;
+  CFileItemList*       m_items;
+  CURL                 m_parseURL;
+  bool                 m_bLocalServer;
+  bool                 m_bGotType;
+  PlexMediaNode*       m_lastMediaNode;
+  
+  // On-disk copy of the response, see CPlexDirectoryCache.
+  CStdString           m_path;
+  CStdString           m_diskCacheKey;
+  CStdString           m_diskCacheTemp;
+  CFile                m_diskCacheFile;
+  bool                 m_bReadDiskCache;
+  bool                 m_bWritingDiskCache;
+  bool                 m_bServedFromDisk;
+  Crc32                m_crc;
+  std::string          m_validator;
   
   static CFileItemListPtr g_filterList;
 };
-
@@ -0,0 +1,172 @@
+/*
+ *  Copyright (C) 2011 Plex, Inc.
+ *
+ */
+
+#include <algorithm>
+#include <vector>
+
+#include "log.h"
+#include "Crc32.h"
+#include "DateTime.h"
+#include "Directory.h"
+#include "DirectoryCache.h"
+#include "File.h"
+#include "FileItem.h"
+#include "GUIUserMessages.h"
+#include "GUIWindowManager.h"
+#include "PlexDirectoryCache.h"
+#include "PlexDirectoryExecutor.h"
+#include "SingleLock.h"
+#include "Util.h"
+
+using namespace std;
+using namespace XFILE;
+
+#define PLEX_DIRECTORY_CACHE          "special://temp/plexdircache/"
+#define PLEX_DIRECTORY_CACHE_MAX_DAYS 30
+#define PLEX_DIRECTORY_CACHE_MAX_SIZE (32 * 1024 * 1024)
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+static bool OlderFirst(const CFileItemPtr& a, const CFileItemPtr& b)
+{
+  return a->m_dateTime < b->m_dateTime;
+}
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+CPlexDirectoryCache::CPlexDirectoryCache()
+{
+  CDirectory::Create(PLEX_DIRECTORY_CACHE);
+  Prune();
+}
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+void CPlexDirectoryCache::Prune()
+{
+  CFileItemList items;
+  if (CDirectory::GetDirectory(PLEX_DIRECTORY_CACHE, items, "", false, false, DIR_CACHE_NEVER) == false)
+    return;
+
+  CDateTime now = CDateTime::GetCurrentDateTime();
+  CDateTime expired = now - CDateTimeSpan(PLEX_DIRECTORY_CACHE_MAX_DAYS, 0, 0, 0);
+  CDateTime abandoned = now - CDateTimeSpan(0, 0, 10, 0);
+  vector<CFileItemPtr> entries;
+  int64_t size = 0;
+  int removed = 0;
+
+  for (int i = 0; i < items.Size(); i++)
+  {
+    CFileItemPtr item = items[i];
+    if (item->m_bIsFolder)
+      continue;
+
+    // Anything but a finished response is a write in progress, or one that was cut short
+    // by a crash if nothing has touched it for a while.
+    //
+    bool temp = CUtil::GetExtension(item->m_strPath) != ".xml";
+    if (temp && item->m_dateTime > abandoned)
+      continue;
+
+    if (temp || item->m_dateTime < expired)
+    {
+      CFile::Delete(item->m_strPath);
+      removed++;
+      continue;
+    }
+
+    entries.push_back(item);
+    size += item->m_dwSize;
+  }
+
+  // Responses are rewritten whenever they're fetched, so the oldest are the least used.
+  sort(entries.begin(), entries.end(), OlderFirst);
+  for (vector<CFileItemPtr>::iterator i = entries.begin(); i != entries.end() && size > PLEX_DIRECTORY_CACHE_MAX_SIZE; ++i)
+  {
+    CFile::Delete((*i)->m_strPath);
+    size -= (*i)->m_dwSize;
+    removed++;
+  }
+
+  if (removed)
+    CLog::Log(LOGINFO, "Plex Directory Cache: removed %d stale entries, %"PRId64" bytes left", removed, size);
+}
+
+// Guards the construction of the instance, which may first be asked for from any thread.
+static CCriticalSection g_instanceSection;
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+CPlexDirectoryCache& CPlexDirectoryCache::Get()
+{
+  static CPlexDirectoryCache* instance = 0;
+  CSingleLock lock(g_instanceSection);
+  if (instance == 0)
+    instance = new CPlexDirectoryCache();
+
+  return *instance;
+}
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+CStdString CPlexDirectoryCache::GetCacheFile(const CStdString& key)
+{
+  Crc32 crc;
+  crc.Compute(key);
+
+  CStdString file;
+  file.Format(PLEX_DIRECTORY_CACHE "%08x.xml", (unsigned __int32)crc);
+  return file;
+}
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+bool CPlexDirectoryCache::IsCold(const CStdString& key)
+{
+  CSingleLock lock(m_section);
+  return m_seen.insert(key).second;
+}
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+void CPlexDirectoryCache::Revalidate(const CStdString& path, const CStdString& url, int start, int size, const string& validator)
+{
+  CSingleLock lock(m_section);
+
+  Revalidation revalidation;
+  revalidation.path = path;
+  revalidation.url = url;
+  revalidation.validator = validator;
+
+  CPlexDirectoryJob* job = new CPlexDirectoryJob(url, start, size);
+  job->BypassDiskCache();
+
+  unsigned int id = CPlexDirectoryExecutor::Get().AddJob(job, this, CJob::PRIORITY_LOW);
+  m_pending[id] = revalidation;
+}
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+void CPlexDirectoryCache::OnJobComplete(unsigned int jobID, bool success, CJob* job)
+{
+  CSingleLock lock(m_section);
+
+  map<unsigned int, Revalidation>::iterator i = m_pending.find(jobID);
+  if (i == m_pending.end())
+    return;
+
+  Revalidation revalidation = i->second;
+  m_pending.erase(i);
+  lock.Leave();
+
+  // If the server's still not there, what we served is as good as it gets.
+  if (success == false)
+    return;
+
+  string validator = ((CPlexDirectoryJob* )job)->GetValidator();
+  if (validator == revalidation.validator)
+    return;
+
+  CLog::Log(LOGINFO, "Plex Directory Cache: %s changed since last run (%s -> %s)", revalidation.url.c_str(), revalidation.validator.c_str(), validator.c_str());
+
+  // The new response is on disk already; make sure the next look at the path gets it.
+  g_directoryCache.ClearDirectory(revalidation.path);
+
+  CGUIMessage msg(GUI_MSG_NOTIFY_ALL, 0, 0, GUI_MSG_UPDATE_PATH);
+  msg.SetStringParam(revalidation.path);
+  g_windowManager.SendThreadMessage(msg);
+}
@@ -0,0 +1,62 @@
+/*
+ *  Copyright (C) 2011 Plex, Inc.
+ *
+ */
+
+#pragma once
+
+#include <map>
+#include <set>
+#include <string>
+
+#include "CriticalSection.h"
+#include "StdString.h"
+#include "utils/Job.h"
+
+/////////////////////////////////////////////////////////////////////////////////////////
+/// Keeps the raw responses of cacheable Plex Media Server listings on disk, so that the
+/// first time we ask for one after starting up it can be parsed straight from the last
+/// run's copy while the server is still waking up. The copy is then checked against the
+/// server in the background, and anyone showing it is told if it changed.
+///
+class CPlexDirectoryCache : public IJobCallback
+{
+ public:
+
+  static CPlexDirectoryCache& Get();
+
+  /// Where the response for a request lives. The name is a hash of the key, so the file
+  /// starts with a line holding the key itself, followed by the response.
+  ///
+  static CStdString GetCacheFile(const CStdString& key);
+
+  /// True the first time a request is seen this session, which is the only time the
+  /// disk copy gets served; after that it's the network (and the memory cache) as usual.
+  ///
+  bool IsCold(const CStdString& key);
+
+  /// Fetch the listing again in the background. If what comes back doesn't match the
+  /// validator of what we served, drop the in-memory copy of path and tell the windows.
+  ///
+  void Revalidate(const CStdString& path, const CStdString& url, int start, int size, const std::string& validator);
+
+  virtual void OnJobComplete(unsigned int jobID, bool success, CJob* job);
+
+ private:
+
+  CPlexDirectoryCache();
+
+  /// Drop leftovers of interrupted writes, and the oldest responses once the cache is too big.
+  void Prune();
+
+  struct Revalidation
+  {
+    CStdString  path;
+    CStdString  url;
+    std::string validator;
+  };
+
+  std::set<CStdString>                 m_seen;
+  std::map<unsigned int, Revalidation> m_pending;
+  CCriticalSection                     m_section;
+};
@@ -0,0 +1,148 @@
+/*
+ *  Copyright (C) 2011 Plex, Inc.
+ *
+ */
+
+#include <boost/lexical_cast.hpp>
+
+#include "log.h"
+#include "AdvancedSettings.h"
+#include "PlexDirectoryExecutor.h"
+#include "SingleLock.h"
+#include "URL.h"
+#include "utils/JobManager.h"
+
+using namespace std;
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+CPlexDirectoryJob::CPlexDirectoryJob(const CStdString& url, int start, int size)
+  : m_url(url)
+  , m_dir(true, false)
+{
+  if (size > 0)
+    m_dir.SetContainerRange(start, size);
+}
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+bool CPlexDirectoryJob::DoWork()
+{
+  return m_dir.GetDirectory(m_url, m_items);
+}
+
+// Guards the construction of the instance, which may first be asked for from any thread.
+static CCriticalSection g_instanceSection;
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+CPlexDirectoryExecutor& CPlexDirectoryExecutor::Get()
+{
+  static CPlexDirectoryExecutor* instance = 0;
+  CSingleLock lock(g_instanceSection);
+  if (instance == 0)
+    instance = new CPlexDirectoryExecutor();
+
+  return *instance;
+}
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+unsigned int CPlexDirectoryExecutor::AddJob(CPlexDirectoryJob* job, IJobCallback* callback, CJob::PRIORITY priority)
+{
+  CSingleLock lock(m_section);
+
+  CURL url(job->m_url);
+
+  Request request;
+  request.id = ++m_nextID;
+  request.workerID = 0;
+  request.job = job;
+  request.callback = callback;
+  request.priority = priority;
+  request.server = url.GetHostName() + ":" + boost::lexical_cast<string>(url.GetPort());
+  m_pending.push_back(request);
+
+  Dispatch();
+  return request.id;
+}
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+void CPlexDirectoryExecutor::CancelJob(unsigned int id)
+{
+  CSingleLock lock(m_section);
+
+  for (RequestList::iterator i = m_pending.begin(); i != m_pending.end(); ++i)
+  {
+    if (i->id == id)
+    {
+      delete i->job;
+      m_pending.erase(i);
+      return;
+    }
+  }
+
+  for (RequestList::iterator i = m_running.begin(); i != m_running.end(); ++i)
+  {
+    if (i->id == id)
+    {
+      // The slot frees up once the worker notices, in OnJobComplete. Cancel() only flags the
+      // transfer, so it's fine under the lock that keeps the job from being freed meanwhile.
+      i->callback = 0;
+      i->job->Cancel();
+      return;
+    }
+  }
+}
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+void CPlexDirectoryExecutor::OnJobComplete(unsigned int jobID, bool success, CJob* job)
+{
+  CSingleLock lock(m_section);
+
+  unsigned int id = 0;
+  IJobCallback* callback = 0;
+
+  for (RequestList::iterator i = m_running.begin(); i != m_running.end(); ++i)
+  {
+    if (i->workerID == jobID)
+    {
+      id = i->id;
+      callback = i->callback;
+      m_inFlight[i->server]--;
+      m_running.erase(i);
+      break;
+    }
+  }
+
+  Dispatch();
+  lock.Leave();
+
+  if (callback)
+    callback->OnJobComplete(id, success, job);
+}
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+void CPlexDirectoryExecutor::Dispatch()
+{
+  for (int priority = CJob::PRIORITY_HIGH; priority >= CJob::PRIORITY_LOW; priority--)
+  {
+    RequestList::iterator i = m_pending.begin();
+    while (i != m_pending.end())
+    {
+      if (i->priority == priority && m_inFlight[i->server] < g_advancedSettings.m_plexRequestsPerServer)
+      {
+        m_inFlight[i->server]++;
+        m_running.push_back(*i);
+        i = m_pending.erase(i);
+
+        // The job manager's own worker limits keep low priority work from starving navigation.
+        Request& request = m_running.back();
+        request.workerID = CJobManager::GetInstance().AddJob(request.job, this, request.priority);
+      }
+      else
+      {
+        ++i;
+      }
+    }
+  }
+
+  if (m_pending.size() > 0)
+    CLog::Log(LOGDEBUG, "%s - %d requests running, %d waiting for a free slot", __FUNCTION__, (int)m_running.size(), (int)m_pending.size());
+}
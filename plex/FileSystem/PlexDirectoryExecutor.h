@@ -0,0 +1,93 @@
+/*
+ *  Copyright (C) 2011 Plex, Inc.
+ *
+ */
+
+#pragma once
+
+#include <list>
+#include <map>
+#include <string>
+
+#include "CriticalSection.h"
+#include "FileItem.h"
+#include "PlexDirectory.h"
+#include "utils/Job.h"
+
+/////////////////////////////////////////////////////////////////////////////////////////
+/// One directory listing, run by the executor on a job worker.
+///
+class CPlexDirectoryJob : public CJob
+{
+ public:
+
+  /// A non-zero size only asks the server for [start, start+size) of the container.
+  CPlexDirectoryJob(const CStdString& url, int start = 0, int size = 0);
+
+  virtual bool DoWork();
+  virtual const char* GetType() const { return "plexdirectory"; }
+
+  /// Abort the request, from any thread. Doesn't wait for it to stop, so it's safe with locks held.
+  void Cancel() { m_dir.Cancel(false); }
+
+  /// Always go to the server, for revalidating what was served from disk.
+  void BypassDiskCache() { m_dir.SetReadDiskCache(false); }
+
+  std::string GetValidator() const { return m_dir.GetValidator(); }
+
+  CStdString    m_url;
+  CFileItemList m_items;
+
+ private:
+
+  CPlexDirectory m_dir;
+};
+
+/////////////////////////////////////////////////////////////////////////////////////////
+/// Runs background Plex Media Server listings on the shared job workers. No more than
+/// <plexrequestsperserver> requests are in flight to any one server; the rest wait here,
+/// highest priority first, so the rows the user is looking at don't queue up behind a
+/// slow shared server.
+///
+class CPlexDirectoryExecutor : public IJobCallback
+{
+ public:
+
+  static CPlexDirectoryExecutor& Get();
+
+  /// Queue a job. The callback's OnJobComplete is called on a worker thread with the
+  /// returned ID, and the job is destroyed when it returns.
+  ///
+  unsigned int AddJob(CPlexDirectoryJob* job, IJobCallback* callback, CJob::PRIORITY priority = CJob::PRIORITY_LOW);
+
+  /// Drop a queued job, or abort one that's already talking to the server. The callback
+  /// isn't called for cancelled jobs, unless it was already on its way.
+  ///
+  void CancelJob(unsigned int id);
+
+  virtual void OnJobComplete(unsigned int jobID, bool success, CJob* job);
+
+ private:
+
+  CPlexDirectoryExecutor() : m_nextID(0) {}
+
+  struct Request
+  {
+    unsigned int       id;
+    unsigned int       workerID;
+    CPlexDirectoryJob* job;
+    IJobCallback*      callback;
+    CJob::PRIORITY     priority;
+    std::string        server;
+  };
+
+  typedef std::list<Request> RequestList;
+
+  void Dispatch();
+
+  RequestList                m_pending;
+  RequestList                m_running;
+  std::map<std::string, int> m_inFlight;
+  unsigned int               m_nextID;
+  CCriticalSection           m_section;
+};
@@ -0,0 +1,229 @@
+/*
+ *  Copyright (C) 2011 Plex, Inc.
+ *
+ */
+
+#include <string.h>
+
+#include "log.h"
+#include "PlexXMLStreamParser.h"
+
+using namespace std;
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+CPlexXMLStreamParser::CPlexXMLStreamParser(IPlexXMLStreamCallback* callback)
+  : m_callback(callback)
+{
+  Reset();
+}
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+void CPlexXMLStreamParser::Reset()
+{
+  m_rootDoc.Clear();
+  m_root = 0;
+  m_tag.clear();
+  m_element.clear();
+  m_quote = 0;
+  m_inTag = false;
+  m_depth = 0;
+  m_elementCount = 0;
+  m_done = false;
+  m_error = false;
+}
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+bool CPlexXMLStreamParser::Feed(const char* data, size_t len)
+{
+  size_t i = 0;
+  while (i < len && m_error == false)
+  {
+    if (m_inTag == false)
+    {
+      // Character data; only worth keeping if we're inside a child element.
+      const char* lt = (const char* )memchr(data + i, '<', len - i);
+      size_t end = lt ? (lt - data) : len;
+
+      if (m_depth > 1)
+        m_element.append(data + i, end - i);
+
+      i = end;
+      if (lt)
+      {
+        m_inTag = true;
+        m_tag = "<";
+        i++;
+      }
+    }
+    else
+    {
+      char c = data[i++];
+      m_tag += c;
+
+      if (m_quote)
+      {
+        if (c == m_quote)
+          m_quote = 0;
+      }
+      else if (c == '"' || c == '\'')
+      {
+        // Quotes only matter in markup, not inside comments or CDATA.
+        if (m_tag.compare(0, 3, "<!-") != 0 && m_tag.compare(0, 3, "<![") != 0)
+          m_quote = c;
+      }
+      else if (c == '>' && IsTagComplete())
+      {
+        OnTag();
+        m_inTag = false;
+        m_tag.clear();
+      }
+    }
+  }
+
+  return m_error == false;
+}
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+bool CPlexXMLStreamParser::Finish()
+{
+  if (m_error == false && m_done == false)
+    CLog::Log(LOGERROR, "%s - Response ended before the container was closed (depth %d)", __FUNCTION__, m_depth);
+
+  return m_done && m_error == false;
+}
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+bool CPlexXMLStreamParser::IsTagComplete() const
+{
+  if (m_tag.compare(0, 4, "<!--") == 0)
+    return m_tag.size() >= 7 && m_tag.compare(m_tag.size() - 3, 3, "-->") == 0;
+
+  if (m_tag.compare(0, 9, "<![CDATA[") == 0)
+    return m_tag.size() >= 12 && m_tag.compare(m_tag.size() - 3, 3, "]]>") == 0;
+
+  return true;
+}
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+CPlexXMLStreamParser::TagType CPlexXMLStreamParser::GetTagType() const
+{
+  if (m_tag.size() < 3 || m_tag[1] == '?' || m_tag[1] == '!')
+    return TAG_OTHER;
+
+  if (m_tag[1] == '/')
+    return TAG_END;
+
+  if (m_tag[m_tag.size() - 2] == '/')
+    return TAG_EMPTY;
+
+  return TAG_START;
+}
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+void CPlexXMLStreamParser::OnTag()
+{
+  TagType type = GetTagType();
+
+  if (m_done)
+  {
+    // Anything but trailing comments after the container is bogus.
+    if (type != TAG_OTHER)
+    {
+      CLog::Log(LOGERROR, "%s - Unexpected markup after the container: %s", __FUNCTION__, m_tag.c_str());
+      m_error = true;
+    }
+    return;
+  }
+
+  if (m_depth == 0)
+  {
+    // Prolog, doctype, comments.
+    if (type == TAG_OTHER)
+      return;
+
+    if (type == TAG_END)
+    {
+      CLog::Log(LOGERROR, "%s - Unbalanced end tag: %s", __FUNCTION__, m_tag.c_str());
+      m_error = true;
+      return;
+    }
+
+    // The container. Parse its start tag on its own, as an empty element.
+    string tag = m_tag;
+    if (type == TAG_START)
+      tag.insert(tag.size() - 1, "/");
+
+    m_rootDoc.Parse(tag.c_str(), 0, TIXML_ENCODING_UTF8);
+    m_root = m_rootDoc.RootElement();
+    if (m_root == 0)
+    {
+      CLog::Log(LOGERROR, "%s - Unable to parse container: %s", __FUNCTION__, m_tag.c_str());
+      m_error = true;
+      return;
+    }
+
+    if (type == TAG_EMPTY)
+      m_done = true;
+    else
+      m_depth = 1;
+  }
+  else if (m_depth == 1)
+  {
+    if (type == TAG_END)
+    {
+      m_depth = 0;
+      m_done = true;
+    }
+    else if (type == TAG_START)
+    {
+      m_element = m_tag;
+      m_depth = 2;
+    }
+    else if (type == TAG_EMPTY)
+    {
+      m_element = m_tag;
+      EmitElement();
+    }
+  }
+  else
+  {
+    m_element += m_tag;
+
+    if (type == TAG_START)
+    {
+      m_depth++;
+    }
+    else if (type == TAG_END)
+    {
+      m_depth--;
+      if (m_depth == 1)
+        EmitElement();
+    }
+  }
+}
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+void CPlexXMLStreamParser::EmitElement()
+{
+  TiXmlDocument doc;
+  doc.Parse(m_element.c_str(), 0, TIXML_ENCODING_UTF8);
+
+  TiXmlElement* element = doc.RootElement();
+  if (element == 0 || doc.Error())
+  {
+    // A single bad element shouldn't cost us the rest of the listing.
+    CLog::Log(LOGERROR, "%s - Unable to parse element (%s)\n%s", __FUNCTION__, doc.ErrorDesc(), m_element.c_str());
+  }
+  else
+  {
+    TiXmlElement* child = m_root->InsertEndChild(*element)->ToElement();
+    m_elementCount++;
+
+    if (m_callback)
+      m_callback->OnElement(m_root, child);
+
+    m_root->RemoveChild(child);
+  }
+
+  m_element.clear();
+}
@@ -0,0 +1,73 @@
+/*
+ *  Copyright (C) 2011 Plex, Inc.
+ *
+ */
+
+#pragma once
+
+#include <string>
+
+#include <tinyXML/tinyxml.h>
+
+/////////////////////////////////////////////////////////////////////////////////////////
+class IPlexXMLStreamCallback
+{
+ public:
+
+  virtual ~IPlexXMLStreamCallback() {}
+
+  /// Called as soon as a direct child of the container has been closed. The element is
+  /// temporarily linked under the container so Parent() works, and is freed on return.
+  ///
+  virtual void OnElement(TiXmlElement* container, TiXmlElement* element) = 0;
+};
+
+/////////////////////////////////////////////////////////////////////////////////////////
+/// Incremental parser for Plex Media Server responses. Bytes are fed in as they arrive
+/// off the wire; only the container's start tag and the child element currently being
+/// read are ever held in memory, so a 20k track listing never exists as a full DOM.
+///
+class CPlexXMLStreamParser
+{
+ public:
+
+  CPlexXMLStreamParser(IPlexXMLStreamCallback* callback);
+
+  /// Feed the next chunk of the response. Returns false once the stream is known bad.
+  bool Feed(const char* data, size_t len);
+
+  /// True if the container was opened and closed without errors.
+  bool Finish();
+
+  /// Start over, dropping any partial state.
+  void Reset();
+
+  /// The container element, with its attributes but without children.
+  TiXmlElement* GetRoot() { return m_root; }
+
+  /// Number of child elements handed to the callback so far.
+  int GetElementCount() const { return m_elementCount; }
+
+ private:
+
+  enum TagType { TAG_START, TAG_END, TAG_EMPTY, TAG_OTHER };
+
+  bool     IsTagComplete() const;
+  TagType  GetTagType() const;
+  void     OnTag();
+  void     EmitElement();
+
+  IPlexXMLStreamCallback* m_callback;
+
+  TiXmlDocument  m_rootDoc;
+  TiXmlElement*  m_root;
+
+  std::string    m_tag;
+  std::string    m_element;
+  char           m_quote;
+  bool           m_inTag;
+  int            m_depth;
+  int            m_elementCount;
+  bool           m_done;
+  bool           m_error;
+};
@@ -296,6 +296,7 @@ class MyPlexManager
     http.SetRequestHeader("X-Plex-Provides", "player");
     http.SetRequestHeader("X-Plex-Platform", Cocoa_GetMachinePlatform());
     http.SetRequestHeader("X-Plex-Platform-Version", Cocoa_GetMachinePlatformVersion());
+    http.SetContentEncoding("gzip");
   }
   
   /// Utility method to retrieve the myPlex URL.
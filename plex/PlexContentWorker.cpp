@@ -9,17 +9,16 @@ using namespace std;
 using namespace boost;
 
 /////////////////////////////////////////////////////////////////////////////////////////
-PlexContentWorkerPtr PlexContentWorkerManager::enqueue(int targetWindow, const string& url, int contextID)
+PlexContentWorkerPtr PlexContentWorkerManager::enqueue(int targetWindow, const string& url, int contextID, CJob::PRIORITY priority)
 {
   recursive_mutex::scoped_lock lk(m_mutex);
   
   // Create the worker and add to the map.
-  PlexContentWorkerPtr worker = PlexContentWorkerPtr(new PlexContentWorker(this, m_workerID++, targetWindow, url, contextID));
+  PlexContentWorkerPtr worker = PlexContentWorkerPtr(new PlexContentWorker(m_workerID++, targetWindow, url, contextID));
   m_pendingWorkers[worker->getID()] = worker;
   
-  // Run in a separate thread.
-  thread_ptr t = thread_ptr(new thread(&PlexContentWorker::run, worker.get()));
-  worker->setThread(t);
+  // Hand the request to the executor.
+  worker->m_requestID = CPlexDirectoryExecutor::Get().AddJob(new CPlexDirectoryJob(url), this, priority);
   
   return worker;
 }
@@ -31,5 +30,42 @@ void PlexContentWorkerManager::cancelPending()
   
   typedef pair<int, PlexContentWorkerPtr> int_worker_pair;
   BOOST_FOREACH(int_worker_pair pair, m_pendingWorkers)
+  {
     pair.second->cancel();
+    CPlexDirectoryExecutor::Get().CancelJob(pair.second->m_requestID);
+  }
+  
+  // Nothing will come back for these now.
+  m_pendingWorkers.clear();
+}
+
+/////////////////////////////////////////////////////////////////////////////////////////
+void PlexContentWorkerManager::OnJobComplete(unsigned int jobID, bool success, CJob* job)
+{
+  recursive_mutex::scoped_lock lk(m_mutex);
+  
+  typedef pair<int, PlexContentWorkerPtr> int_worker_pair;
+  BOOST_FOREACH(int_worker_pair pair, m_pendingWorkers)
+  {
+    PlexContentWorkerPtr worker = pair.second;
+    if (worker->m_requestID != jobID)
+      continue;
+    
+    if (worker->m_cancelled)
+    {
+      // Get rid of it.
+      m_pendingWorkers.erase(worker->getID());
+    }
+    else
+    {
+      // Take the results, the job is deleted when we return.
+      worker->m_results->Assign(((CPlexDirectoryJob* )job)->m_items);
+      
+      // Notify the window.
+      CGUIMessage msg(GUI_MSG_SEARCH_HELPER_COMPLETE, worker->m_targetWindow, 0, worker->getID(), worker->m_contextID);
+      g_windowManager.SendThreadMessage(msg);
+    }
+    
+    break;
+  }
 }
@@ -9,22 +9,24 @@
 #include <string>
 
 #include <boost/foreach.hpp>
-#include <boost/thread.hpp>
 #include <boost/thread/recursive_mutex.hpp>
 
 #include "FileItem.h"
 #include "GUIUserMessages.h"
 #include "GUIWindowManager.h"
-#include "PlexDirectory.h"
+#include "PlexDirectoryExecutor.h"
 #include "PictureThumbLoader.h"
 #include "ThumbLoader.h"
 
 class PlexContentWorker;
 typedef boost::shared_ptr<PlexContentWorker> PlexContentWorkerPtr;
-typedef boost::shared_ptr<boost::thread> thread_ptr;
 
 /////////////////////////////////////////////////////////////////////////////////////////
-class PlexContentWorkerManager
+/// Fetches content for a window's lists. The requests run on the shared Plex directory
+/// executor rather than a thread each, and the results come back to the target window
+/// as a GUI_MSG_SEARCH_HELPER_COMPLETE message.
+///
+class PlexContentWorkerManager : public IJobCallback
 {
  public:
   
@@ -38,8 +40,8 @@ class PlexContentWorkerManager
     return m_pendingWorkers.size();
   }
 
-  /// Queue a new worker.
-  PlexContentWorkerPtr enqueue(int targetWindow, const string& url, int contextID);
+  /// Queue a new worker. Lists the user is looking at should go in ahead of decoration.
+  PlexContentWorkerPtr enqueue(int targetWindow, const string& url, int contextID, CJob::PRIORITY priority=CJob::PRIORITY_NORMAL);
   
   /// Find by ID.
   PlexContentWorkerPtr find(int id)
@@ -61,9 +63,12 @@ class PlexContentWorkerManager
       m_pendingWorkers.erase(id);
   }
 
-  /// Cancel all pending workers.
+  /// Cancel all pending workers, aborting their requests.
   void cancelPending();
 
+  /// Called by the executor on a worker thread.
+  virtual void OnJobComplete(unsigned int jobID, bool success, CJob* job);
+  
  private:
   
   /// Keeps track of the last worker ID.
@@ -83,59 +88,31 @@ class PlexContentWorker
   
  public:
 
-  void run()
-  {
-    printf("[%p] Processing content request in thread [%s]\n", this, m_url.c_str());
-
-    if (m_cancelled == false)
-    {
-      // Get the results.
-      CPlexDirectory dir;
-      dir.GetDirectory(m_url, *m_results.get());
-    }
-
-    // If we haven't been canceled, send them back.
-    if (m_cancelled == false)
-    {
-      // Notify the main menu.
-      CGUIMessage msg(GUI_MSG_SEARCH_HELPER_COMPLETE, m_targetWindow, 0, m_id, m_contextID);
-      g_windowManager.SendThreadMessage(msg);
-    }
-    else
-    {
-      // Get rid of myself.
-      m_manager->destroy(m_id);
-    }
-  }
-
   void cancel() { m_cancelled = true; }
   CFileItemListPtr getResults() { return m_results; }
   int getID() { return m_id; }
-  void setThread(thread_ptr& t) { m_myThread = t; }
 
  protected:
 
-  PlexContentWorker(PlexContentWorkerManager* manager, int id, int targetWindow, const string& url, int contextID)
-    : m_manager(manager)
-    , m_id(id)
+  PlexContentWorker(int id, int targetWindow, const string& url, int contextID)
+    : m_id(id)
     , m_targetWindow(targetWindow)
     , m_url(url)
     , m_cancelled(false)
     , m_contextID(contextID)
+    , m_requestID(0)
     , m_results(new CFileItemList())
   {}
 
  private:
 
-  PlexContentWorkerManager* m_manager;
-  
   int              m_id;
   int              m_targetWindow;
   string           m_url;
   bool             m_cancelled;
   int              m_contextID;
+  unsigned int     m_requestID;
   CFileItemListPtr m_results;
-  thread_ptr       m_myThread;
 };
 
 typedef boost::shared_ptr<CBackgroundInfoLoader> CBackgroundInfoLoaderPtr;
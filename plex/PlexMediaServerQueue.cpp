@@ -2,62 +2,250 @@
 #include "log.h"
 #include "PlexMediaServerQueue.h"
 #include "HTTP.h"
+#include "TimeUtils.h"
+
+#include <boost/foreach.hpp>
+
+#define MAX_QUEUED_REQUESTS 256
+#define MAX_ATTEMPTS        5
+#define MIN_RETRY_MS        1000
+#define MAX_RETRY_MS        60000
 
 PlexMediaServerQueue PlexMediaServerQueue::g_plexMediaServerQueue;
 
 /////////////////////////////////////////////////////////////////////////////
 PlexMediaServerQueue::PlexMediaServerQueue()
   : m_allowScrobble(true)
+  , m_enqueued(0)
+  , m_coalesced(0)
+  , m_sent(0)
+  , m_failed(0)
+  , m_dropped(0)
 {
   Create();
 }
 
+/////////////////////////////////////////////////////////////////////////////
+void PlexMediaServerQueue::enqueue(const string& url, const string& verb, const string& coalesceKey)
+{
+  m_mutex.lock();
+  m_enqueued++;
+  
+  // If an older update for the same thing hasn't gone out yet, just replace it.
+  bool coalesced = false;
+  if (coalesceKey.empty() == false)
+  {
+    BOOST_FOREACH(Request& request, m_queue)
+    {
+      if (request.coalesceKey == coalesceKey)
+      {
+        request.verb = verb;
+        request.url = url;
+        coalesced = true;
+        m_coalesced++;
+        break;
+      }
+    }
+  }
+  
+  if (coalesced == false)
+  {
+    // Don't grow without bound while a server is away; the oldest news is the least useful.
+    if (m_queue.size() >= MAX_QUEUED_REQUESTS)
+    {
+      CLog::Log(LOGWARNING, "Plex Media Server Queue: Queue is full, dropping %s", m_queue.front().url.c_str());
+      m_queue.pop_front();
+      m_dropped++;
+    }
+    
+    CURL u(url);
+    Request request;
+    request.verb = verb;
+    request.url = url;
+    request.server = u.GetHostName() + ":" + lexical_cast<string>(u.GetPort());
+    request.coalesceKey = coalesceKey;
+    request.attempts = 0;
+    m_queue.push_back(request);
+  }
+  
+  m_mutex.unlock();
+  m_condition.notify_one();
+}
+
 /////////////////////////////////////////////////////////////////////////////
 void PlexMediaServerQueue::Process()
 {
   while (m_bStop == false)
   {
-    // Wait for be signalled.
     m_mutex.lock();
-    m_condition.wait(m_mutex);
     
-    // OK, now process our queue.
-    while (m_queue.size() > 0)
+    // Take everything that isn't waiting on a server to come back, grouped by server.
+    unsigned int now = CTimeUtils::GetTimeMS();
+    unsigned int nextRetry = 0;
+    map<string, deque<Request> > batches;
+    deque<Request> waiting;
+    
+    BOOST_FOREACH(const Request& request, m_queue)
     {
-      // Get a URL.
-      pair<string, string> pair = m_queue.front();
-      m_queue.pop();
-      m_mutex.unlock();
-      
-      // If this is going to a remote shared server, don't do it, until we finish profiles.
-      if (pair.second.find("X-Plex-Token") != string::npos && 
-          pair.second.find(g_guiSettings.GetString("myplex.token")) == string::npos)
+      map<string, ServerState>::iterator server = m_servers.find(request.server);
+      if (server != m_servers.end() && (int)(server->second.retryAt - now) > 0)
       {
-        dprintf("We're not going to send a status message, because it's a shared server.");
+        unsigned int wait = server->second.retryAt - now;
+        if (nextRetry == 0 || wait < nextRetry)
+          nextRetry = wait;
+        
+        waiting.push_back(request);
       }
       else
       {
-        // Hit the Plex Media Server.
-        CFileCurl  http;
-        CStdString resp;
-        
-        if (pair.first == "PUT")
-          http.Put(pair.second, resp);
+        batches[request.server].push_back(request);
+      }
+    }
+    
+    m_queue.swap(waiting);
+    
+    if (batches.empty())
+    {
+      // Wait to be signalled, or until the next server is due a retry.
+      if (m_bStop == false)
+      {
+        if (nextRetry > 0)
+          m_condition.timed_wait(m_mutex, posix_time::milliseconds(nextRetry));
         else
-          http.Get(pair.second, resp);
-        
-        CLog::Log(LOGNOTICE, "Plex Media Server Queue: %s", pair.second.c_str());
+          m_condition.wait(m_mutex);
       }
-
-      m_mutex.lock();
+      
+      m_mutex.unlock();
+      continue;
     }
     
     m_mutex.unlock();
+    
+    typedef pair<const string, deque<Request> > server_batch_pair;
+    BOOST_FOREACH(server_batch_pair& batch, batches)
+      sendBatch(batch.first, batch.second);
+    
+    // enqueue() bumps the counters from other threads.
+    m_mutex.lock();
+    CLog::Log(LOGDEBUG, "Plex Media Server Queue: enqueued=%u coalesced=%u sent=%u failed=%u dropped=%u", 
+              m_enqueued, m_coalesced, m_sent, m_failed, m_dropped);
+    m_mutex.unlock();
   }
   
   printf("Exiting Plex Media Server queue...\n");
 }
 
+/////////////////////////////////////////////////////////////////////////////
+void PlexMediaServerQueue::sendBatch(const string& server, deque<Request>& batch)
+{
+  // One handle for the whole batch, so the requests go back to back over the
+  // same kept-alive connection.
+  //
+  CFileCurl http;
+  
+  while (batch.size() > 0 && m_bStop == false)
+  {
+    Request& request = batch.front();
+    
+    // If this is going to a remote shared server, don't do it, until we finish profiles.
+    if (request.url.find("X-Plex-Token") != string::npos && 
+        request.url.find(g_guiSettings.GetString("myplex.token")) == string::npos)
+    {
+      dprintf("We're not going to send a status message, because it's a shared server.");
+      batch.pop_front();
+      continue;
+    }
+    
+    // Hit the Plex Media Server.
+    CStdString resp;
+    bool success;
+    
+    if (request.verb == "PUT")
+      success = http.Put(request.url, resp);
+    else
+      success = http.Get(request.url, resp);
+    
+    if (success)
+    {
+      CLog::Log(LOGNOTICE, "Plex Media Server Queue: %s", request.url.c_str());
+      m_servers.erase(server);
+      m_sent++;
+      batch.pop_front();
+      continue;
+    }
+    
+    // The server is there but didn't like the request, which won't change by asking again.
+    long response = http.GetHttpResponseCode();
+    if (response >= 400)
+    {
+      CLog::Log(LOGERROR, "Plex Media Server Queue: %s answered %ld, dropping it", request.url.c_str(), response);
+      m_servers.erase(server);
+      m_failed++;
+      batch.pop_front();
+      continue;
+    }
+    
+    // Back off from this server, exponentially, and put the rest of its batch back in line.
+    ServerState& state = m_servers[server];
+    state.failures++;
+    
+    int backoff = min(MIN_RETRY_MS << min(state.failures - 1, 10), MAX_RETRY_MS);
+    state.retryAt = CTimeUtils::GetTimeMS() + backoff;
+    
+    if (++request.attempts >= MAX_ATTEMPTS)
+    {
+      CLog::Log(LOGERROR, "Plex Media Server Queue: Giving up on %s", request.url.c_str());
+      m_failed++;
+      batch.pop_front();
+    }
+    else
+    {
+      CLog::Log(LOGWARNING, "Plex Media Server Queue: Failed to reach %s, retrying in %d ms", server.c_str(), backoff);
+    }
+    
+    break;
+  }
+  
+  requeue(batch);
+}
+
+/////////////////////////////////////////////////////////////////////////////
+void PlexMediaServerQueue::requeue(deque<Request>& batch)
+{
+  if (batch.empty())
+    return;
+  
+  m_mutex.lock();
+  
+  // These were in line before anything queued since, so they go back at the front,
+  // unless a newer update has already superseded them.
+  //
+  for (deque<Request>::reverse_iterator i = batch.rbegin(); i != batch.rend(); ++i)
+  {
+    bool superseded = false;
+    if (i->coalesceKey.empty() == false)
+    {
+      BOOST_FOREACH(const Request& request, m_queue)
+      {
+        if (request.coalesceKey == i->coalesceKey)
+        {
+          superseded = true;
+          break;
+        }
+      }
+    }
+    
+    if (superseded)
+      m_coalesced++;
+    else if (m_queue.size() < MAX_QUEUED_REQUESTS)
+      m_queue.push_front(*i);
+    else
+      m_dropped++;
+  }
+  
+  m_mutex.unlock();
+}
+
 /////////////////////////////////////////////////////////////////////////////
 void PlexMediaServerQueue::StopThread()
 {
@@ -6,7 +6,9 @@
 #include <boost/lexical_cast.hpp>
 
 #include <string>
+#include <deque>
 #include <queue>
+#include <map>
 
 #include "FileItem.h"
 #include "Thread.h"
@@ -140,13 +142,10 @@ class PlexMediaServerQueue : public CThread
   
  protected:
   
-  void enqueue(const string& url, const string& verb="GET")
-  {
-    m_mutex.lock();
-    m_queue.push(pair<string, string>(verb, url));
-    m_mutex.unlock();
-    m_condition.notify_one();
-  }
+  /// Queue a request. Requests sharing a non-empty coalesce key replace each other while
+  /// still waiting to go out, so only the newest one is ever sent.
+  ///
+  void enqueue(const string& url, const string& verb="GET", const string& coalesceKey="");
   
   void enqueue(const string& verb, const CFileItemPtr& item, const string& options="")
   {
@@ -166,8 +165,13 @@ class PlexMediaServerQueue : public CThread
       url += "&identifier=" + identifier;
       url += options;
       
+      // Only the latest progress for an item matters.
+      string coalesceKey;
+      if (verb == "progress")
+        coalesceKey = verb + ":" + item->GetProperty("containerKey") + ":" + item->GetProperty("ratingKey");
+      
       // Queue it up!
-      enqueue(url);
+      enqueue(url, "GET", coalesceKey);
     }
   }
   
@@ -192,10 +196,40 @@ class PlexMediaServerQueue : public CThread
   
  private:
   
-  queue<pair<string, string> > m_queue;
+  struct Request
+  {
+    string verb;
+    string url;
+    string server;
+    string coalesceKey;
+    int    attempts;
+  };
+  
+  struct ServerState
+  {
+    ServerState() : failures(0), retryAt(0) {}
+    
+    int          failures;
+    unsigned int retryAt;
+  };
+  
+  void sendBatch(const string& server, deque<Request>& batch);
+  void requeue(deque<Request>& batch);
+  
+  deque<Request> m_queue;
   condition     m_condition;
   mutex         m_mutex;
   bool          m_allowScrobble;
   
+  /// Servers we're backing off from, only touched by the queue thread.
+  map<string, ServerState> m_servers;
+  
+  /// Statistics.
+  unsigned int  m_enqueued;
+  unsigned int  m_coalesced;
+  unsigned int  m_sent;
+  unsigned int  m_failed;
+  unsigned int  m_dropped;
+  
   static PlexMediaServerQueue g_plexMediaServerQueue;
 };
@@ -4,7 +4,7 @@ rm -rf addons/metadata.*
 rm -rf addons/skin.mediastream/.git
 rm -rf addons/skin.confluence
 cd addons/skin.mediastream
-../../../../../../../../tools/TexturePacker/TexturePacker -input media
+../../../../../../../../tools/TexturePacker/TexturePacker -pagealign -atlas -input media
 rm media/*
 rm -rf media-lite
 mv Textures.xbt media/
@@ -0,0 +1,211 @@
+/*
+ *      Copyright (C) 2005-2010 Team XBMC
+ *      http://www.xbmc.org
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, write to
+ *  the Free Software Foundation, 675 Mass Ave, Cambridge, MA 02139, USA.
+ *  http://www.gnu.org/copyleft/gpl.html
+ *
+ */
+
+/*
+ * Reads a file the way the ffmpeg demuxer reads it through CDVDInputStreamFile and through
+ * CDVDInputStreamMapped, and reports how many bytes each copies per second of media.
+ *
+ *   MappedReadBench <file> <duration of the media in seconds> [seeks]
+ *
+ * The file stream is read() 32KB at a time into the demuxer's buffer, as CFileHD does. The
+ * mapped stream is the same calls CDVDInputStreamMapped::Read() makes: pages of the file are
+ * mapped over the demuxer's 1MB buffer, and only the reads up to a page boundary after a seek
+ * are copied. With seeks > 0 the file is read from that many places spread over it, as
+ * skipping through a film would. Every byte the demuxer gets is summed, which checks that
+ * both streams read the same thing, and makes the mapped stream pay for its page faults.
+ *
+ * Pages of the file are dropped from the cache before each pass where the kernel lets us,
+ * but run it a few times and on a file larger than memory for figures that mean anything.
+ */
+
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/time.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <algorithm>
+
+#define FILE_BUFFER_SIZE      32768           // FFMPEG_FILE_BUFFER_SIZE
+#define MAPPED_BUFFER_SIZE    (1024 * 1024)   // as in DVDInputStreamMapped.cpp
+
+struct Result
+{
+  int64_t  read;
+  int64_t  copied;
+  double   seconds;
+  unsigned sum;
+};
+
+static double Now()
+{
+  struct timeval tv;
+  gettimeofday(&tv, NULL);
+  return tv.tv_sec + tv.tv_usec / 1000000.0;
+}
+
+static void DropCache(int fd)
+{
+#ifndef __APPLE__
+  posix_fadvise(fd, 0, 0, POSIX_FADV_DONTNEED);
+#endif
+}
+
+// what the demuxer does with what it's given
+static unsigned Parse(const unsigned char* data, int size)
+{
+  unsigned sum = 0;
+  for (int i = 0; i < size; i++)
+    sum += data[i];
+  return sum;
+}
+
+static int ReadFile(int fd, unsigned char* buffer, int64_t position, int64_t length, Result& result)
+{
+  ssize_t ret = pread(fd, buffer, (size_t)std::min((int64_t)FILE_BUFFER_SIZE, length - position), (off_t)position);
+  if (ret <= 0)
+    return 0;
+  result.copied += ret;
+  return (int)ret;
+}
+
+static int ReadMapped(int fd, unsigned char* buffer, int pageSize, int64_t position, int64_t length, Result& result)
+{
+  int64_t size = std::min((int64_t)MAPPED_BUFFER_SIZE, length - position);
+  if (size <= 0)
+    return 0;
+
+  int offset = (int)(position % pageSize);
+  if (offset == 0)
+  {
+    size_t mapped = (size_t)((size + pageSize - 1) / pageSize * pageSize);
+    if (mmap(buffer, mapped, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_FIXED, fd, (off_t)position) != MAP_FAILED)
+    {
+      madvise(buffer, mapped, MADV_SEQUENTIAL);
+      return (int)size;
+    }
+    perror("mmap");
+    exit(1);
+  }
+
+  // after a seek, up to the next page
+  size = std::min(size, (int64_t)(pageSize - offset));
+  ssize_t ret = pread(fd, buffer, (size_t)size, (off_t)position);
+  if (ret <= 0)
+    return 0;
+  result.copied += ret;
+  return (int)ret;
+}
+
+static Result Run(const char* file, bool mapped, int seeks)
+{
+  Result result = { 0, 0, 0, 0 };
+  int fd = open(file, O_RDONLY);
+  struct stat st;
+  if (fd < 0 || fstat(fd, &st) != 0)
+  {
+    perror(file);
+    exit(1);
+  }
+  int64_t length = st.st_size;
+  int pageSize = (int)sysconf(_SC_PAGESIZE);
+
+  DropCache(fd);
+#ifdef __APPLE__
+  fcntl(fd, F_RDAHEAD, 1);
+#else
+  posix_fadvise(fd, 0, 0, POSIX_FADV_SEQUENTIAL);
+#endif
+
+  unsigned char* buffer = (unsigned char*)mmap(NULL, MAPPED_BUFFER_SIZE, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANON, -1, 0);
+  if (buffer == MAP_FAILED)
+  {
+    perror("mmap");
+    exit(1);
+  }
+
+  // with seeks, read an equal share of the file from each of seeks + 1 places, none page aligned
+  int passes = seeks + 1;
+  int64_t share = length / passes;
+
+  double start = Now();
+  for (int pass = 0; pass < passes; pass++)
+  {
+    int64_t position = pass * share;
+    if (pass && position % pageSize == 0)
+      position += 188;
+    int64_t end = pass == passes - 1 ? length : (pass + 1) * share;
+
+    while (position < end)
+    {
+      int ret = mapped ? ReadMapped(fd, buffer, pageSize, position, end, result)
+                       : ReadFile(fd, buffer, position, end, result);
+      if (ret <= 0)
+        break;
+      result.sum += Parse(buffer, ret);
+      result.read += ret;
+      position += ret;
+    }
+  }
+  result.seconds = Now() - start;
+
+  munmap(buffer, MAPPED_BUFFER_SIZE);
+  close(fd);
+  return result;
+}
+
+static void Report(const char* name, const Result& result, double duration)
+{
+  printf("%-7s read %10.1f MB in %6.2fs (%7.1f MB/s), copied %10.1f MB, %9.1f KB copied per second of media\n",
+         name, result.read / 1048576.0, result.seconds, result.seconds > 0 ? result.read / 1048576.0 / result.seconds : 0.0,
+         result.copied / 1048576.0, result.copied / 1024.0 / duration);
+}
+
+int main(int argc, char* argv[])
+{
+  if (argc < 3)
+  {
+    fprintf(stderr, "usage: %s <file> <duration of the media in seconds> [seeks]\n", argv[0]);
+    return 1;
+  }
+  const char* file = argv[1];
+  double duration = atof(argv[2]);
+  int seeks = argc > 3 ? atoi(argv[3]) : 0;
+  if (duration <= 0 || seeks < 0)
+  {
+    fprintf(stderr, "the duration must be positive, and seeks can't be negative\n");
+    return 1;
+  }
+
+  Result plain = Run(file, false, seeks);
+  Result mapped = Run(file, true, seeks);
+  if (plain.sum != mapped.sum)
+  {
+    fprintf(stderr, "the streams read different data\n");
+    return 1;
+  }
+
+  Report("file", plain, duration);
+  Report("mapped", mapped, duration);
+  return 0;
+}
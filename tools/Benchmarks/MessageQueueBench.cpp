@@ -0,0 +1,126 @@
+/*
+ *      Copyright (C) 2005-2010 Team XBMC
+ *      http://www.xbmc.org
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, write to
+ *  the Free Software Foundation, 675 Mass Ave, Cambridge, MA 02139, USA.
+ *  http://www.gnu.org/copyleft/gpl.html
+ *
+ */
+
+/*
+ * Passes demuxer packets from a producer thread to a consumer thread through the dvdplayer's
+ * message queue as it was (old/) and as it is, and prints the packets handed over per second.
+ *
+ *   MessageQueueBench [packets]
+ *
+ * Each queue is run with a consumer that keeps up and one that's busy decoding, and with and
+ * without control messages mixed in. Both queues are built against the same stand-ins for the
+ * locks and events (see stubs/), so only the queues themselves differ. The best of three runs
+ * is shown.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "DVDMessage.h"
+#include "utils/log.h"
+#include "MessageQueueBench.h"
+
+void CLog::Log(int loglevel, const char *format, ...)
+{
+}
+
+// the rest of DVDMessage.cpp isn't needed, and brings in most of the player
+
+CDVDMsgGeneralSynchronize::CDVDMsgGeneralSynchronize(DWORD timeout, DWORD sources) : CDVDMsg(GENERAL_SYNCHRONIZE)
+{
+  m_sources = sources;
+  m_objects = 0;
+  m_timeout = timeout;
+}
+
+void CDVDMsgGeneralSynchronize::Wait(volatile bool *abort, DWORD source)
+{
+}
+
+CDVDMsgDemuxerPacket::CDVDMsgDemuxerPacket(DemuxPacket* packet, bool drop) : CDVDMsg(DEMUXER_PACKET)
+{
+  m_packet = packet;
+  m_drop   = drop;
+}
+
+CDVDMsgDemuxerPacket::~CDVDMsgDemuxerPacket()
+{
+  delete m_packet;
+}
+
+#define RUNS 3
+
+static double Best(QueueResult (*run)(const QueueConfig &), const QueueConfig &config)
+{
+  double best = 0;
+  for (int i = 0; i < RUNS; i++)
+  {
+    QueueResult result = run(config);
+    if (result.received != config.packets)
+    {
+      fprintf(stderr, "only %u of %u packets came through\n", result.received, config.packets);
+      exit(1);
+    }
+    double rate = result.received / result.seconds;
+    if (rate > best)
+      best = rate;
+  }
+  return best;
+}
+
+int main(int argc, char *argv[])
+{
+  unsigned int packets = argc > 1 ? (unsigned int)atoi(argv[1]) : 200000;
+  if (packets == 0)
+  {
+    fprintf(stderr, "usage: %s [packets]\n", argv[0]);
+    return 1;
+  }
+
+  struct Scenario
+  {
+    const char   *name;
+    unsigned int  controlEvery;
+    unsigned int  decodeWork;
+  } scenarios[] =
+  {
+    { "keeping up",                   0,    0 },
+    { "keeping up, with control",   100,    0 },
+    { "decoding",                     0, 2000 },
+    { "decoding, with control",     100, 2000 },
+  };
+
+  printf("%-28s %14s %14s %8s\n", "consumer", "old packets/s", "new packets/s", "change");
+  for (size_t i = 0; i < sizeof(scenarios) / sizeof(scenarios[0]); i++)
+  {
+    QueueConfig config;
+    config.packets      = packets;
+    config.packetSize   = 4096;
+    config.maxDataSize  = 4096 * 256;
+    config.controlEvery = scenarios[i].controlEvery;
+    config.decodeWork   = scenarios[i].decodeWork;
+
+    double oldRate = Best(RunOldQueue, config);
+    double newRate = Best(RunNewQueue, config);
+    printf("%-28s %14.0f %14.0f %+7.1f%%\n", scenarios[i].name, oldRate, newRate, (newRate / oldRate - 1.0) * 100.0);
+  }
+  return 0;
+}
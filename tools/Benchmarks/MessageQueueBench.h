@@ -0,0 +1,23 @@
+#pragma once
+
+/*
+ * What MessageQueueBench asks of each queue, and what it gets back.
+ */
+
+struct QueueConfig
+{
+  unsigned int packets;       // packets to pass through the queue
+  int          packetSize;    // bytes each packet counts for
+  int          maxDataSize;   // the producer rests while the queue holds more than this
+  unsigned int controlEvery;  // a prioritized control message every so many packets, 0 for none
+  unsigned int decodeWork;    // busy loop iterations per message on the consumer side
+};
+
+struct QueueResult
+{
+  double       seconds;
+  unsigned int received;
+};
+
+QueueResult RunOldQueue(const QueueConfig &config);
+QueueResult RunNewQueue(const QueueConfig &config);
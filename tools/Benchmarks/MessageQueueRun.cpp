@@ -0,0 +1,117 @@
+/*
+ *      Copyright (C) 2005-2010 Team XBMC
+ *      http://www.xbmc.org
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, write to
+ *  the Free Software Foundation, 675 Mass Ave, Cambridge, MA 02139, USA.
+ *  http://www.gnu.org/copyleft/gpl.html
+ *
+ */
+
+/*
+ * One producer/consumer run through a CDVDMessageQueue. Built twice by the Makefile: once
+ * against the current queue as RunNewQueue(), once against old/ as RunOldQueue().
+ */
+
+#include <sys/time.h>
+#include <pthread.h>
+#include <unistd.h>
+
+#include "DVDMessageQueue.h"
+#include "MessageQueueBench.h"
+
+namespace
+{
+  struct Run
+  {
+    CDVDMessageQueue *queue;
+    const QueueConfig *config;
+    unsigned int received;
+  };
+
+  double Now()
+  {
+    struct timeval tv;
+    gettimeofday(&tv, NULL);
+    return tv.tv_sec + tv.tv_usec / 1000000.0;
+  }
+
+  // the player thread: packets, now and then a control message, and a rest when the queue is full
+  void *Produce(void *arg)
+  {
+    Run *run = (Run *)arg;
+    const QueueConfig &config = *run->config;
+    for (unsigned int i = 0; i < config.packets; i++)
+    {
+      while (run->queue->GetDataSize() > config.maxDataSize)
+        usleep(1000);
+
+      DemuxPacket *packet = new DemuxPacket;
+      packet->pData = NULL;
+      packet->iSize = config.packetSize;
+      packet->iStreamId = 0;
+      packet->iGroupId = 0;
+      packet->pts = packet->dts = i * 40000.0;
+      packet->duration = 40000.0;
+      run->queue->Put(new CDVDMsgDemuxerPacket(packet));
+
+      if (config.controlEvery && i % config.controlEvery == 0)
+        run->queue->Put(new CDVDMsgGeneralResync(packet->pts, false), 1);
+    }
+    return NULL;
+  }
+
+  // the decoder thread, which only counts the packets
+  void *Consume(void *arg)
+  {
+    Run *run = (Run *)arg;
+    const QueueConfig &config = *run->config;
+    volatile unsigned int work = 0;
+    while (run->received < config.packets)
+    {
+      CDVDMsg *msg;
+      if (run->queue->Get(&msg, 1000) != MSGQ_OK)
+        break;
+      if (msg->IsType(CDVDMsg::DEMUXER_PACKET))
+        run->received++;
+      msg->Release();
+
+      for (unsigned int i = 0; i < config.decodeWork; i++)
+        work++;
+    }
+    return NULL;
+  }
+}
+
+QueueResult RUN_FUNCTION(const QueueConfig &config)
+{
+  CDVDMessageQueue queue("bench");
+  queue.SetMaxDataSize(config.maxDataSize);
+  queue.Init();
+
+  Run run = { &queue, &config, 0 };
+
+  double start = Now();
+  pthread_t producer, consumer;
+  pthread_create(&consumer, NULL, Consume, &run);
+  pthread_create(&producer, NULL, Produce, &run);
+  pthread_join(producer, NULL);
+  pthread_join(consumer, NULL);
+
+  QueueResult result;
+  result.seconds = Now() - start;
+  result.received = run.received;
+  queue.End();
+  return result;
+}
@@ -0,0 +1,185 @@
+/*
+ *      Copyright (C) 2005-2010 Team XBMC
+ *      http://www.xbmc.org
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, write to
+ *  the Free Software Foundation, 675 Mass Ave, Cambridge, MA 02139, USA.
+ *  http://www.gnu.org/copyleft/gpl.html
+ *
+ */
+
+/*
+ * Runs CPCMRemap::Remap() over every pair of stereo, 5.1 and 7.1 layouts with each remap it
+ * has on this machine: scalar, then SSE2 or NEON. Prints the frames remapped per second, and
+ * the largest difference from the scalar output in LSBs.
+ *
+ *   PCMRemapBench [seconds of audio per run] [gain]
+ *
+ * PCMRemap.cpp is built as it is, against stand-ins for CPUInfo.h and GUISettings.h (see
+ * stubs/) that let us pick the CPU features it sees. The speaker layout is 7.1, so every
+ * output channel is used, and the levels are normalized as they are by default.
+ */
+
+#include <sys/time.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <vector>
+
+#include "PCMRemap.h"
+#include "utils/CPUInfo.h"
+#include "utils/log.h"
+#include "GUISettings.h"
+
+CCPUInfo     g_cpuInfo;
+CGUISettings g_guiSettings;
+
+void CLog::Log(int loglevel, const char *format, ...)
+{
+}
+
+#define SAMPLE_RATE 48000
+
+// exposes which remap was picked
+class CBenchRemap : public CPCMRemap
+{
+public:
+  const char *GetKernelName() const { return m_kernelName; }
+};
+
+struct Layout
+{
+  const char       *name;
+  unsigned int      channels;
+  enum PCMChannels  map[8];
+};
+
+static Layout layouts[] =
+{
+  { "2.0", 2, { PCM_FRONT_LEFT, PCM_FRONT_RIGHT } },
+  { "5.1", 6, { PCM_FRONT_LEFT, PCM_FRONT_RIGHT, PCM_FRONT_CENTER, PCM_LOW_FREQUENCY, PCM_BACK_LEFT, PCM_BACK_RIGHT } },
+  { "7.1", 8, { PCM_FRONT_LEFT, PCM_FRONT_RIGHT, PCM_FRONT_CENTER, PCM_LOW_FREQUENCY, PCM_BACK_LEFT, PCM_BACK_RIGHT, PCM_SIDE_LEFT, PCM_SIDE_RIGHT } },
+};
+#define LAYOUTS (sizeof(layouts) / sizeof(layouts[0]))
+
+static double Now()
+{
+  struct timeval tv;
+  gettimeofday(&tv, NULL);
+  return tv.tv_sec + tv.tv_usec / 1000000.0;
+}
+
+/* remaps frames of in with the given CPU features, returns the frames remapped per second */
+static double Run(unsigned int features, const Layout &in, const Layout &out, float gain,
+                  const std::vector<int16_t> &input, std::vector<int16_t> &output, unsigned int frames,
+                  const char *&kernel)
+{
+  g_cpuInfo.m_cpuFeatures = features;
+
+  CBenchRemap remap;
+  remap.SetInputFormat(in.channels, (enum PCMChannels *)in.map, 2);
+  remap.SetOutputFormat(out.channels, (enum PCMChannels *)out.map);
+  remap.SetGain(gain);
+  kernel = remap.GetKernelName();
+
+  output.assign(frames * out.channels, 0);
+
+  // a second of audio at a time, as the renderers hand over far less than that
+  int runs = 0;
+  double start = Now();
+  double elapsed;
+  do
+  {
+    for (unsigned int done = 0; done < frames; done += SAMPLE_RATE)
+    {
+      unsigned int chunk = std::min((unsigned int)SAMPLE_RATE, frames - done);
+      remap.Remap((void *)&input[done * in.channels], &output[done * out.channels], chunk);
+    }
+    runs++;
+    elapsed = Now() - start;
+  } while (elapsed < 0.5);
+
+  return runs * (double)frames / elapsed;
+}
+
+int main(int argc, char *argv[])
+{
+  double seconds = argc > 1 ? atof(argv[1]) : 10.0;
+  float gain = argc > 2 ? (float)atof(argv[2]) : 1.0f;
+  if (seconds <= 0 || gain <= 0)
+  {
+    fprintf(stderr, "usage: %s [seconds of audio per run] [gain]\n", argv[0]);
+    return 1;
+  }
+  unsigned int frames = (unsigned int)(seconds * SAMPLE_RATE);
+
+  g_guiSettings.m_values["audiooutput.channellayout"] = PCM_LAYOUT_7_1;
+  g_guiSettings.m_values["audiooutput.dontnormalizelevels"] = 0;
+
+  // the remaps the compiler could build, scalar first as the reference
+  std::vector<unsigned int> features;
+  features.push_back(0);
+#ifdef HAS_SSE2_INTRINSICS
+  features.push_back(CPU_FEATURE_SSE2);
+#endif
+#ifdef HAS_NEON_INTRINSICS
+  features.push_back(CPU_FEATURE_NEON);
+#endif
+
+  // loud noise, so that downmixes clip now and then
+  std::vector<int16_t> input(frames * 8);
+  srand(1);
+  for (size_t i = 0; i < input.size(); i++)
+    input[i] = (int16_t)((rand() & 0xffff) - 0x8000);
+
+  printf("%-10s %-8s %14s %8s %9s\n", "layouts", "remap", "frames/s", "speedup", "max diff");
+
+  int worst = 0;
+  for (unsigned int i = 0; i < LAYOUTS; i++)
+  {
+    for (unsigned int o = 0; o < LAYOUTS; o++)
+    {
+      char pair[16];
+      snprintf(pair, sizeof(pair), "%s->%s", layouts[i].name, layouts[o].name);
+
+      std::vector<int16_t> reference, output;
+      double scalarRate = 0;
+      for (size_t f = 0; f < features.size(); f++)
+      {
+        const char *kernel;
+        double rate = Run(features[f], layouts[i], layouts[o], gain, input, f ? output : reference, frames, kernel);
+        if (f == 0)
+          scalarRate = rate;
+
+        int diff = 0;
+        if (f)
+        {
+          for (size_t s = 0; s < output.size(); s++)
+            diff = std::max(diff, abs((int)output[s] - (int)reference[s]));
+          worst = std::max(worst, diff);
+        }
+
+        printf("%-10s %-8s %14.0f %7.2fx %9d\n", pair, kernel, rate, rate / scalarRate, diff);
+      }
+    }
+  }
+
+  // the kernels round the same way, but sum in a different order
+  if (worst > 1)
+  {
+    fprintf(stderr, "remaps differ from the scalar one by up to %d LSBs\n", worst);
+    return 1;
+  }
+  return 0;
+}
@@ -0,0 +1,23 @@
+#pragma once
+
+/*
+ * Stands in for xbmc/GUISettings.h with the settings the benchmarks set themselves.
+ */
+
+#include <string>
+#include <map>
+
+class CGUISettings
+{
+public:
+  bool GetBool(const char *setting) const { return GetInt(setting) != 0; }
+  int  GetInt(const char *setting) const
+  {
+    std::map<std::string, int>::const_iterator i = m_values.find(setting);
+    return i == m_values.end() ? 0 : i->second;
+  }
+
+  std::map<std::string, int> m_values;
+};
+
+extern CGUISettings g_guiSettings;
@@ -0,0 +1,8 @@
+#pragma once
+
+/*
+ * Stands in for ffmpeg's avcodec.h, with just what the dvdplayer's headers refer to.
+ */
+
+enum CodecID { CODEC_ID_NONE };
+enum AVDiscard { AVDISCARD_NONE = -16, AVDISCARD_DEFAULT = 0 };
@@ -0,0 +1,94 @@
+#pragma once
+
+/*
+ * Stands in for xbmc/system.h and the Win32 API it brings in on Linux, with just the types
+ * and the events the dvdplayer's message queue uses, built straight on pthreads.
+ */
+
+#include <pthread.h>
+#include <stdint.h>
+#include <string.h>
+#include <errno.h>
+#include <sys/time.h>
+
+typedef uint32_t DWORD;
+typedef uint8_t  BYTE;
+typedef int64_t  __int64;
+
+#define WAIT_OBJECT_0 0
+#define WAIT_TIMEOUT  258L
+#define INFINITE      0xFFFFFFFF
+
+inline long InterlockedIncrement(long *value) { return __sync_add_and_fetch(value, 1); }
+inline long InterlockedDecrement(long *value) { return __sync_sub_and_fetch(value, 1); }
+
+struct CXEvent
+{
+  pthread_mutex_t mutex;
+  pthread_cond_t  cond;
+  bool            manualReset;
+  bool            signaled;
+};
+typedef CXEvent* HANDLE;
+
+inline HANDLE CreateEvent(void *, bool manualReset, bool initialState, const char *)
+{
+  HANDLE event = new CXEvent;
+  pthread_mutex_init(&event->mutex, NULL);
+  pthread_cond_init(&event->cond, NULL);
+  event->manualReset = manualReset;
+  event->signaled = initialState;
+  return event;
+}
+
+inline bool CloseHandle(HANDLE event)
+{
+  pthread_cond_destroy(&event->cond);
+  pthread_mutex_destroy(&event->mutex);
+  delete event;
+  return true;
+}
+
+inline bool SetEvent(HANDLE event)
+{
+  pthread_mutex_lock(&event->mutex);
+  event->signaled = true;
+  pthread_cond_broadcast(&event->cond);
+  pthread_mutex_unlock(&event->mutex);
+  return true;
+}
+
+inline bool ResetEvent(HANDLE event)
+{
+  pthread_mutex_lock(&event->mutex);
+  event->signaled = false;
+  pthread_mutex_unlock(&event->mutex);
+  return true;
+}
+
+inline DWORD WaitForSingleObject(HANDLE event, DWORD milliseconds)
+{
+  struct timeval now;
+  gettimeofday(&now, NULL);
+  struct timespec until;
+  uint64_t nsec = (uint64_t)now.tv_usec * 1000 + (uint64_t)(milliseconds % 1000) * 1000000;
+  until.tv_sec  = now.tv_sec + milliseconds / 1000 + nsec / 1000000000;
+  until.tv_nsec = nsec % 1000000000;
+
+  DWORD result = WAIT_OBJECT_0;
+  pthread_mutex_lock(&event->mutex);
+  while (!event->signaled)
+  {
+    int ret = milliseconds == INFINITE ? pthread_cond_wait(&event->cond, &event->mutex)
+                                       : pthread_cond_timedwait(&event->cond, &event->mutex, &until);
+    if (ret == ETIMEDOUT)
+    {
+      result = WAIT_TIMEOUT;
+      break;
+    }
+  }
+  if (result == WAIT_OBJECT_0 && !event->manualReset)
+    event->signaled = false;
+  pthread_mutex_unlock(&event->mutex);
+  return result;
+}
@@ -0,0 +1,30 @@
+#pragma once
+
+/*
+ * Stands in for xbmc/utils/CPUInfo.h, so that the benchmarks can say which CPU features
+ * the code under test may use. The feature bits and the intrinsics checks must match it.
+ */
+
+#define CPU_FEATURE_MMX      0x0001
+#define CPU_FEATURE_SSE      0x0002
+#define CPU_FEATURE_SSE2     0x0004
+#define CPU_FEATURE_SSE3     0x0008
+#define CPU_FEATURE_NEON     0x0010
+
+#if defined(__SSE2__) || (defined(_MSC_VER) && (defined(_M_IX86) || defined(_M_X64)))
+#define HAS_SSE2_INTRINSICS
+#endif
+#if defined(__ARM_NEON__)
+#define HAS_NEON_INTRINSICS
+#endif
+
+class CCPUInfo
+{
+public:
+  CCPUInfo() : m_cpuFeatures(0) {}
+  unsigned int GetCPUFeatures() const { return m_cpuFeatures; }
+
+  unsigned int m_cpuFeatures;
+};
+
+extern CCPUInfo g_cpuInfo;
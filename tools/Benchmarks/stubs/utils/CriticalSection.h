@@ -0,0 +1,28 @@
+#pragma once
+
+/*
+ * Stands in for xbmc/utils/CriticalSection.h: a recursive pthread mutex, which is what it
+ * is on Linux.
+ */
+
+#include <pthread.h>
+
+class CCriticalSection
+{
+public:
+  CCriticalSection()
+  {
+    pthread_mutexattr_t attr;
+    pthread_mutexattr_init(&attr);
+    pthread_mutexattr_settype(&attr, PTHREAD_MUTEX_RECURSIVE);
+    pthread_mutex_init(&m_mutex, &attr);
+    pthread_mutexattr_destroy(&attr);
+  }
+  ~CCriticalSection() { pthread_mutex_destroy(&m_mutex); }
+
+  void Enter() { pthread_mutex_lock(&m_mutex); }
+  void Leave() { pthread_mutex_unlock(&m_mutex); }
+
+private:
+  pthread_mutex_t m_mutex;
+};
@@ -0,0 +1,9 @@
+#pragma once
+
+/*
+ * Stands in for xbmc/utils/SharedSection.h, which the benchmarks only need to declare.
+ */
+
+class CSharedSection
+{
+};
@@ -0,0 +1,21 @@
+#pragma once
+
+/*
+ * Stands in for xbmc/utils/SingleLock.h.
+ */
+
+#include "CriticalSection.h"
+
+class CSingleLock
+{
+public:
+  CSingleLock(CCriticalSection &section) : m_section(section), m_locked(true) { m_section.Enter(); }
+  ~CSingleLock() { if (m_locked) m_section.Leave(); }
+
+  void Enter() { if (!m_locked) { m_section.Enter(); m_locked = true; } }
+  void Leave() { if (m_locked) { m_section.Leave(); m_locked = false; } }
+
+private:
+  CCriticalSection &m_section;
+  bool              m_locked;
+};
@@ -23,6 +23,7 @@
 #include <sys/stat.h>
 #include <dirent.h>
 #include <map>
+#include <algorithm>
 #include <squish.h>
 #include <string>
 #define __STDC_FORMAT_MACROS
@@ -51,6 +52,10 @@
 #define FLAGS_USE_LZO     1
 #define FLAGS_ALLOW_YCOCG 2
 
+#define ATLAS_PAGE_SIZE   1024
+#define ATLAS_MAX_IMAGE   128 // anything bigger in either direction is stored on its own
+#define ATLAS_PADDING     1   // edge pixels repeated around each image, so filtering doesn't reach its neighbours
+
 #undef main
 
 extern "C" 
@@ -216,9 +221,8 @@ void CompressImage(const squish::u8 *brga, int width, int height, squish::u8 *co
   squish::ComputeMSE(brga, width, height, compressed, flags | squish::kSourceBGRA, colorMSE, alphaMSE);
 }
 
-CXBTFFrame createXBTFFrame(SDL_Surface* image, CXBTFWriter& writer, double maxMSE, unsigned int flags)
+SDL_Surface* convertToARGB(SDL_Surface* image)
 {
-  // Convert to ARGB
   SDL_PixelFormat argbFormat;
   memset(&argbFormat, 0, sizeof(SDL_PixelFormat));
   argbFormat.BitsPerPixel = 32;
@@ -245,7 +249,12 @@ CXBTFFrame createXBTFFrame(SDL_Surface* image, CXBTFWriter& writer, double maxMS
   argbFormat.Bshift = 24;
 #endif
 
-  SDL_Surface *argbImage = SDL_ConvertSurface(image, &argbFormat, 0);
+  return SDL_ConvertSurface(image, &argbFormat, 0);
+}
+
+CXBTFFrame createXBTFFrame(SDL_Surface* image, CXBTFWriter& writer, double maxMSE, unsigned int flags)
+{
+  SDL_Surface *argbImage = convertToARGB(image);
 
   unsigned int format = 0;
   double colorMSE, alphaMSE;
@@ -317,6 +326,8 @@ void Usage()
   puts("Usage:");
   puts("  -help            Show this screen.");
   puts("  -dupecheck       Enable duplicate file detection. Reduces output file size.");
+  puts("  -pagealign       Start each frame on a page boundary, for faster loading from a mapped file.");
+  puts("  -atlas           Pack small images together into larger textures, so they can be drawn together.");
   puts("  -input <dir>     Input directory. Default: current dir");
   puts("  -output <dir>    Output directory/filename. Default: Textures.xpr");
 }
@@ -348,8 +359,110 @@ static bool checkDupe(struct MD5Context* ctx,
   return false;
 }
 
-int createBundle(const std::string& InputDir, const std::string& OutputFile, double maxMSE, unsigned int flags, bool dupecheck)
+struct AtlasImage
+{
+  unsigned int file;
+  SDL_Surface* argb;
+  unsigned int page;
+  unsigned int x;
+  unsigned int y;
+};
+
+static bool isTaller(const AtlasImage& a, const AtlasImage& b)
+{
+  return a.argb->h > b.argb->h;
+}
+
+// packs the images into pages, which are added to the end of the bundle
+void createAtlas(CXBTF& xbtf, CXBTFWriter& writer, vector<AtlasImage>& images, vector<unsigned int>& dupes, unsigned int flags)
 {
+  if (images.empty())
+    return;
+
+  // tallest first, filling the pages a shelf at a time from left to right
+  stable_sort(images.begin(), images.end(), isTaller);
+
+  vector<unsigned int> pageHeights;
+  unsigned int x = 0, y = 0, shelfHeight = 0;
+  for (size_t i = 0; i < images.size(); i++)
+  {
+    unsigned int width = images[i].argb->w + 2 * ATLAS_PADDING;
+    unsigned int height = images[i].argb->h + 2 * ATLAS_PADDING;
+    if (x + width > ATLAS_PAGE_SIZE)
+    {
+      x = 0;
+      y += shelfHeight;
+      shelfHeight = 0;
+    }
+    if (pageHeights.empty() || y + height > ATLAS_PAGE_SIZE)
+    {
+      pageHeights.push_back(0);
+      x = y = shelfHeight = 0;
+    }
+
+    images[i].page = pageHeights.size() - 1;
+    images[i].x = x + ATLAS_PADDING;
+    images[i].y = y + ATLAS_PADDING;
+
+    x += width;
+    shelfHeight = max(shelfHeight, height);
+    pageHeights.back() = y + shelfHeight;
+  }
+
+  std::vector<CXBTFFile>& files = xbtf.GetFiles();
+  vector<uint32_t> pixels;
+  for (unsigned int page = 0; page < pageHeights.size(); page++)
+  {
+    unsigned int pageHeight = pageHeights[page];
+    pixels.assign(ATLAS_PAGE_SIZE * pageHeight, 0);
+
+    unsigned int pageFile = files.size();
+    unsigned int count = 0;
+    for (size_t i = 0; i < images.size(); i++)
+    {
+      if (images[i].page != page)
+        continue;
+
+      SDL_Surface* argb = images[i].argb;
+      for (int row = -ATLAS_PADDING; row < argb->h + ATLAS_PADDING; row++)
+      {
+        int srcRow = min(max(row, 0), argb->h - 1);
+        const uint32_t* src = (const uint32_t*)((const uint8_t*)argb->pixels + srcRow * argb->pitch);
+        uint32_t* dest = &pixels[(images[i].y + row) * ATLAS_PAGE_SIZE + images[i].x];
+        for (int col = -ATLAS_PADDING; col < argb->w + ATLAS_PADDING; col++)
+          dest[col] = src[min(max(col, 0), argb->w - 1)];
+      }
+
+      files[images[i].file].GetFrames()[0].SetAtlas(pageFile, images[i].x, images[i].y);
+      count++;
+    }
+
+    char name[32];
+    sprintf(name, "__atlas__/page%u", page);
+    std::string output = name;
+    while (output.size() < 46)
+      output += ' ';
+    printf("%s", output.c_str());
+
+    CXBTFFile file;
+    file.SetPath(name);
+    file.SetLoop(0);
+    CXBTFFrame frame = appendContent(writer, ATLAS_PAGE_SIZE, pageHeight, (unsigned char*)&pixels[0], pixels.size() * 4, XB_FMT_A8R8G8B8, flags);
+    file.GetFrames().push_back(frame);
+    files.push_back(file);
+    dupes.push_back(pageFile);
+
+    printf("%s (%d,%d @ %"PRIu64" bytes, %u images)\n", GetFormatString(frame.GetFormat()), frame.GetWidth(), frame.GetHeight(), frame.GetUnpackedSize(), count);
+  }
+
+  for (size_t i = 0; i < images.size(); i++)
+    SDL_FreeSurface(images[i].argb);
+  images.clear();
+}
+
+int createBundle(const std::string& InputDir, const std::string& OutputFile, double maxMSE, unsigned int flags, bool dupecheck, unsigned int alignment, bool atlas)
+{
+  vector<AtlasImage> atlasImages;
   map<string,unsigned int> hashes;
   vector<unsigned int> dupes;
   CXBTF xbtf;
@@ -362,6 +475,7 @@ int createBundle(const std::string& InputDir, const std::string& OutputFile, dou
   }
 
   CXBTFWriter writer(xbtf, OutputFile);
+  writer.SetAlignment(alignment);
   if (!writer.Create())
   {
     printf("Error creating file\n");
@@ -407,7 +521,21 @@ int createBundle(const std::string& InputDir, const std::string& OutputFile, dou
         }
       }
 
-      if (!skip)
+      if (!skip && atlas && image->w > 0 && image->h > 0 && image->w <= ATLAS_MAX_IMAGE && image->h <= ATLAS_MAX_IMAGE)
+      { // written out with the rest of its atlas page once all the images are in
+        AtlasImage entry = { (unsigned int)i, convertToARGB(image), 0, 0, 0 };
+        atlasImages.push_back(entry);
+
+        CXBTFFrame frame;
+        frame.SetWidth(image->w);
+        frame.SetHeight(image->h);
+        frame.SetFormat(XB_FMT_A8R8G8B8);
+        printf("atlas (%d,%d)\n", frame.GetWidth(), frame.GetHeight());
+
+        file.SetLoop(0);
+        file.GetFrames().push_back(frame);
+      }
+      else if (!skip)
       {
         CXBTFFrame frame = createXBTFFrame(image, writer, maxMSE, flags);
 
@@ -461,6 +589,19 @@ int createBundle(const std::string& InputDir, const std::string& OutputFile, dou
     }
   }
 
+  if (atlasImages.size())
+  {
+    createAtlas(xbtf, writer, atlasImages, dupes, flags);
+
+    // duplicates took a copy of their original's frames before it had a place in the atlas
+    for (size_t i = 0; i < files.size(); i++)
+    {
+      std::vector<CXBTFFrame>& frames = files[dupes[i]].GetFrames();
+      if (dupes[i] != i && files[i].GetFrames().size() && frames.size() && frames[0].IsAtlased())
+        files[i].GetFrames() = frames;
+    }
+  }
+
   if (!writer.UpdateHeader(dupes))
   {
     printf("Error writing header to file\n");
@@ -483,6 +624,8 @@ int main(int argc, char* argv[])
 
   bool valid = false;
   bool dupecheck = false;
+  unsigned int alignment = 1;
+  bool atlas = false;
   CmdLineArgs args(argc, (const char**)argv);
 
   if (args.size() == 1)
@@ -508,6 +651,10 @@ int main(int argc, char* argv[])
     }
     else if (!strcmp(args[i], "-dupecheck"))
       dupecheck = true;
+    else if (!strcmp(args[i], "-pagealign"))
+      alignment = 4096;
+    else if (!strcmp(args[i], "-atlas"))
+      atlas = true;
     else if (!stricmp(args[i], "-output") || !stricmp(args[i], "-o"))
     {
       OutputFilename = args[++i];
@@ -535,5 +682,5 @@ int main(int argc, char* argv[])
 
   double maxMSE = 1.5;    // HQ only please
   unsigned int flags = FLAGS_USE_LZO; // TODO: currently no YCoCg (commandline option?)
-  createBundle(InputDir, OutputFilename, maxMSE, flags, dupecheck);
+  createBundle(InputDir, OutputFilename, maxMSE, flags, dupecheck, alignment, atlas);
 }
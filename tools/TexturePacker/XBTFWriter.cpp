@@ -23,6 +23,7 @@
 #include "EndianSwap.h"
 #define __STDC_FORMAT_MACROS
 #include <inttypes.h>
+#include <algorithm>
 
 #define TEMP_FILE "temp.xbt"
 #define TEMP_SIZE (10*1024*1024)
@@ -35,6 +36,8 @@ CXBTFWriter::CXBTFWriter(CXBTF& xbtf, const std::string& outputFile) : m_xbtf(xb
 {
   m_outputFile = outputFile;
   m_file = m_tempFile = NULL;
+  m_alignment = 1;
+  m_contentSize = 0;
 }
 
 bool CXBTFWriter::Create()
@@ -68,6 +71,13 @@ bool CXBTFWriter::Close()
     return false;
   }
 
+  // the content starts at an aligned offset, as the frame offsets in the header assume
+  uint64_t headerSize = m_xbtf.GetHeaderSize();
+  if (!WritePadding(m_file, Align(headerSize) - headerSize))
+  {
+    return false;
+  }
+
   unsigned char* tmp = new unsigned char[10*1024*1024];
   size_t bytesRead;
   while ((bytesRead = fread(tmp, 1, TEMP_SIZE, m_tempFile)) > 0)
@@ -90,7 +100,30 @@ bool CXBTFWriter::AppendContent(unsigned char const* data, size_t length)
     return false;
   }
 
+  if (!WritePadding(m_tempFile, Align(m_contentSize) - m_contentSize))
+  {
+    return false;
+  }
+  m_contentSize = Align(m_contentSize);
+
   fwrite(data, length, 1, m_tempFile);
+  m_contentSize += length;
+
+  return true;
+}
+
+bool CXBTFWriter::WritePadding(FILE* file, uint64_t size)
+{
+  static const unsigned char zeros[4096] = { 0 };
+  while (size > 0)
+  {
+    size_t chunk = (size_t)std::min(size, (uint64_t)sizeof(zeros));
+    if (fwrite(zeros, chunk, 1, file) != 1)
+    {
+      return false;
+    }
+    size -= chunk;
+  }
 
   return true;
 }
@@ -102,10 +135,11 @@ bool CXBTFWriter::UpdateHeader(const std::vector<unsigned int>& dupes)
     return false;
   }
 
-  uint64_t offset = m_xbtf.GetHeaderSize();
+  uint64_t offset = Align(m_xbtf.GetHeaderSize());
 
   WRITE_STR(XBTF_MAGIC, 4, m_file);
-  WRITE_STR(XBTF_VERSION, 1, m_file);
+  char version = m_xbtf.GetVersion();
+  WRITE_STR(&version, 1, m_file);
 
   std::vector<CXBTFFile>& files = m_xbtf.GetFiles();
   WRITE_U32(files.size(), m_file);
@@ -129,10 +163,13 @@ bool CXBTFWriter::UpdateHeader(const std::vector<unsigned int>& dupes)
     for (size_t j = 0; j < frames.size(); j++)
     {
       CXBTFFrame& frame = frames[j];
-      if (dupes[i] != i)
+      if (frame.IsAtlased())
+        frame.SetOffset(0); // the content is in the atlas page
+      else if (dupes[i] != i)
         frame.SetOffset(files[dupes[i]].GetFrames()[j].GetOffset());
       else
       {
+        offset = Align(offset);
         frame.SetOffset(offset);
         offset += frame.GetPackedSize();
       }
@@ -144,6 +181,12 @@ bool CXBTFWriter::UpdateHeader(const std::vector<unsigned int>& dupes)
       WRITE_U64(frame.GetUnpackedSize(), m_file);
       WRITE_U32(frame.GetDuration(), m_file);
       WRITE_U64(frame.GetOffset(), m_file);
+      if (version >= '3')
+      {
+        WRITE_U32(frame.GetAtlasFile(), m_file);
+        WRITE_U32(frame.GetAtlasX(), m_file);
+        WRITE_U32(frame.GetAtlasY(), m_file);
+      }
     }
   }
 
@@ -36,11 +36,19 @@ public:
   bool AppendContent(unsigned char const* data, size_t length);
   bool UpdateHeader(const std::vector<unsigned int>& dupes);
 
+  // start each frame on a multiple of alignment bytes, so it can be mapped on its own pages
+  void SetAlignment(unsigned int alignment) { m_alignment = alignment ? alignment : 1; }
+
 private:
+  uint64_t Align(uint64_t offset) const { return (offset + m_alignment - 1) / m_alignment * m_alignment; }
+  bool WritePadding(FILE* file, uint64_t size);
+
   CXBTF& m_xbtf;
   std::string m_outputFile;
   FILE* m_file;
   FILE* m_tempFile;
+  unsigned int m_alignment;
+  uint64_t m_contentSize;
 };
 
 #endif
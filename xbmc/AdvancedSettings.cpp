@@ -93,6 +93,7 @@ void CAdvancedSettings::Initialize()
   m_videoNonLinStretchRatio = 0.5f;
   m_videoAllowLanczos3 = false;
   m_videoAllowMpeg4VDPAU = false;
+  m_videoMapLocalFiles = true;
   m_DXVACheckCompatibility = false;
   m_DXVACheckCompatibilityPresent = false;
 
@@ -174,7 +175,7 @@ void CAdvancedSettings::Initialize()
 
   m_thumbSize = DEFAULT_THUMB_SIZE;
   m_fanartHeight = DEFAULT_FANART_HEIGHT;
-  m_useDDSFanart = false;
+  m_useDDSFanart = true;
 
   m_sambaclienttimeout = 10;
   m_sambadoscodepage = "";
@@ -235,6 +236,7 @@ void CAdvancedSettings::Initialize()
   m_curlconnecttimeout = 10;
   m_curllowspeedtime = 20;
   m_curlretries = 2;
+  m_curlRangeConnections = 0;
   m_curlDisableIPV6 = false;      //Certain hardware/OS combinations have trouble
                                   //with ipv6.
 
@@ -263,6 +265,8 @@ void CAdvancedSettings::Initialize()
   m_bEnableKeyboardBacklightControl = false;
   
   m_bEnablePlexTokensInLogs = false;
+  m_plexPageSize = 250;
+  m_plexRequestsPerServer = 2;
   
 //caused lots of jerks
 //#ifdef _WIN32
@@ -282,10 +286,17 @@ void CAdvancedSettings::Initialize()
 #endif
 
   m_bgInfoLoaderMaxThreads = 5;
+  m_jobWorkers = 0;
+  m_largeTextureBudget = 64;
+  m_guiDirtyRegions = 0;
+  m_guiVisualizeDirtyRegions = false;
+  m_guiSkinCache = true;
 
   m_measureRefreshrate = false;
 
   m_cacheMemBufferSize = (1048576 * 5);
+  m_cacheSpillSize = 0;
+  m_cacheReadAheadTime = 20;
 }
 
 bool CAdvancedSettings::Load()
@@ -440,6 +451,7 @@ bool CAdvancedSettings::Load()
     XMLUtils::GetFloat(pElement, "nonlinearstretchratio", m_videoNonLinStretchRatio, 0.01f, 1.0f);
     XMLUtils::GetBoolean(pElement,"allowlanczos3",m_videoAllowLanczos3);
     XMLUtils::GetBoolean(pElement,"allowmpeg4vdpau",m_videoAllowMpeg4VDPAU);
+    XMLUtils::GetBoolean(pElement,"maplocalfiles",m_videoMapLocalFiles);
 
     m_DXVACheckCompatibilityPresent = XMLUtils::GetBoolean(pElement,"checkdxvacompatibility", m_DXVACheckCompatibility);
 
@@ -513,8 +525,11 @@ bool CAdvancedSettings::Load()
     XMLUtils::GetInt(pElement, "curlclienttimeout", m_curlconnecttimeout, 1, 1000);
     XMLUtils::GetInt(pElement, "curllowspeedtime", m_curllowspeedtime, 1, 1000);
     XMLUtils::GetInt(pElement, "curlretries", m_curlretries, 0, 10);
+    XMLUtils::GetInt(pElement, "curlrangeconnections", m_curlRangeConnections, 0, 8);
     XMLUtils::GetBoolean(pElement,"disableipv6", m_curlDisableIPV6);
     XMLUtils::GetUInt(pElement, "cachemembuffersize", m_cacheMemBufferSize);
+    XMLUtils::GetUInt(pElement, "cachespillsize", m_cacheSpillSize);
+    XMLUtils::GetUInt(pElement, "cachereadaheadtime", m_cacheReadAheadTime);
   }
 
   pElement = pRootElement->FirstChildElement("samba");
@@ -575,6 +590,8 @@ bool CAdvancedSettings::Load()
   XMLUtils::GetBoolean(pRootElement, "enableviewrestrictions", m_bEnableViewRestrictions);
   XMLUtils::GetBoolean(pRootElement, "enablekeyboardbacklightcontrol", m_bEnableKeyboardBacklightControl);
   XMLUtils::GetBoolean(pRootElement, "enableplextokensinlogs", m_bEnablePlexTokensInLogs);
+  XMLUtils::GetInt(pRootElement, "plexpagesize", m_plexPageSize, 0, 100000);
+  XMLUtils::GetInt(pRootElement, "plexrequestsperserver", m_plexRequestsPerServer, 1, 16);
 
   XMLUtils::GetBoolean(pRootElement,"rootovershoot",m_bUseEvilB);
   XMLUtils::GetBoolean(pRootElement,"glrectanglehack", m_GLRectangleHack);
@@ -780,6 +797,11 @@ bool CAdvancedSettings::Load()
 
   XMLUtils::GetInt(pRootElement, "bginfoloadermaxthreads", m_bgInfoLoaderMaxThreads);
   m_bgInfoLoaderMaxThreads = std::max(1, m_bgInfoLoaderMaxThreads);
+  XMLUtils::GetInt(pRootElement, "jobworkers", m_jobWorkers, 0, 32);
+  XMLUtils::GetInt(pRootElement, "largetexturebudget", m_largeTextureBudget, 0, 1024);
+  XMLUtils::GetInt(pRootElement, "algorithmdirtyregions", m_guiDirtyRegions, 0, 2);
+  XMLUtils::GetBoolean(pRootElement, "visualizedirtyregions", m_guiVisualizeDirtyRegions);
+  XMLUtils::GetBoolean(pRootElement, "skincache", m_guiSkinCache);
 
   XMLUtils::GetBoolean(pRootElement, "measurerefreshrate", m_measureRefreshrate);
 
@@ -110,6 +110,7 @@ class CAdvancedSettings
     float m_videoNonLinStretchRatio;
     bool  m_videoAllowLanczos3;
     bool  m_videoAllowMpeg4VDPAU;
+    bool  m_videoMapLocalFiles; // demux files on fixed local disks straight from their pages in the page cache
     bool m_DXVACheckCompatibility;
     bool m_DXVACheckCompatibilityPresent;
 
@@ -232,6 +233,7 @@ class CAdvancedSettings
     int m_curlconnecttimeout;
     int m_curllowspeedtime;
     int m_curlretries;
+    int m_curlRangeConnections; // most connections a stream is fetched over at once, 0 for a single one
     bool m_curlDisableIPV6;
 
     bool m_fullScreen;
@@ -263,6 +265,11 @@ class CAdvancedSettings
     CStdString m_cpuTempCmd;
     CStdString m_gpuTempCmd;
     int m_bgInfoLoaderMaxThreads;
+    int m_jobWorkers; // 0 sizes the job manager from the number of CPUs
+    int m_largeTextureBudget; // MiB of large textures kept around once unused
+    int m_guiDirtyRegions; // CDirtyRegionTracker::ALGORITHM, 0 redraws everything every frame
+    bool m_guiVisualizeDirtyRegions; // tint what changed each frame
+    bool m_guiSkinCache; // keep resolved skin windows in special://temp/skincache
 
     bool m_measureRefreshrate; //when true the videoreferenceclock will measure the refreshrate when direct3d is used
                                //otherwise it will use the windows refreshrate
@@ -271,6 +278,8 @@ class CAdvancedSettings
     DatabaseSettings m_databaseVideo; // advanced video database setup
 
     unsigned int m_cacheMemBufferSize;
+    unsigned int m_cacheSpillSize; // bytes of the stream cache that may go to a temp file, 0 to keep it in memory
+    unsigned int m_cacheReadAheadTime; // seconds of the stream to read ahead, 0 to always read cachemembuffersize ahead
   
     int m_secondsToVisualizer;
     bool m_bVisualizerOnPlay;
@@ -282,6 +291,8 @@ class CAdvancedSettings
     bool m_bEnableViewRestrictions;
     bool m_bEnableKeyboardBacklightControl;
     bool m_bEnablePlexTokensInLogs;
+    int m_plexPageSize;
+    int m_plexRequestsPerServer;
   
     CStdString m_language;
     CStdString m_units;
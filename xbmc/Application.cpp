@@ -45,6 +45,7 @@
 #include "GUIFontManager.h"
 #include "GUIColorManager.h"
 #include "GUITextLayout.h"
+#include "GUITexture.h"
 #include "addons/Skin.h"
 #ifdef HAS_PYTHON
 #include "lib/libPython/XBPython.h"
@@ -75,6 +76,7 @@
 #include "utils/TimeUtils.h"
 #include "GUILargeTextureManager.h"
 #include "TextureCache.h"
+#include "SkinWarmupJob.h"
 #include "LastFmManager.h"
 #include "SmartPlaylist.h"
 #ifdef HAS_FILESYSTEM_RAR
@@ -260,6 +262,7 @@
 
 #include "MediaManager.h"
 #include "utils/JobManager.h"
+#include "utils/Stopwatch.h"
 #include "utils/AlarmClock.h"
 
 #ifdef _LINUX
@@ -1176,6 +1179,8 @@ bool CApplication::Initialize()
   {
     g_windowManager.ActivateWindow(g_SkinInfo->GetFirstWindow());
   }
+  // whatever the skin warmup decoded that the window didn't load isn't needed
+  g_TextureManager.ClearPreloaded();
 
   g_sysinfo.Refresh();
 
@@ -1557,6 +1562,13 @@ bool CApplication::LoadSkin(const CStdString& skinID)
   return false;
 }
 
+// adds the time since the last step to the skin loading report and starts timing the next
+static void EndLoadPhase(CStopWatch &timer, CStdString &report, const char *phase)
+{
+  report.AppendFormat("%s%s %.1fms", report.IsEmpty() ? "" : ", ", phase, timer.GetElapsedMilliseconds());
+  timer.StartZero();
+}
+
 void CApplication::LoadSkin(const SkinPtr& skin)
 {
   if (!skin)
@@ -1585,6 +1597,11 @@ void CApplication::LoadSkin(const SkinPtr& skin)
     }
 #endif
   }
+  CStopWatch totalTimer, phaseTimer;
+  CStdString report;
+  totalTimer.StartZero();
+  phaseTimer.StartZero();
+
   // close the music and video overlays (they're re-opened automatically later)
   CSingleLock lock(g_graphicsContext);
 
@@ -1594,6 +1611,7 @@ void CApplication::LoadSkin(const SkinPtr& skin)
   g_windowManager.GetActiveModelessWindows(currentModelessWindows);
 
   UnloadSkin();
+  EndLoadPhase(phaseTimer, report, "unload");
 
   CLog::Log(LOGINFO, "  load skin from:%s", skin->Path().c_str());
   g_SkinInfo = skin;
@@ -1602,6 +1620,9 @@ void CApplication::LoadSkin(const SkinPtr& skin)
   CLog::Log(LOGINFO, "  load fonts for skin...");
   g_graphicsContext.SetMediaDir(skin->Path());
   g_directoryCache.ClearSubPaths(skin->Path());
+
+  // the home window's textures are decoded on the job workers while we load everything else
+  CJobManager::GetInstance().AddJob(new CSkinWarmupJob(skin), NULL, CJob::PRIORITY_HIGH);
   if (g_langInfo.ForceUnicodeFont() && !g_fontManager.IsFontSetUnicode(g_guiSettings.GetString("lookandfeel.font")))
   {
     CLog::Log(LOGINFO, "    language needs a ttf font, loading first ttf font available");
@@ -1618,6 +1639,10 @@ void CApplication::LoadSkin(const SkinPtr& skin)
   g_colorManager.Load(g_guiSettings.GetString("lookandfeel.skincolors"));
 
   g_fontManager.LoadFonts(g_guiSettings.GetString("lookandfeel.font"));
+  EndLoadPhase(phaseTimer, report, "fonts");
+
+  g_fontManager.CacheCommonGlyphs();
+  EndLoadPhase(phaseTimer, report, "glyphs");
 
   // load in the skin strings
   CStdString langPath, skinEnglishPath;
@@ -1630,9 +1655,7 @@ void CApplication::LoadSkin(const SkinPtr& skin)
   CUtil::AddFileToFolder(skinEnglishPath, "strings.xml", skinEnglishPath);
 
   g_localizeStrings.LoadSkinStrings(langPath, skinEnglishPath);
-
-  int64_t start;
-  start = CurrentHostCounter();
+  EndLoadPhase(phaseTimer, report, "strings");
 
   CLog::Log(LOGINFO, "  load new skin...");
   CGUIWindowHome *pHome = (CGUIWindowHome *)g_windowManager.GetWindow(WINDOW_HOME);
@@ -1651,11 +1674,7 @@ void CApplication::LoadSkin(const SkinPtr& skin)
 
   // Load the user windows
   LoadUserWindows();
-
-  int64_t end, freq;
-  end = CurrentHostCounter();
-  freq = CurrentHostFrequency();
-  CLog::Log(LOGDEBUG,"Load Skin XML: %.2fms", 1000.f * (end - start) / freq);
+  EndLoadPhase(phaseTimer, report, "windows");
 
   CLog::Log(LOGINFO, "  initialize new skin...");
   m_guiPointer.AllocResources(true);
@@ -1675,8 +1694,9 @@ void CApplication::LoadSkin(const SkinPtr& skin)
 
   if (g_SkinInfo->HasSkinFile("DialogFullScreenInfo.xml"))
     g_windowManager.Add(new CGUIDialogFullScreenInfo);
+  EndLoadPhase(phaseTimer, report, "initialize");
 
-  CLog::Log(LOGINFO, "  skin loaded...");
+  CLog::Log(LOGINFO, "  skin loaded in %.1fms (%s)", totalTimer.GetElapsedMilliseconds(), report.c_str());
 
   // leave the graphics lock
   lock.Leave();
@@ -1690,6 +1710,7 @@ void CApplication::LoadSkin(const SkinPtr& skin)
       CGUIDialog *dialog = (CGUIDialog *)g_windowManager.GetWindow(currentModelessWindows[i]);
       if (dialog) dialog->Show();
     }
+    g_TextureManager.ClearPreloaded();
   }
 
   if (g_application.m_pPlayer && g_application.IsPlayingVideo())
@@ -1828,6 +1849,9 @@ void CApplication::RenderNoPresent()
 {
   MEASURE_FUNCTION;
 
+  // pick up window and player changes made since the last frame
+  g_infoManager.UpdateCache();
+
 // DXMERGE: This might have been important (do we allow the vsync mode to change
 //          while not updating the UI setting?
 //  int vsync_mode = g_videoConfig.GetVSyncMode();
@@ -1903,7 +1927,7 @@ void CApplication::RenderNoPresent()
   // reset our info cache - we do this at the end of Render so that it is
   // fresh for the next process(), or after a windowclose animation (where process()
   // isn't called)
-  g_infoManager.ResetCache();
+  g_infoManager.ResetFrameCache();
 }
 
 static int screenSaverFadeAmount = 0;
@@ -2014,6 +2038,7 @@ void CApplication::Render()
   MEASURE_FUNCTION;
 
   bool decrement = false;
+  static bool lastFramePresented = true;
 
   { // frame rate limiter (really bad, but it does the trick :p)
     static unsigned int lastFrameTime = 0;
@@ -2074,8 +2099,9 @@ void CApplication::Render()
     }
     else
     {
-      // engage the frame limiter as needed
-      bool limitFrames = lowfps || extPlayerActive;
+      // engage the frame limiter as needed.  Vsync doesn't hold us back when
+      // nothing changed and we don't present, so we keep the pace ourselves.
+      bool limitFrames = lowfps || extPlayerActive || !lastFramePresented;
       // DXMERGE - we checked for g_videoConfig.GetVSyncMode() before this
       //           perhaps allowing it to be set differently than the UI option??
       if (g_guiSettings.GetInt("videoscreen.vsync") == VSYNC_DISABLED ||
@@ -2093,6 +2119,8 @@ void CApplication::Render()
         }
         else if (lowfps)
           singleFrameTime = 200;  // 5 fps, <=200 ms latency to wake up
+        else if (!lastFramePresented)
+          singleFrameTime = 40;   // 25 fps while idle, good enough to notice the next change
 
         if (lastFrameTime + singleFrameTime > currentTime)
           nDelayTime = lastFrameTime + singleFrameTime - currentTime;
@@ -2108,9 +2136,29 @@ void CApplication::Render()
   if(!g_Windowing.BeginRender())
     return;
 
+  // only draw what changed, if we know what that is
+  CDirtyRegionTracker &dirtyRegions = g_graphicsContext.GetDirtyRegions();
+  CRect screen(0, 0, (float)g_graphicsContext.GetWidth(), (float)g_graphicsContext.GetHeight());
+  CRect redraw = dirtyRegions.BeginFrame(g_advancedSettings.m_guiDirtyRegions, screen, g_graphicsContext.IsFullScreenVideo());
+  if (redraw != screen)
+    g_graphicsContext.SetScissors(redraw);
+
   RenderNoPresent();
+  dirtyRegions.EndFrame();
+
+  if (g_advancedSettings.m_guiVisualizeDirtyRegions)
+  {
+    const CDirtyRegionList &regions = dirtyRegions.GetDirtyRegions();
+    for (unsigned int i = 0; i < regions.size(); i++)
+      CGUITexture::DrawQuad(regions[i], 0x3fff0000);
+  }
+
+  g_graphicsContext.ResetScissors();
   g_Windowing.EndRender();
-  g_graphicsContext.Flip();
+
+  lastFramePresented = dirtyRegions.NeedsPresent();
+  if (lastFramePresented)
+    g_graphicsContext.Flip();
   CTimeUtils::UpdateFrameTime();
   g_infoManager.UpdateFPS();
   g_graphicsContext.Unlock();
@@ -2186,6 +2234,9 @@ void CApplication::RenderMemoryStatus()
     info.Format("LOG: %splex.log\nMEM: %"PRIu64"/%"PRIu64" KB - FPS: %2.1f fps\nCPU: %s (CPU-XBMC %4.2f%%%s)", g_settings.m_logFolder.c_str(),
               stat.dwAvailPhys/1024, stat.dwTotalPhys/1024, g_infoManager.GetFPS(), strCores.c_str(), dCPU, profiling.c_str());
 #endif
+    info.AppendFormat("\nTEX: %u KB in %u textures (%u unused), %u lookups - LARGE: %u KB in %u images (%u queued), %u lookups",
+              g_TextureManager.GetMemoryUsage()/1024, g_TextureManager.GetTextureCount(), g_TextureManager.GetUnusedCount(), g_TextureManager.GetLookupCount(),
+              g_largeTextureManager.GetMemoryUsage()/1024, g_largeTextureManager.GetImageCount(), g_largeTextureManager.GetQueuedCount(), g_largeTextureManager.GetLookupCount());
 
 
     float x = xShift + 0.04f * g_graphicsContext.GetWidth() + g_settings.m_ResInfo[res].Overscan.left;
@@ -1335,6 +1335,9 @@ CFileItemList::CFileItemList()
   m_iBitrate = 0;
   m_autoRefresh = 0;
   m_defaultViewMode = 0;
+  m_pageSize = 0;
+  m_totalSize = 0;
+  m_pageEnd = 0;
 }
 
 CFileItemList::CFileItemList(const CStdString& strPath)
@@ -1354,6 +1357,9 @@ CFileItemList::CFileItemList(const CStdString& strPath)
   m_iBitrate = 0;
   m_autoRefresh = 0;
   m_defaultViewMode = 0;
+  m_pageSize = 0;
+  m_totalSize = 0;
+  m_pageEnd = 0;
 }
 
 CFileItemList::~CFileItemList()
@@ -1441,6 +1447,9 @@ void CFileItemList::Clear()
   m_displayMessageContents = "";
   m_iBitrate = 0;
   m_autoRefresh = 0;
+  m_pageSize = 0;
+  m_totalSize = 0;
+  m_pageEnd = 0;
 }
 
 void CFileItemList::ClearItems()
@@ -1556,6 +1565,9 @@ void CFileItemList::Assign(const CFileItemList& itemlist, bool append)
   m_displayMessageContents = itemlist.m_displayMessageContents;
   m_iBitrate = itemlist.m_iBitrate;
   m_autoRefresh = itemlist.m_autoRefresh;
+  m_pageSize = itemlist.m_pageSize;
+  m_totalSize = itemlist.m_totalSize;
+  m_pageEnd = itemlist.m_pageEnd;
 }
 
 bool CFileItemList::Copy(const CFileItemList& items)
@@ -1582,6 +1594,9 @@ bool CFileItemList::Copy(const CFileItemList& items)
   m_displayMessageTitle = items.m_displayMessageTitle;
   m_displayMessageContents = items.m_displayMessageContents;
   m_autoRefresh = items.m_autoRefresh;
+  m_pageSize = items.m_pageSize;
+  m_totalSize = items.m_totalSize;
+  m_pageEnd = items.m_pageEnd;
   
   // make a copy of each item
   for (int i = 0; i < items.Size(); i++)
@@ -549,6 +549,14 @@ public:
   CStdString m_displayMessageTitle;
   CStdString m_displayMessageContents;
   int m_autoRefresh;
+  
+  // PLEX: Paged listings. m_pageSize asks the source for only the first page (0 means everything),
+  // m_totalSize/m_pageEnd say how much the server has and how far we've got.
+  //
+  int m_pageSize;
+  int m_totalSize;
+  int m_pageEnd;
+  bool HasMorePages() const { return m_totalSize > m_pageEnd; }
 private:
   void Sort(FILEITEMLISTCOMPARISONFUNC func);
   void FillSortFields(FILEITEMFILLFUNC func);
@@ -40,6 +40,18 @@ namespace XFILE {
 #define CACHE_RC_WOULD_BLOCK -2
 #define CACHE_RC_TIMEOUT -3
 
+/**
+ * How much a stream cache holds ahead of its reader, and how well the source keeps up.
+ */
+struct SCacheStatus
+{
+  int64_t      forward;     ///< bytes held ahead of the reader
+  int64_t      target;      ///< bytes the cache is trying to hold ahead of the reader
+  unsigned int readRate;    ///< bytes per second the reader takes, 0 until measured
+  unsigned int writeRate;   ///< bytes per second the source gives, 0 until measured
+  unsigned int underruns;   ///< times the reader had to wait on the source
+};
+
 /**
 */
 class ICacheInterface
@@ -48,6 +60,7 @@ public:
   ICacheInterface() { }
   virtual ~ICacheInterface() { }
   virtual int GetCacheLevel() { return -1; }
+  virtual bool GetCacheStatus(SCacheStatus &status) { return false; }
 
 };
 
@@ -66,6 +79,25 @@ public:
   virtual int64_t Seek(int64_t iFilePosition, int iWhence) = 0;
   virtual void Reset(int64_t iSourcePosition) = 0;
 
+  /**
+   * Strategies that keep data the reader has seeked away from may want the source moved,
+   * to fill in what follows the reader rather than carry on from where the source is.
+   * @return the position to read the source from, or -1 to carry on
+   */
+  virtual int64_t GetFillPosition() { return -1; }
+
+  /**
+   * The source was moved as asked by GetFillPosition(). Unlike Reset() the read position
+   * and what has been cached are kept.
+   */
+  virtual void SetFillPosition(int64_t iSourcePosition) { }
+
+  /**
+   * Change how far ahead of the reader the source is read, within what the strategy can hold.
+   * @return the read ahead now used, or -1 if the strategy always reads as far ahead as it can
+   */
+  virtual int64_t SetReadAhead(int64_t iBytes) { return -1; }
+
   virtual void EndOfInput(); // mark the end of the input stream so that Read will know when to return EOF
   virtual bool IsEndOfInput();
   virtual void ClearEndOfInput();
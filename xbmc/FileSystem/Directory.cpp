@@ -66,9 +66,11 @@ private:
 
 public:
 
-  CGetDirectory(IDirectory& imp, const CStdString& dir)
+  CGetDirectory(IDirectory& imp, const CStdString& dir, int pageSize = 0)
     : m_event(true)
   {
+    // PLEX: pass on the paging request, the job fills our own list.
+    m_list.m_pageSize = pageSize;
     m_id = CJobManager::GetInstance().AddJob(new CGetJob(imp, dir, m_list)
                                            , this
                                            , CJob::PRIORITY_HIGH);
@@ -153,7 +155,7 @@ bool CDirectory::GetDirectory(const CStdString& strPath, CFileItemList &items, C
         {
           CSingleExit ex(g_graphicsContext);
 
-          CGetDirectory get(*pDirectory, strPath);
+          CGetDirectory get(*pDirectory, strPath, items.m_pageSize);
           if(!get.Wait(TIME_TO_BUSY_DIALOG))
           {
             CGUIDialogBusy* dialog = NULL;
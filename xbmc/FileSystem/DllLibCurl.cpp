@@ -34,7 +34,11 @@ static long g_curlReferences = 0;
 static unsigned int g_curlTimeout = 0;
 DllLibCurlGlobal g_curlInterface;
 
-
+DllLibCurlGlobal::DllLibCurlGlobal()
+  : m_sessionHits(0)
+  , m_sessionMisses(0)
+{
+}
 
 bool DllLibCurlGlobal::Load()
 {
@@ -151,6 +155,8 @@ void DllLibCurlGlobal::easy_aquire(const char *protocol, const char *hostname, C
           *multi_handle = it->m_multi;
         }
 
+        m_sessionHits++;
+        CLog::Log(LOGDEBUG, "%s - Reusing session to %s://%s (hits=%u, misses=%u)\n", __FUNCTION__, protocol, hostname, m_sessionHits, m_sessionMisses);
         return;
       }
     }
@@ -178,8 +184,8 @@ void DllLibCurlGlobal::easy_aquire(const char *protocol, const char *hostname, C
 
   m_sessions.push_back(session);
 
-
-  CLog::Log(LOGINFO, "%s - Created session to %s://%s\n", __FUNCTION__, protocol, hostname);
+  m_sessionMisses++;
+  CLog::Log(LOGINFO, "%s - Created session to %s://%s (hits=%u, misses=%u)\n", __FUNCTION__, protocol, hostname, m_sessionHits, m_sessionMisses);
 
   return;
 
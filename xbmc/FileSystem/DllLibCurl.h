@@ -104,6 +104,8 @@ namespace XCURL
   class DllLibCurlGlobal : public DllLibCurl
   {
   public:
+    DllLibCurlGlobal();
+
     /* extend interface with buffered functions */
     void easy_aquire(const char *protocol, const char *hostname, CURL_HANDLE** easy_handle, CURLM** multi_handle);
     void easy_release(CURL_HANDLE** easy_handle, CURLM** multi_handle);
@@ -130,6 +132,10 @@ namespace XCURL
 
     VEC_CURLSESSIONS m_sessions;
     CCriticalSection m_critSection;
+
+    /* session pool statistics, a hit means an idle keep-alive handle was reused */
+    unsigned int     m_sessionHits;
+    unsigned int     m_sessionMisses;
   };
 }
 
@@ -25,10 +25,13 @@
 #include "File.h"
 #include "URL.h"
 
-#include "CacheMemBuffer.h"
+#include "SegmentedCache.h"
+#include "AdvancedSettings.h"
 #include "utils/SingleLock.h"
 #include "utils/log.h"
 
+#include <algorithm>
+
 using namespace AUTOPTR;
 using namespace XFILE;
 
@@ -38,9 +41,13 @@ CFileCache::CFileCache()
 {
    m_bDeleteCache = true;
    m_nSeekResult = 0;
-   m_seekPos = 0;
+   m_seekPos = -1;
    m_readPos = 0;
-   m_pCache = new CacheMemBuffer();
+   m_failedFill = -1;
+   m_underruns = 0;
+   m_readAhead = -1;
+   m_readAheadWanted = -1;
+   m_pCache = new CSegmentedCache();
    m_seekPossible = 0;
 }
 
@@ -48,9 +55,14 @@ CFileCache::CFileCache(CCacheStrategy *pCache, bool bDeleteCache)
 {
   m_pCache = pCache;
   m_bDeleteCache = bDeleteCache;
-  m_seekPos = 0;
+  m_seekPos = -1;
   m_readPos = 0;
+  m_failedFill = -1;
+  m_underruns = 0;
+  m_readAhead = -1;
+  m_readAheadWanted = -1;
   m_nSeekResult = 0;
+  m_seekPossible = 0;
 }
 
 CFileCache::~CFileCache()
@@ -109,6 +121,13 @@ bool CFileCache::Open(const CURL& url)
   m_seekPossible = m_source.Seek(0, SEEK_POSSIBLE);
 
   m_readPos = 0;
+  m_seekPos = -1;
+  m_failedFill = -1;
+  m_underruns = 0;
+  m_readAhead = -1;
+  m_readAheadWanted = -1;
+  m_readStats.Start();
+  m_writeStats.Start();
   m_seekEvent.Reset();
   m_seekEnded.Reset();
 
@@ -139,8 +158,8 @@ void CFileCache::Process()
 
   while(!m_bStop)
   {
-    // check for seek events
-    if (m_seekEvent.WaitMSec(0))
+    // check for seek events. without a seek position we were only woken to fill in for the reader
+    if (m_seekEvent.WaitMSec(0) && m_seekPos >= 0)
     {
       m_seekEvent.Reset();
       CLog::Log(LOGDEBUG,"%s, request seek on source to %"PRId64, __FUNCTION__, m_seekPos);
@@ -151,11 +170,33 @@ void CFileCache::Process()
         m_seekPossible = m_source.Seek(0, SEEK_POSSIBLE);
       }
       else
+      {
         m_pCache->Reset(m_seekPos);
+        m_failedFill = -1;
+      }
 
       m_seekEnded.Set();
     }
 
+    UpdateReadAhead();
+
+    // the reader may have moved to data we already have, carry on reading after it
+    int64_t fillPos = GetFillPosition();
+    if (fillPos >= 0)
+    {
+      if (m_source.Seek(fillPos, SEEK_SET) == fillPos)
+      {
+        CLog::Log(LOGDEBUG,"%s, filling cache from %"PRId64, __FUNCTION__, fillPos);
+        m_pCache->SetFillPosition(fillPos);
+      }
+      else
+      {
+        CLog::Log(LOGWARNING,"%s, unable to fill cache from %"PRId64, __FUNCTION__, fillPos);
+        m_failedFill = fillPos;
+        m_seekPossible = m_source.Seek(0, SEEK_POSSIBLE);
+      }
+    }
+
     int iRead = m_source.Read(buffer.get(), chunksize);
     if(iRead == 0)
     {
@@ -192,12 +233,20 @@ void CFileCache::Process()
         break;
       }
       else if (iWrite == 0)
+      {
+        // the cache won't take more from here, the source has to move first
+        if (GetFillPosition() >= 0)
+          break;
+        UpdateReadAhead();
         m_pCache->m_space.WaitMSec(5);
+      }
 
       iTotalWrite += iWrite;
+      if (iWrite > 0)
+        m_writeStats.AddSampleBytes(iWrite);
 
       // check if seek was asked. otherwise if cache is full we'll freeze.
-      if (m_seekEvent.WaitMSec(0))
+      if (m_seekEvent.WaitMSec(0) && (m_seekPos >= 0 || GetFillPosition() >= 0))
       {
         m_seekEvent.Set(); // make sure we get the seek event later.
         break;
@@ -243,12 +292,18 @@ retry:
   if (iRc > 0)
   {
     m_readPos += iRc;
+    m_readStats.AddSampleBytes((unsigned int)iRc);
     return (int)iRc;
   }
 
   if (iRc == CACHE_RC_WOULD_BLOCK)
   {
-    // just wait for some data to show up
+    if (m_readPos > 0)
+      m_underruns++;
+
+
+    // the source may need moving to what follows us. otherwise just wait for some data to show up
+    WakeForFill();
     iRc = m_pCache->WaitForData(1, 10000);
     if (iRc > 0)
       goto retry;
@@ -307,12 +362,33 @@ int64_t CFileCache::Seek(int64_t iFilePosition, int iWhence)
     m_seekPos = -1;
   }
 
+  else
+    WakeForFill();
+
   if (m_nSeekResult >= 0)
     m_readPos = m_nSeekResult;
 
   return m_nSeekResult;
 }
 
+int64_t CFileCache::GetFillPosition()
+{
+  if (m_seekPossible <= 0)
+    return -1;
+
+  int64_t fillPos = m_pCache->GetFillPosition();
+  if (fillPos == m_failedFill)
+    return -1;
+  return fillPos;
+}
+
+void CFileCache::WakeForFill()
+{
+  // Process() might be idle at the end of the file or waiting for the cache to take more
+  if (GetFillPosition() >= 0)
+    m_seekEvent.Set();
+}
+
 void CFileCache::Close()
 {
   StopThread();
@@ -336,9 +412,52 @@ int64_t CFileCache::GetLength()
 
 ICacheInterface* CFileCache::GetCache()
 {
-  if(m_pCache)
+  if(m_pCache && m_pCache->GetInterface())
     return m_pCache->GetInterface();
-  return NULL;
+  return this;
+}
+
+void CFileCache::UpdateReadAhead()
+{
+  // hold a number of seconds of the stream rather than a number of bytes, so a low bitrate
+  // stream isn't fetched far ahead for nothing and a high bitrate one gets more room
+  double rate = m_readStats.GetBitrate() / 8;
+  if (g_advancedSettings.m_cacheReadAheadTime == 0 || rate <= 0)
+    return;
+
+  // the rate is only measured every couple of seconds, small changes aren't worth acting on
+  int64_t wanted = (int64_t)(rate * g_advancedSettings.m_cacheReadAheadTime);
+  if (m_readAheadWanted > 0 && wanted > m_readAheadWanted * 0.9 && wanted < m_readAheadWanted * 1.1)
+    return;
+
+  int64_t readAhead = m_pCache->SetReadAhead(wanted);
+  if (readAhead >= 0 && readAhead != m_readAhead)
+    CLog::Log(LOGDEBUG, "%s - reading %"PRId64" bytes ahead, %.1f seconds at %.0fkbit/s",
+              __FUNCTION__, readAhead, readAhead / rate, rate * 8 / 1000);
+
+  m_readAhead = readAhead;
+  m_readAheadWanted = wanted;
+}
+
+bool CFileCache::GetCacheStatus(SCacheStatus &status)
+{
+  if (!m_pCache)
+    return false;
+
+  status.forward = std::max(m_pCache->WaitForData(0, 0), (int64_t)0);
+  status.target = m_readAhead >= 0 ? m_readAhead : (int64_t)g_advancedSettings.m_cacheMemBufferSize;
+  status.readRate = (unsigned int)(m_readStats.GetBitrate() / 8);
+  status.writeRate = (unsigned int)(m_writeStats.GetBitrate() / 8);
+  status.underruns = m_underruns;
+  return true;
+}
+
+int CFileCache::GetCacheLevel()
+{
+  SCacheStatus status;
+  if (!GetCacheStatus(status) || status.target <= 0)
+    return -1;
+  return (int)std::min(status.forward * 100 / status.target, (int64_t)100);
 }
 
 void CFileCache::StopThread(bool bWait /*= true*/)
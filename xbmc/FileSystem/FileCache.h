@@ -25,11 +25,12 @@
 #include "utils/CriticalSection.h"
 #include "FileSystem/File.h"
 #include "utils/Thread.h"
+#include "utils/BitstreamStats.h"
 
 namespace XFILE
 {
 
-  class CFileCache : public IFile, public CThread
+  class CFileCache : public IFile, public CThread, public ICacheInterface
   {
   public:
     CFileCache();
@@ -62,7 +63,15 @@ namespace XFILE
 
     virtual CStdString GetContent();
 
+    // ICacheInterface methods
+    virtual int  GetCacheLevel();
+    virtual bool GetCacheStatus(SCacheStatus &status);
+
   private:
+    int64_t GetFillPosition();
+    void WakeForFill();
+    void UpdateReadAhead();
+
     CCacheStrategy *m_pCache;
     bool      m_bDeleteCache;
     int64_t    m_seekPossible;
@@ -75,6 +84,12 @@ namespace XFILE
     int64_t      m_nSeekResult;
     int64_t      m_seekPos;
     int64_t      m_readPos;
+    int64_t      m_failedFill;
+    BitstreamStats m_readStats;     // what the reader takes
+    BitstreamStats m_writeStats;    // what the source gives
+    unsigned int m_underruns;
+    int64_t      m_readAhead;       // as set on the strategy, -1 until it has been
+    int64_t      m_readAheadWanted;
     CCriticalSection m_sync;
   };
 
@@ -29,6 +29,7 @@
 
 #include <vector>
 #include <climits>
+#include <algorithm>
 
 #ifdef _LINUX
 #include <errno.h>
@@ -45,6 +46,7 @@
 #include "SpecialProtocol.h"
 #include "utils/CharsetConverter.h"
 #include "utils/log.h"
+#include "utils/TimeUtils.h"
 
 using namespace XFILE;
 using namespace XCURL;
@@ -54,6 +56,13 @@ using namespace XCURL;
 
 #define dllselect select
 
+// ranges fetched in parallel, see CFileCurl::CRangeReader
+#define RANGE_MIN_CONNECTIONS 2
+#define RANGE_MIN_SIZE        (256 * 1024)
+#define RANGE_START_SIZE      (1024 * 1024)
+#define RANGE_MAX_SIZE        (4 * 1024 * 1024)
+#define RANGE_MIN_LENGTH      (16 * 1024 * 1024)
+
 // curl calls this routine to debug
 extern "C" int debug_callback(CURL_HANDLE *handle, curl_infotype info, char *output, size_t size, void *data)
 {
@@ -321,11 +330,313 @@ void CFileCurl::CReadState::Disconnect()
   m_bufferSize = 0;
 }
 
+CFileCurl::CRangeReader::CRangeReader(CFileCurl* file, int64_t position, int64_t length)
+{
+  m_file = file;
+  m_position = position;
+  m_length = length;
+  m_next = position;
+  m_rangeSize = RANGE_START_SIZE;
+  m_connections = RANGE_MIN_CONNECTIONS;
+  m_measured = 0;
+  m_waited = false;
+  m_rtt = 0.0;
+  m_rate = 0.0;
+  m_throughput = 0.0;
+}
+
+CFileCurl::CRangeReader::~CRangeReader()
+{
+  while (!m_ranges.empty())
+  {
+    Release(m_ranges.front());
+    m_ranges.pop_front();
+  }
+}
+
+bool CFileCurl::CRangeReader::Start(Range& range)
+{
+  CURL url(m_file->m_url);
+  range.state = new CReadState();
+  g_curlInterface.easy_aquire(url.GetProtocol(), url.GetHostName(), &range.state->m_easyHandle, &range.state->m_multiHandle);
+  m_file->SetCommonOptions(range.state);
+
+  // the header list belongs to the file and is still in use by the other ranges, so it isn't rebuilt
+  if (m_file->m_curlHeaderList)
+    g_curlInterface.easy_setopt(range.state->m_easyHandle, CURLOPT_HTTPHEADER, m_file->m_curlHeaderList);
+
+  CStdString bytes;
+  bytes.Format("%"PRId64"-%"PRId64, range.start, range.end - 1);
+  g_curlInterface.easy_setopt(range.state->m_easyHandle, CURLOPT_RANGE, bytes.c_str());
+  if (g_curlInterface.multi_add_handle(range.state->m_multiHandle, range.state->m_easyHandle) != CURLM_OK)
+  {
+    Release(range);
+    return false;
+  }
+
+  range.state->m_filePos = range.start;
+  range.state->m_fileSize = range.end;
+  range.state->m_bufferSize = (unsigned int)(range.end - range.start);
+  range.state->m_buffer.Create(range.state->m_bufferSize + 1);
+  range.state->m_stillRunning = 1;
+  range.requested = CTimeUtils::GetTimeMS();
+  range.firstByte = 0;
+  range.failed = false;
+  return true;
+}
+
+void CFileCurl::CRangeReader::Release(Range& range)
+{
+  delete range.state;
+  range.state = NULL;
+}
+
+void CFileCurl::CRangeReader::Request()
+{
+  unsigned int running = 0;
+  for (std::deque<Range>::const_iterator it = m_ranges.begin(); it != m_ranges.end(); ++it)
+  {
+    if (it->state && it->state->m_stillRunning)
+      running++;
+  }
+
+  // keep every connection busy, without holding more than a couple of ranges for each
+  while (running < m_connections && m_ranges.size() < 2 * m_connections && m_next < m_length)
+  {
+    Range range;
+    range.start = m_next;
+    range.end = std::min(m_next + (int64_t)m_rangeSize, m_length);
+    if (!Start(range))
+      range.failed = true;
+    m_ranges.push_back(range);
+    m_next = range.end;
+    running++;
+  }
+}
+
+bool CFileCurl::CRangeReader::Perform()
+{
+  fd_set fdread;
+  fd_set fdwrite;
+  fd_set fdexcep;
+  FD_ZERO(&fdread);
+  FD_ZERO(&fdwrite);
+  FD_ZERO(&fdexcep);
+  int maxfd = -1;
+  long timeout = 200;
+  bool running = false;
+
+  for (std::deque<Range>::iterator it = m_ranges.begin(); it != m_ranges.end(); ++it)
+  {
+    CReadState* state = it->state;
+    if (!state || !state->m_stillRunning)
+      continue;
+
+    CURLMcode result = g_curlInterface.multi_perform(state->m_multiHandle, &state->m_stillRunning);
+    if (result != CURLM_OK && result != CURLM_CALL_MULTI_PERFORM)
+    {
+      CLog::Log(LOGERROR, "%s - curl multi perform failed with code %d", __FUNCTION__, result);
+      it->failed = true;
+      Release(*it);
+      continue;
+    }
+
+    if (!it->firstByte && state->m_buffer.getMaxReadSize() > 0)
+    {
+      it->firstByte = CTimeUtils::GetTimeMS();
+
+      // a server ignoring the range would send the whole file
+      long response = 0;
+      g_curlInterface.easy_getinfo(state->m_easyHandle, CURLINFO_RESPONSE_CODE, &response);
+      if (response != 206)
+      {
+        CLog::Log(LOGWARNING, "%s - server answered range request with %ld", __FUNCTION__, response);
+        it->failed = true;
+        Release(*it);
+        continue;
+      }
+    }
+
+    if (!state->m_stillRunning)
+    {
+      int msgs;
+      CURLMsg* msg;
+      while ((msg = g_curlInterface.multi_info_read(state->m_multiHandle, &msgs)))
+      {
+        if (msg->msg == CURLMSG_DONE && msg->data.result != CURLE_OK)
+        {
+          CLog::Log(LOGWARNING, "%s - curl failed with code %i", __FUNCTION__, msg->data.result);
+          it->failed = true;
+        }
+      }
+
+      int64_t received = state->m_filePos + state->m_buffer.getMaxReadSize() + state->m_overflowSize;
+      if (!it->failed && received != it->end)
+      {
+        CLog::Log(LOGWARNING, "%s - range %"PRId64"-%"PRId64" ended at %"PRId64, __FUNCTION__, it->start, it->end, received);
+        it->failed = true;
+      }
+
+      if (!it->failed)
+        Measure(*it);
+      continue;
+    }
+
+    running = true;
+    g_curlInterface.multi_fdset(state->m_multiHandle, &fdread, &fdwrite, &fdexcep, &maxfd);
+    long wait = -1;
+    if (g_curlInterface.multi_timeout(state->m_multiHandle, &wait) == CURLM_OK && wait >= 0 && wait < timeout)
+      timeout = wait;
+  }
+
+  if (!running)
+    return true;
+
+  struct timeval t = { timeout / 1000, (timeout % 1000) * 1000 };
+
+#ifndef _WIN32
+  // woken by Cancel()
+  int tickle = m_file->m_state->m_ticklePipe[0];
+  FD_SET(tickle, &fdread);
+  if (tickle > maxfd)
+    maxfd = tickle;
+#endif
+
+  if (SOCKET_ERROR == dllselect(maxfd + 1, &fdread, &fdwrite, &fdexcep, &t))
+  {
+    CLog::Log(LOGERROR, "%s - curl failed with socket error", __FUNCTION__);
+    return false;
+  }
+
+#ifndef _WIN32
+  if (FD_ISSET(tickle, &fdread))
+  {
+    char theTickleByte;
+    ::read(tickle, &theTickleByte, 1);
+  }
+#endif
+  return true;
+}
+
+void CFileCurl::CRangeReader::Measure(const Range& range)
+{
+  unsigned int now = CTimeUtils::GetTimeMS();
+  double rtt = range.firstByte - range.requested;
+  double rate = (double)(range.end - range.start) / std::max(now - range.firstByte, 1u);
+
+  m_rtt = m_rtt > 0.0 ? 0.75 * m_rtt + 0.25 * rtt : rtt;
+  m_rate = m_rate > 0.0 ? 0.75 * m_rate + 0.25 * rate : rate;
+
+  // a range should take several round trips to come in, or connections sit waiting on requests
+  double size = m_rate * m_rtt * 8;
+  m_rangeSize = (unsigned int)std::min(std::max(size, (double)RANGE_MIN_SIZE), (double)RANGE_MAX_SIZE);
+  m_rangeSize -= m_rangeSize % RANGE_MIN_SIZE;
+
+  // add connections while the reader is kept waiting and each one adds to what we get.
+  // once the link is full, more connections only split the same bandwidth between them.
+  if (++m_measured < 2 * m_connections)
+    return;
+
+  double throughput = m_rate * m_connections;
+  unsigned int connections = m_connections;
+  if (m_waited && throughput > m_throughput * 1.1 && m_connections < (unsigned int)g_advancedSettings.m_curlRangeConnections)
+    m_connections++;
+  else if (throughput < m_throughput * 0.9 && m_connections > RANGE_MIN_CONNECTIONS)
+    m_connections--;
+
+  if (connections != m_connections)
+    CLog::Log(LOGDEBUG, "%s - %u connections, %u byte ranges (rtt %.0fms, %.0fKB/s per connection)",
+              __FUNCTION__, m_connections, m_rangeSize, m_rtt, m_rate * 1000 / 1024);
+
+  m_throughput = throughput;
+  m_measured = 0;
+  m_waited = false;
+}
+
+int CFileCurl::CRangeReader::Read(void* lpBuf, int64_t uiBufSize)
+{
+  while (m_position < m_length)
+  {
+    if (m_file->m_state->m_cancelled)
+      return 0;
+
+    Request();
+    if (m_ranges.empty())
+      return -1;
+
+    Range& range = m_ranges.front();
+    if (range.state)
+    {
+      CRingBuffer& buffer = range.state->m_buffer;
+      unsigned int want = (unsigned int)XMIN(buffer.getMaxReadSize(), uiBufSize);
+      if (want && buffer.ReadData((char *)lpBuf, want))
+      {
+        range.state->m_filePos += want;
+        m_position += want;
+        if (m_position >= range.end)
+        {
+          Release(range);
+          m_ranges.pop_front();
+        }
+        return want;
+      }
+    }
+
+    if (range.failed || !range.state)
+      return -1;
+
+    m_waited = true;
+    if (!Perform())
+      return -1;
+  }
+  return 0;
+}
+
+bool CFileCurl::CRangeReader::Seek(int64_t pos)
+{
+  if (pos == m_position)
+    return true;
+
+  // ranges wholly before the new position are of no more use
+  while (!m_ranges.empty() && m_ranges.front().end <= pos)
+  {
+    Release(m_ranges.front());
+    m_ranges.pop_front();
+  }
+
+  if (!m_ranges.empty() && m_ranges.front().start <= pos)
+  {
+    Range& range = m_ranges.front();
+    if (range.state && FITS_INT(pos - range.state->m_filePos) && range.state->m_buffer.SkipBytes((int)(pos - range.state->m_filePos)))
+      range.state->m_filePos = pos;
+    else
+    { // not come in yet, ask for it from where we are now. the ranges following it are kept.
+      Release(range);
+      range.start = pos;
+      if (!Start(range))
+        range.failed = true;
+    }
+  }
+  else
+  {
+    while (!m_ranges.empty())
+    {
+      Release(m_ranges.front());
+      m_ranges.pop_front();
+    }
+    m_next = pos;
+  }
+
+  m_position = pos;
+  return true;
+}
+
 
 CFileCurl::~CFileCurl()
 {
   if (m_opened)
     Close();
+  delete m_ranges;
   delete m_state;
   g_curlInterface.Unload();
 }
@@ -336,6 +647,7 @@ CFileCurl::CFileCurl()
   m_curlAliasList = NULL;
   m_curlHeaderList = NULL;
   m_opened = false;
+  m_httpresponse = -1;
   m_multisession  = true;
   m_seekable = true;
   m_useOldHttpVersion = false;
@@ -351,6 +663,7 @@ CFileCurl::CFileCurl()
   m_password = "";
   m_httpauth = "";
   m_state = new CReadState();
+  m_ranges = NULL;
   m_skipshout = false;
   m_clearCookies = false;
   m_post = false;
@@ -366,6 +679,8 @@ void CFileCurl::SetBufferSize(unsigned int size)
 void CFileCurl::Close()
 {
   CLog::Log(LOGDEBUG, "FileCurl::Close(%p) %s", (void*)this, m_url.c_str());
+  delete m_ranges;
+  m_ranges = NULL;
   m_state->Disconnect();
 
   m_url.Empty();
@@ -455,15 +770,16 @@ void CFileCurl::SetCommonOptions(CReadState* state)
   g_curlInterface.easy_setopt(h, CURLOPT_FAILONERROR, 1);
 
   // enable support for icecast / shoutcast streams
-  m_curlAliasList = g_curlInterface.slist_append(m_curlAliasList, "ICY 200 OK");
+  if (!m_curlAliasList)
+    m_curlAliasList = g_curlInterface.slist_append(m_curlAliasList, "ICY 200 OK");
   g_curlInterface.easy_setopt(h, CURLOPT_HTTP200ALIASES, m_curlAliasList);
 
   // never verify peer, we don't have any certificates to do this
   g_curlInterface.easy_setopt(h, CURLOPT_SSL_VERIFYPEER, 0);
   g_curlInterface.easy_setopt(h, CURLOPT_SSL_VERIFYHOST, 0);
 
-  g_curlInterface.easy_setopt(m_state->m_easyHandle, CURLOPT_URL, m_url.c_str());
-  g_curlInterface.easy_setopt(m_state->m_easyHandle, CURLOPT_TRANSFERTEXT, FALSE);
+  g_curlInterface.easy_setopt(h, CURLOPT_URL, m_url.c_str());
+  g_curlInterface.easy_setopt(h, CURLOPT_TRANSFERTEXT, FALSE);
 
   // setup POST data if it exists
   if (!m_postdata.IsEmpty() || m_post == true)
@@ -789,26 +1105,33 @@ void CFileCurl::ParseAndCorrectUrl(CURL &url2)
     m_url = url2.Get();
 }
 
+// The same handle may be used for several requests, so each of these sets the method
+// afresh rather than inheriting whatever the last one used.
 bool CFileCurl::Post(const CStdString& strURL, const CStdString& strPostData, CStdString& strHTML)
 {
+  m_verb.clear();
   m_post = true;
   return Service(strURL, strPostData, strHTML);
 }
 
 bool CFileCurl::Get(const CStdString& strURL, CStdString& strHTML)
 {
+  m_verb.clear();
+  m_post = false;
   return Service(strURL, "", strHTML);
 }
 
 bool CFileCurl::Put(const CStdString& strURL, CStdString& strHTML)
 {
   m_verb = "PUT";
+  m_post = false;
   return Service(strURL, "", strHTML);
 }
 
 bool CFileCurl::Delete(const CStdString& strURL, CStdString& strHTML)
 {
   m_verb = "DELETE";
+  m_post = false;
   return Service(strURL, "", strHTML);
 }
 
@@ -884,11 +1207,11 @@ bool CFileCurl::IsInternet(bool checkDNS /* = true */)
   return found;
 }
 
-void CFileCurl::Cancel()
+void CFileCurl::Cancel(bool wait)
 {
   m_state->Cancel();
   
-  while (m_opened)
+  while (wait && m_opened)
     Sleep(1);
 }
 
@@ -916,6 +1239,10 @@ bool CFileCurl::Open(const CURL& url)
   SetRequestHeaders(m_state);
 
   long response = m_state->Connect(m_bufferSize);
+  m_httpresponse = response;
+  // an error answer fails the transfer before Connect() gets to look at it
+  if (response < 0 && g_curlInterface.easy_getinfo(m_state->m_easyHandle, CURLINFO_RESPONSE_CODE, &m_httpresponse) != CURLE_OK)
+    m_httpresponse = -1;
   if ((response < 0 || response >= 400) && m_state->m_strDeadEndUrl.empty())
     return false;
 
@@ -975,9 +1302,54 @@ bool CFileCurl::Open(const CURL& url)
   if (CURLE_OK == g_curlInterface.easy_getinfo(m_state->m_easyHandle, CURLINFO_EFFECTIVE_URL,&efurl) && efurl)
     m_url = efurl;
 
+  // a large file from a server that takes ranges is read over several connections at once
+  if (g_advancedSettings.m_curlRangeConnections >= RANGE_MIN_CONNECTIONS && m_seekable && m_multisession
+  &&  m_contentencoding.IsEmpty() && m_state->m_fileSize >= RANGE_MIN_LENGTH
+  &&  m_state->m_httpheader.GetValue("Accept-Ranges").Equals("bytes"))
+  {
+    CLog::Log(LOGDEBUG, "FileCurl - reading %s over up to %d connections", m_url.c_str(), g_advancedSettings.m_curlRangeConnections);
+    m_ranges = new CRangeReader(this, m_state->m_filePos, m_state->m_fileSize);
+    int64_t length = m_state->m_fileSize;
+    m_state->Disconnect();
+    m_state->m_fileSize = length;
+  }
+
   return true;
 }
 
+bool CFileCurl::StopRanges()
+{
+  CLog::Log(LOGWARNING, "FileCurl - unable to read %s in ranges, carrying on over a single connection", m_url.c_str());
+
+  m_state->m_filePos = m_ranges->GetPosition();
+  m_state->m_fileSize = m_ranges->GetLength();
+  delete m_ranges;
+  m_ranges = NULL;
+
+  long response = m_state->Connect(m_bufferSize);
+  return response >= 0 && response < 400;
+}
+
+unsigned int CFileCurl::Read(void* lpBuf, int64_t uiBufSize)
+{
+  if (m_ranges)
+  {
+    int read = m_ranges->Read(lpBuf, uiBufSize);
+    if (read >= 0)
+      return read;
+    if (!StopRanges())
+      return 0;
+  }
+  return m_state->Read(lpBuf, uiBufSize);
+}
+
+bool CFileCurl::ReadString(char *szLine, int iLineLength)
+{
+  if (m_ranges && !StopRanges())
+    return false;
+  return m_state->ReadString(szLine, iLineLength);
+}
+
 bool CFileCurl::CReadState::ReadString(char *szLine, int iLineLength)
 {
   unsigned int want = (unsigned int)iLineLength;
@@ -1049,7 +1421,7 @@ bool CFileCurl::Exists(const CURL& url)
 
 int64_t CFileCurl::Seek(int64_t iFilePosition, int iWhence)
 {
-  int64_t nextPos = m_state->m_filePos;
+  int64_t nextPos = GetPosition();
   switch(iWhence)
   {
     case SEEK_SET:
@@ -1059,8 +1431,8 @@ int64_t CFileCurl::Seek(int64_t iFilePosition, int iWhence)
       nextPos += iFilePosition;
       break;
     case SEEK_END:
-      if (m_state->m_fileSize)
-        nextPos = m_state->m_fileSize + iFilePosition;
+      if (GetLength())
+        nextPos = GetLength() + iFilePosition;
       else
         return -1;
       break;
@@ -1071,7 +1443,10 @@ int64_t CFileCurl::Seek(int64_t iFilePosition, int iWhence)
   }
 
   // We can't seek beyond EOF
-  if (m_state->m_fileSize && nextPos > m_state->m_fileSize) return -1;
+  if (GetLength() && nextPos > GetLength()) return -1;
+
+  if(m_ranges)
+    return m_ranges->Seek(nextPos) ? nextPos : -1;
 
   if(m_state->Seek(nextPos))
     return nextPos;
@@ -1122,12 +1497,14 @@ int64_t CFileCurl::Seek(int64_t iFilePosition, int iWhence)
 int64_t CFileCurl::GetLength()
 {
   if (!m_opened) return 0;
+  if (m_ranges) return m_ranges->GetLength();
   return m_state->m_fileSize;
 }
 
 int64_t CFileCurl::GetPosition()
 {
   if (!m_opened) return 0;
+  if (m_ranges) return m_ranges->GetPosition();
   return m_state->m_filePos;
 }
 
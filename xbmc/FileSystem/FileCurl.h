@@ -23,6 +23,7 @@
 #include "IFile.h"
 #include "utils/RingBuffer.h"
 #include <map>
+#include <deque>
 #include "utils/HttpHeader.h"
 
 namespace XCURL
@@ -48,8 +49,8 @@ namespace XFILE
       virtual int64_t  GetLength();
       virtual int  Stat(const CURL& url, struct __stat64* buffer);
       virtual void Close();
-      virtual bool ReadString(char *szLine, int iLineLength)     { return m_state->ReadString(szLine, iLineLength); }
-      virtual unsigned int Read(void* lpBuf, int64_t uiBufSize)  { return m_state->Read(lpBuf, uiBufSize); }
+      virtual bool ReadString(char *szLine, int iLineLength);
+      virtual unsigned int Read(void* lpBuf, int64_t uiBufSize);
       virtual CStdString GetMimeType()                           { return m_state->m_httpheader.GetMimeType(); }
 
       bool Post(const CStdString& strURL, const CStdString& strPostData, CStdString& strHTML);
@@ -59,7 +60,8 @@ namespace XFILE
       bool ReadData(CStdString& strHTML);
       bool Download(const CStdString& strURL, const CStdString& strFileName, LPDWORD pdwSize = NULL);
       bool IsInternet(bool checkDNS = true);
-      void Cancel();
+      long GetHttpResponseCode() const                           { return m_httpresponse; } // of the last Open(), 0 if nothing answered
+      void Cancel(bool wait = true);                             // wait: until the transfer has wound down
       void Reset();
       void SetUserAgent(CStdString sUserAgent)                   { m_userAgent = sUserAgent; }
       void SetProxy(CStdString &proxy)                           { m_proxy = proxy; }
@@ -132,15 +134,62 @@ namespace XFILE
           }
       };
 
+      /* fetches the stream as consecutive byte ranges over several connections at once, as a
+         single connection to a distant server is held back by its round trip time */
+      class CRangeReader
+      {
+      public:
+          CRangeReader(CFileCurl* file, int64_t position, int64_t length);
+          ~CRangeReader();
+
+          int          Read(void* lpBuf, int64_t uiBufSize); // -1 if the ranges couldn't be fetched
+          bool         Seek(int64_t pos);
+          int64_t      GetPosition() const { return m_position; }
+          int64_t      GetLength() const   { return m_length; }
+
+      private:
+          struct Range
+          {
+            CReadState*  state;
+            int64_t      start;
+            int64_t      end;
+            unsigned int requested;         // when the request went out
+            unsigned int firstByte;         // when data started coming in, 0 until it does
+            bool         failed;
+          };
+
+          bool         Start(Range& range);
+          void         Release(Range& range);
+          void         Request();
+          bool         Perform();
+          void         Measure(const Range& range);
+
+          CFileCurl*        m_file;
+          std::deque<Range> m_ranges;
+          int64_t           m_position;
+          int64_t           m_length;
+          int64_t           m_next;         // where the next range starts
+          unsigned int      m_rangeSize;
+          unsigned int      m_connections;
+          unsigned int      m_measured;     // ranges completed since the connection count changed
+          bool              m_waited;       // the reader has waited on the network since then
+          double            m_rtt;          // ms, until a range starts coming in
+          double            m_rate;         // bytes per ms, of a single connection
+          double            m_throughput;   // bytes per ms, of all connections at the last change
+      };
+      friend class CRangeReader;
+
     protected:
       void ParseAndCorrectUrl(CURL &url);
       void SetCommonOptions(CReadState* state);
       void SetRequestHeaders(CReadState* state);
       void SetCorrectHeaders(CReadState* state);
       bool Service(const CStdString& strURL, const CStdString& strPostData, CStdString& strHTML);
+      bool StopRanges();
 
     private:
       CReadState*     m_state;
+      CRangeReader*   m_ranges;
       unsigned int    m_bufferSize;
 
       CStdString      m_url;
@@ -173,6 +222,7 @@ namespace XFILE
       bool            m_multisession;
       bool            m_skipshout;
       bool            m_clearCookies;
+      long            m_httpresponse;
 
       CRingBuffer     m_buffer;           // our ringhold buffer
       char *          m_overflowBuffer;   // in the rare case we would overflow the above buffer
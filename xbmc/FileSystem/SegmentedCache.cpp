@@ -0,0 +1,458 @@
+/*
+ *      Copyright (C) 2005-2010 Team XBMC
+ *      http://www.xbmc.org
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, write to
+ *  the Free Software Foundation, 675 Mass Ave, Cambridge, MA 02139, USA.
+ *  http://www.gnu.org/copyleft/gpl.html
+ *
+ */
+
+#ifdef _LINUX
+#include "../linux/PlatformDefs.h"
+#endif
+#include "AdvancedSettings.h"
+#include "SegmentedCache.h"
+#include "utils/log.h"
+#include "utils/SingleLock.h"
+#include "utils/TimeUtils.h"
+
+#include <algorithm>
+
+using namespace XFILE;
+
+#define CACHE_BLOCK_SIZE (128 * 1024)
+
+// never read ahead less than this, however slowly the stream is read
+#define CACHE_MIN_READAHEAD (4 * CACHE_BLOCK_SIZE)
+
+// a seek this far past what has been written is waited for rather than sent to the source
+#define CACHE_SEEK_WAIT_SIZE 100000
+
+CSegmentedCache::CSegmentedCache()
+ : CCacheStrategy()
+{
+  // the same budget the ring buffers had between them: read ahead, history and leftovers
+  m_readAhead = std::max(g_advancedSettings.m_cacheMemBufferSize, (unsigned int)CACHE_BLOCK_SIZE);
+  m_maxBlocks = std::max(3 * m_readAhead / CACHE_BLOCK_SIZE, m_readAhead / CACHE_BLOCK_SIZE + 3);
+
+  // reading further ahead still leaves a third of the blocks for what's behind the reader
+  m_maxReadAhead = std::max(m_readAhead, 2 * m_maxBlocks / 3 * CACHE_BLOCK_SIZE);
+  m_spill = NULL;
+  Clear();
+}
+
+CSegmentedCache::~CSegmentedCache()
+{
+  Clear();
+}
+
+int CSegmentedCache::Open()
+{
+  CSingleLock lock(m_sync);
+  Clear();
+  m_readAhead = std::max(g_advancedSettings.m_cacheMemBufferSize, (unsigned int)CACHE_BLOCK_SIZE);
+  return CACHE_RC_OK;
+}
+
+int CSegmentedCache::Close()
+{
+  CSingleLock lock(m_sync);
+  if (m_seekHits + m_seekMisses + m_readHits + m_readMisses)
+    CLog::Log(LOGDEBUG, "%s, seeks: %u hit %u missed, reads: %u hit %u waited, %u blocks read back from disk",
+              __FUNCTION__, m_seekHits, m_seekMisses, m_readHits, m_readMisses, m_reloads);
+  Clear();
+  return CACHE_RC_OK;
+}
+
+void CSegmentedCache::Clear()
+{
+  for (BlockMap::iterator it = m_blocks.begin(); it != m_blocks.end(); ++it)
+    delete[] it->second.data;
+  m_blocks.clear();
+
+  if (m_spill)
+  {
+    m_spill->Close();
+    delete m_spill;
+    m_spill = NULL;
+  }
+  m_spilled.clear();
+  m_spillSize = 0;
+  m_spillFailed = false;
+
+  m_clock = 0;
+  m_readPosition = 0;
+  m_writePosition = 0;
+  m_length = -1;
+  m_seekHits = m_seekMisses = 0;
+  m_readHits = m_readMisses = 0;
+  m_reloads = 0;
+  m_bEndOfInput = false;
+}
+
+int64_t CSegmentedCache::BlockStart(int64_t position)
+{
+  return position - position % CACHE_BLOCK_SIZE;
+}
+
+bool CSegmentedCache::IsProtected(int64_t start) const
+{
+  // the block the reader is in, the one before it for small seeks back, and what's being read ahead
+  return start >= BlockStart(m_readPosition) - CACHE_BLOCK_SIZE && start < m_readPosition + m_readAhead;
+}
+
+int64_t CSegmentedCache::GetCachedEnd(int64_t position) const
+{
+  while (true)
+  {
+    int64_t start = BlockStart(position);
+    int64_t end;
+
+    BlockMap::const_iterator block = m_blocks.find(start);
+    SpillMap::const_iterator spilled = m_spilled.find(start);
+    if (block != m_blocks.end() && block->second.begin <= position && position < block->second.end)
+      end = block->second.end;
+    else if (spilled != m_spilled.end() && spilled->second.begin <= position && position < spilled->second.end)
+      end = spilled->second.end;
+    else
+      return position;
+
+    position = end;
+    if (end != start + CACHE_BLOCK_SIZE)
+      return position;
+  }
+}
+
+CSegmentedCache::Block *CSegmentedCache::GetBlock(int64_t position, bool reload)
+{
+  int64_t start = BlockStart(position);
+  BlockMap::iterator it = m_blocks.find(start);
+  if (it != m_blocks.end() && (!reload || (it->second.begin <= position && position < it->second.end)))
+    return &it->second;
+
+  SpillMap::iterator spilled = m_spilled.find(start);
+  if (!reload || spilled == m_spilled.end() || position < spilled->second.begin || position >= spilled->second.end)
+    return it != m_blocks.end() ? &it->second : NULL;
+
+  // the range the reader wants went to disk, possibly replaced by another in memory
+  Block *block = it != m_blocks.end() ? &it->second : AllocateBlock(start);
+  if (block && !Reload(start, *block))
+  {
+    delete[] block->data;
+    m_blocks.erase(start);
+    block = NULL;
+  }
+  return block;
+}
+
+CSegmentedCache::Block *CSegmentedCache::AllocateBlock(int64_t start)
+{
+  char *data = NULL;
+  if (m_blocks.size() >= m_maxBlocks)
+  {
+    BlockMap::iterator oldest = m_blocks.end();
+    for (BlockMap::iterator it = m_blocks.begin(); it != m_blocks.end(); ++it)
+    {
+      if (!IsProtected(it->first) && (oldest == m_blocks.end() || it->second.lastUsed < oldest->second.lastUsed))
+        oldest = it;
+    }
+    if (oldest == m_blocks.end())
+      return NULL;
+
+    Spill(oldest->first, oldest->second);
+    data = oldest->second.data;
+    m_blocks.erase(oldest);
+  }
+  else
+    data = new char[CACHE_BLOCK_SIZE];
+
+  Block &block = m_blocks[start];
+  block.begin = block.end = start;
+  block.lastUsed = ++m_clock;
+  block.data = data;
+  return &block;
+}
+
+void CSegmentedCache::Spill(int64_t start, const Block &block)
+{
+  int64_t size = block.end - block.begin;
+  if (size <= 0 || g_advancedSettings.m_cacheSpillSize == 0 || m_spillFailed)
+    return;
+
+  // the file doesn't change underneath us, so anything already on disk is still good
+  SpillMap::iterator it = m_spilled.find(start);
+  if (it != m_spilled.end() && it->second.begin <= block.begin && it->second.end >= block.end)
+    return;
+
+  if (m_spillSize + size > (int64_t)g_advancedSettings.m_cacheSpillSize)
+    return;
+
+  if (!m_spill)
+  {
+    m_spill = new CSimpleFileCache();
+    if (m_spill->Open() != CACHE_RC_OK)
+    {
+      CLog::Log(LOGWARNING, "%s, unable to create spill file, keeping the cache in memory", __FUNCTION__);
+      delete m_spill;
+      m_spill = NULL;
+      m_spillFailed = true;
+      return;
+    }
+    m_spill->Reset(0);
+  }
+
+  const char *data = block.data + (block.begin - start);
+  int64_t written = 0;
+  while (written < size)
+  {
+    int iWrite = m_spill->WriteToCache(data + written, (size_t)(size - written));
+    if (iWrite <= 0)
+    {
+      CLog::Log(LOGWARNING, "%s, failed writing to spill file, keeping the cache in memory", __FUNCTION__);
+      m_spillFailed = true;
+      return;
+    }
+    written += iWrite;
+  }
+
+  SpilledBlock &spilled = m_spilled[start];
+  spilled.offset = m_spillSize;
+  spilled.begin = block.begin;
+  spilled.end = block.end;
+  m_spillSize += size;
+}
+
+bool CSegmentedCache::Reload(int64_t start, Block &block)
+{
+  const SpilledBlock &spilled = m_spilled[start];
+  if (!m_spill || m_spill->Seek(spilled.offset, SEEK_SET) != spilled.offset)
+  {
+    m_spilled.erase(start);
+    return false;
+  }
+
+  char *data = block.data + (spilled.begin - start);
+  int64_t size = spilled.end - spilled.begin;
+  int64_t read = 0;
+  while (read < size)
+  {
+    int iRead = m_spill->ReadFromCache(data + read, (size_t)(size - read));
+    if (iRead <= 0)
+    {
+      CLog::Log(LOGWARNING, "%s, failed reading block %"PRId64" from spill file", __FUNCTION__, start);
+      m_spilled.erase(start);
+      return false;
+    }
+    read += iRead;
+  }
+
+  block.begin = spilled.begin;
+  block.end = spilled.end;
+  m_reloads++;
+  return true;
+}
+
+int CSegmentedCache::WriteToCache(const char *pBuffer, size_t iSize)
+{
+  CSingleLock lock(m_sync);
+
+  // only fill what follows the reader. anything else is wasted until the source is moved.
+  if (m_writePosition < m_readPosition || m_writePosition >= m_readPosition + m_readAhead)
+    return 0;
+
+  int64_t nToWrite = std::min((int64_t)iSize, m_readPosition + m_readAhead - m_writePosition);
+  int64_t nWritten = 0;
+  while (nWritten < nToWrite)
+  {
+    int64_t start = BlockStart(m_writePosition);
+    Block *block = GetBlock(m_writePosition, false);
+    if (!block)
+      block = AllocateBlock(start);
+    if (!block)
+      break;
+
+    int64_t size = std::min(nToWrite - nWritten, start + CACHE_BLOCK_SIZE - m_writePosition);
+    memcpy(block->data + (m_writePosition - start), pBuffer + nWritten, (size_t)size);
+
+    if (m_writePosition <= block->end && m_writePosition + size >= block->begin)
+    {
+      block->begin = std::min(block->begin, m_writePosition);
+      block->end = std::max(block->end, m_writePosition + size);
+    }
+    else
+    { // a separate range, keep whichever we are writing
+      block->begin = m_writePosition;
+      block->end = m_writePosition + size;
+    }
+    block->lastUsed = ++m_clock;
+
+    m_writePosition += size;
+    nWritten += size;
+  }
+
+  if (nWritten > 0)
+    m_written.Set();
+
+  return (int)nWritten;
+}
+
+int CSegmentedCache::ReadFromCache(char *pBuffer, size_t iMaxSize)
+{
+  CSingleLock lock(m_sync);
+
+  size_t nRead = 0;
+  while (nRead < iMaxSize)
+  {
+    Block *block = GetBlock(m_readPosition, true);
+    if (!block || m_readPosition < block->begin || m_readPosition >= block->end)
+      break;
+
+    size_t size = (size_t)std::min((int64_t)(iMaxSize - nRead), block->end - m_readPosition);
+    memcpy(pBuffer + nRead, block->data + (m_readPosition - BlockStart(m_readPosition)), size);
+    block->lastUsed = ++m_clock;
+
+    m_readPosition += size;
+    nRead += size;
+  }
+
+  if (nRead == 0)
+  {
+    if (m_length >= 0 && m_readPosition >= m_length)
+      return CACHE_RC_EOF;
+    m_readMisses++;
+    return CACHE_RC_WOULD_BLOCK;
+  }
+
+  m_readHits++;
+  m_space.Set();
+  return (int)nRead;
+}
+
+bool CSegmentedCache::AtEnd() const
+{
+  // the source may have reached the end some way past a gap the reader still has to have filled
+  return m_length >= 0 && GetCachedEnd(m_readPosition) >= m_length;
+}
+
+int64_t CSegmentedCache::WaitForData(unsigned int iMinAvail, unsigned int iMillis)
+{
+  CSingleLock lock(m_sync);
+  int64_t available = GetCachedEnd(m_readPosition) - m_readPosition;
+  if (iMillis == 0 || AtEnd())
+    return available;
+
+  unsigned int time = CTimeUtils::GetTimeMS() + iMillis;
+  while (!AtEnd() && available < iMinAvail && CTimeUtils::GetTimeMS() < time)
+  {
+    lock.Leave();
+    m_written.WaitMSec(50); // may miss the deadline. shouldn't be a problem.
+    lock.Enter();
+    available = GetCachedEnd(m_readPosition) - m_readPosition;
+  }
+
+  return available;
+}
+
+int64_t CSegmentedCache::Seek(int64_t iFilePosition, int iWhence)
+{
+  if (iWhence != SEEK_SET)
+  {
+    // sanity. we should always get here with SEEK_SET
+    CLog::Log(LOGERROR, "%s, only SEEK_SET supported.", __FUNCTION__);
+    return CACHE_RC_ERROR;
+  }
+
+  CSingleLock lock(m_sync);
+
+  // if seek is a bit over what the writer has got to, try to wait a few seconds for the data to be available.
+  // we try to avoid a (heavy) seek on the source
+  if (iFilePosition > m_writePosition && iFilePosition < m_writePosition + CACHE_SEEK_WAIT_SIZE &&
+      m_writePosition >= m_readPosition && iFilePosition < m_readPosition + m_readAhead &&
+      GetCachedEnd(iFilePosition) == iFilePosition)
+  {
+    unsigned int time = CTimeUtils::GetTimeMS() + 5000;
+    while (!AtEnd() && m_writePosition <= iFilePosition && CTimeUtils::GetTimeMS() < time)
+    {
+      lock.Leave();
+      m_written.WaitMSec(50);
+      lock.Enter();
+    }
+  }
+
+  if (GetCachedEnd(iFilePosition) > iFilePosition || iFilePosition == m_writePosition)
+  {
+    m_readPosition = iFilePosition;
+    m_seekHits++;
+    m_space.Set();
+    return m_readPosition;
+  }
+
+  // nothing held there. return error.
+  m_seekMisses++;
+  return CACHE_RC_ERROR;
+}
+
+void CSegmentedCache::Reset(int64_t iSourcePosition)
+{
+  CSingleLock lock(m_sync);
+  // blocks are kept, seeking back to them is still served from the cache
+  m_readPosition = iSourcePosition;
+  m_writePosition = iSourcePosition;
+}
+
+void CSegmentedCache::EndOfInput()
+{
+  CSingleLock lock(m_sync);
+  CCacheStrategy::EndOfInput();
+  m_length = m_writePosition;
+  m_written.Set();
+}
+
+int64_t CSegmentedCache::GetFillPosition()
+{
+  CSingleLock lock(m_sync);
+  int64_t end = GetCachedEnd(m_readPosition);
+  if (end == m_writePosition || (m_length >= 0 && end >= m_length) || end - m_readPosition >= m_readAhead)
+    return -1;
+  return end;
+}
+
+void CSegmentedCache::SetFillPosition(int64_t iSourcePosition)
+{
+  CSingleLock lock(m_sync);
+  m_writePosition = iSourcePosition;
+  CCacheStrategy::ClearEndOfInput();
+}
+
+int64_t CSegmentedCache::SetReadAhead(int64_t iBytes)
+{
+  CSingleLock lock(m_sync);
+  iBytes = std::min(std::max(iBytes, (int64_t)CACHE_MIN_READAHEAD), (int64_t)m_maxReadAhead);
+  m_readAhead = (unsigned int)(iBytes - iBytes % CACHE_BLOCK_SIZE);
+  m_space.Set();
+  return m_readAhead;
+}
+
+float CSegmentedCache::GetSeekHitRate() const
+{
+  unsigned int seeks = m_seekHits + m_seekMisses;
+  return seeks ? (float)m_seekHits / seeks : 0.0f;
+}
+
+float CSegmentedCache::GetReadHitRate() const
+{
+  unsigned int reads = m_readHits + m_readMisses;
+  return reads ? (float)m_readHits / reads : 0.0f;
+}
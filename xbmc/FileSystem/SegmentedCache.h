@@ -0,0 +1,125 @@
+/*
+ *      Copyright (C) 2005-2010 Team XBMC
+ *      http://www.xbmc.org
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, write to
+ *  the Free Software Foundation, 675 Mass Ave, Cambridge, MA 02139, USA.
+ *  http://www.gnu.org/copyleft/gpl.html
+ *
+ */
+
+#ifndef SEGMENTEDCACHE_H
+#define SEGMENTEDCACHE_H
+
+#include "CacheStrategy.h"
+#include "utils/CriticalSection.h"
+#include "utils/Event.h"
+
+#include <map>
+
+namespace XFILE {
+
+/**
+  Keeps the stream in fixed size blocks, indexed by their position in the file, rather than
+  as a window around the read position.  Any number of disjoint ranges are kept, so seeking
+  back to a chapter already watched, or back and forth around the same spot, is served from
+  memory without the source being restarted.  Once the memory budget is used up the least
+  recently used blocks, outside of the window around the reader, make room for new ones.
+  Those may be written to a temporary file to be read back later rather than dropped.
+
+  The writer is pointed at the end of the data following the reader (see GetFillPosition())
+  whenever that isn't where it's already writing.
+*/
+class CSegmentedCache : public CCacheStrategy
+{
+public:
+  CSegmentedCache();
+  virtual ~CSegmentedCache();
+
+  virtual int Open();
+  virtual int Close();
+
+  virtual int WriteToCache(const char *pBuffer, size_t iSize);
+  virtual int ReadFromCache(char *pBuffer, size_t iMaxSize);
+  virtual int64_t WaitForData(unsigned int iMinAvail, unsigned int iMillis);
+
+  virtual int64_t Seek(int64_t iFilePosition, int iWhence);
+  virtual void Reset(int64_t iSourcePosition);
+  virtual void EndOfInput();
+
+  virtual int64_t GetFillPosition();
+  virtual void SetFillPosition(int64_t iSourcePosition);
+  virtual int64_t SetReadAhead(int64_t iBytes);
+
+  /** Fraction of seeks that were served without moving the source */
+  float GetSeekHitRate() const;
+  /** Fraction of reads that found data waiting for them */
+  float GetReadHitRate() const;
+
+protected:
+  struct Block
+  {
+    int64_t begin;          ///< range of the file held, within the block's span
+    int64_t end;
+    unsigned int lastUsed;
+    char *data;
+  };
+
+  struct SpilledBlock
+  {
+    int64_t offset;         ///< where the range is held in the spill file
+    int64_t begin;
+    int64_t end;
+  };
+
+  typedef std::map<int64_t, Block> BlockMap;
+  typedef std::map<int64_t, SpilledBlock> SpillMap;
+
+  static int64_t BlockStart(int64_t position);
+  int64_t GetCachedEnd(int64_t position) const;
+  bool AtEnd() const;
+  Block *GetBlock(int64_t position, bool reload);
+  Block *AllocateBlock(int64_t start);
+  bool IsProtected(int64_t start) const;
+  void Spill(int64_t start, const Block &block);
+  bool Reload(int64_t start, Block &block);
+  void Clear();
+
+  BlockMap m_blocks;
+  unsigned int m_maxBlocks;
+  unsigned int m_readAhead;   ///< how far the writer may get ahead of the reader
+  unsigned int m_maxReadAhead;
+  unsigned int m_clock;       ///< for finding the least recently used block
+
+  int64_t m_readPosition;
+  int64_t m_writePosition;
+  int64_t m_length;           ///< where the source ended, -1 until it does
+
+  CSimpleFileCache *m_spill;
+  SpillMap m_spilled;
+  int64_t m_spillSize;
+  bool m_spillFailed;
+
+  unsigned int m_seekHits;
+  unsigned int m_seekMisses;
+  unsigned int m_readHits;
+  unsigned int m_readMisses;
+  unsigned int m_reloads;
+
+  CCriticalSection m_sync;
+  CEvent m_written;
+};
+
+} // namespace XFILE
+#endif
@@ -31,6 +31,8 @@
 #include "utils/log.h"
 #include "TextureCache.h"
 #include "SystemGlobals.h"
+#include "AdvancedSettings.h"
+#include <algorithm>
 
 using namespace std;
 
@@ -74,11 +76,11 @@ bool CImageLoader::DoWork()
   return true;
 }
 
-CGUILargeTextureManager::CLargeTexture::CLargeTexture(const CStdString &path)
+CGUILargeTextureManager::CLargeTexture::CLargeTexture(const CStdString &path, unsigned int refCount)
 {
   m_path = path;
-  m_refCount = 1;
-  m_timeToDelete = 0;
+  m_refCount = refCount;
+  m_timeUnused = CTimeUtils::GetFrameTime();
 }
 
 CGUILargeTextureManager::CLargeTexture::~CLargeTexture()
@@ -101,20 +103,23 @@ bool CGUILargeTextureManager::CLargeTexture::DecrRef(bool deleteImmediately)
     if (deleteImmediately)
       delete this;
     else
-      m_timeToDelete = CTimeUtils::GetFrameTime() + TIME_TO_DELETE;
+      Touch();
     return true;
   }
   return false;
 }
 
-bool CGUILargeTextureManager::CLargeTexture::DeleteIfRequired(bool deleteImmediately)
+void CGUILargeTextureManager::CLargeTexture::Touch()
 {
-  if (m_refCount == 0 && (deleteImmediately || m_timeToDelete < CTimeUtils::GetFrameTime()))
-  {
-    delete this;
-    return true;
-  }
-  return false;
+  m_timeUnused = CTimeUtils::GetFrameTime();
+}
+
+uint32_t CGUILargeTextureManager::CLargeTexture::GetMemoryUsage() const
+{
+  uint32_t memUsage = 0;
+  for (unsigned int i = 0; i < m_texture.m_textures.size(); i++)
+    memUsage += m_texture.m_textures[i]->GetPitch() * m_texture.m_textures[i]->GetRows();
+  return memUsage;
 }
 
 void CGUILargeTextureManager::CLargeTexture::SetTexture(CBaseTexture* texture)
@@ -122,10 +127,12 @@ void CGUILargeTextureManager::CLargeTexture::SetTexture(CBaseTexture* texture)
   assert(!m_texture.size());
   if (texture)
     m_texture.Set(texture, texture->GetWidth(), texture->GetHeight());
+  Touch();
 }
 
 CGUILargeTextureManager::CGUILargeTextureManager()
 {
+  m_lookups = 0;
 }
 
 CGUILargeTextureManager::~CGUILargeTextureManager()
@@ -135,16 +142,91 @@ CGUILargeTextureManager::~CGUILargeTextureManager()
 void CGUILargeTextureManager::CleanupUnusedImages(bool immediately)
 {
   CSingleLock lock(m_listSection);
-  // check for items to remove from allocated list, and remove
-  listIterator it = m_allocated.begin();
-  while (it != m_allocated.end())
+
+  // find the unused images, and how much memory we're using
+  uint32_t memUsage = 0;
+  multimap<unsigned int, listIterator> unused; // time unused -> image, oldest first
+  for (listIterator it = m_allocated.begin(); it != m_allocated.end(); ++it)
   {
-    CLargeTexture *image = *it;
-    if (image->DeleteIfRequired(immediately))
-      it = m_allocated.erase(it);
+    CLargeTexture *image = it->second;
+    memUsage += image->GetMemoryUsage();
+    if (image->IsUnused())
+      unused.insert(make_pair(image->GetTimeUnused(), it));
+  }
+
+  uint32_t budget = (uint32_t)g_advancedSettings.m_largeTextureBudget * 1024 * 1024;
+  if (!immediately && memUsage <= budget)
+    return;
+
+  // unload the least recently used until we fit
+  for (multimap<unsigned int, listIterator>::iterator it = unused.begin(); it != unused.end() && (immediately || memUsage > budget); ++it)
+  {
+    CLargeTexture *image = it->second->second;
+    memUsage -= image->GetMemoryUsage();
+    m_allocated.erase(it->second);
+    delete image;
+  }
+}
+
+void CGUILargeTextureManager::PrefetchImages(const vector<CStdString> &paths)
+{
+  CSingleLock lock(m_listSection);
+
+  // cancel earlier prefetches that nobody has asked for and that are no longer wanted
+  queueIterator it = m_queued.begin();
+  while (it != m_queued.end())
+  {
+    CLargeTexture *image = it->second.second;
+    if (image->IsUnused() && find(paths.begin(), paths.end(), image->GetPath()) == paths.end())
+    {
+      CJobManager::GetInstance().CancelJob(it->second.first);
+      delete image;
+      m_queued.erase(it++);
+    }
     else
       ++it;
   }
+
+  for (vector<CStdString>::const_iterator path = paths.begin(); path != paths.end(); ++path)
+  {
+    unsigned int hash = CGUITextureManager::GetNameHash(*path);
+    bool found = false;
+
+    pair<listIterator, listIterator> range = m_allocated.equal_range(hash);
+    for (listIterator it = range.first; it != range.second && !found; ++it)
+    {
+      if (it->second->GetPath() == *path)
+      {
+        // about to be wanted, so don't let it be the next to go
+        if (it->second->IsUnused())
+          it->second->Touch();
+        found = true;
+      }
+    }
+
+    pair<queueIterator, queueIterator> queued = m_queued.equal_range(hash);
+    for (queueIterator it = queued.first; it != queued.second && !found; ++it)
+    {
+      if (it->second.second->GetPath() == *path)
+        found = true;
+    }
+
+    if (!found)
+    {
+      CLargeTexture *image = new CLargeTexture(*path, 0);
+      unsigned int jobID = CJobManager::GetInstance().AddJob(new CImageLoader(*path), this, CJob::PRIORITY_LOW);
+      m_queued.insert(make_pair(hash, make_pair(jobID, image)));
+    }
+  }
+}
+
+uint32_t CGUILargeTextureManager::GetMemoryUsage() const
+{
+  CSingleLock lock(m_listSection);
+  uint32_t memUsage = 0;
+  for (allocatedList::const_iterator it = m_allocated.begin(); it != m_allocated.end(); ++it)
+    memUsage += it->second->GetMemoryUsage();
+  return memUsage;
 }
 
 // if available, increment reference count, and return the image.
@@ -153,9 +235,12 @@ bool CGUILargeTextureManager::GetImage(const CStdString &path, CTextureArray &te
 {
   // note: max size to load images: 2048x1024? (8MB)
   CSingleLock lock(m_listSection);
-  for (listIterator it = m_allocated.begin(); it != m_allocated.end(); ++it)
+  m_lookups++;
+  unsigned int hash = CGUITextureManager::GetNameHash(path);
+  pair<listIterator, listIterator> range = m_allocated.equal_range(hash);
+  for (listIterator it = range.first; it != range.second; ++it)
   {
-    CLargeTexture *image = *it;
+    CLargeTexture *image = it->second;
     if (image->GetPath() == path)
     {
       if (firstRequest)
@@ -166,7 +251,7 @@ bool CGUILargeTextureManager::GetImage(const CStdString &path, CTextureArray &te
   }
 
   if (firstRequest)
-    QueueImage(path);
+    QueueImage(path, hash);
 
   return true;
 }
@@ -174,9 +259,12 @@ bool CGUILargeTextureManager::GetImage(const CStdString &path, CTextureArray &te
 void CGUILargeTextureManager::ReleaseImage(const CStdString &path, bool immediately)
 {
   CSingleLock lock(m_listSection);
-  for (listIterator it = m_allocated.begin(); it != m_allocated.end(); ++it)
+  m_lookups++;
+  unsigned int hash = CGUITextureManager::GetNameHash(path);
+  pair<listIterator, listIterator> range = m_allocated.equal_range(hash);
+  for (listIterator it = range.first; it != range.second; ++it)
   {
-    CLargeTexture *image = *it;
+    CLargeTexture *image = it->second;
     if (image->GetPath() == path)
     {
       if (image->DecrRef(immediately) && immediately)
@@ -184,10 +272,11 @@ void CGUILargeTextureManager::ReleaseImage(const CStdString &path, bool immediat
       return;
     }
   }
-  for (queueIterator it = m_queued.begin(); it != m_queued.end(); ++it)
+  pair<queueIterator, queueIterator> queued = m_queued.equal_range(hash);
+  for (queueIterator it = queued.first; it != queued.second; ++it)
   {
-    unsigned int id = it->first;
-    CLargeTexture *image = it->second;
+    unsigned int id = it->second.first;
+    CLargeTexture *image = it->second.second;
     if (image->GetPath() == path && image->DecrRef(true))
     {
       // cancel this job
@@ -199,14 +288,18 @@ void CGUILargeTextureManager::ReleaseImage(const CStdString &path, bool immediat
 }
 
 // queue the image, and start the background loader if necessary
-void CGUILargeTextureManager::QueueImage(const CStdString &path)
+void CGUILargeTextureManager::QueueImage(const CStdString &path, unsigned int hash)
 {
   CSingleLock lock(m_listSection);
-  for (queueIterator it = m_queued.begin(); it != m_queued.end(); ++it)
+  pair<queueIterator, queueIterator> range = m_queued.equal_range(hash);
+  for (queueIterator it = range.first; it != range.second; ++it)
   {
-    CLargeTexture *image = it->second;
+    CLargeTexture *image = it->second.second;
     if (image->GetPath() == path)
     {
+      // prefetched, and now on screen, so it shouldn't wait behind everything else
+      if (image->IsUnused())
+        CJobManager::GetInstance().RaisePriority(it->second.first, CJob::PRIORITY_NORMAL);
       image->AddRef();
       return; // already queued
     }
@@ -215,23 +308,25 @@ void CGUILargeTextureManager::QueueImage(const CStdString &path)
   // queue the item
   CLargeTexture *image = new CLargeTexture(path);
   unsigned int jobID = CJobManager::GetInstance().AddJob(new CImageLoader(path), this, CJob::PRIORITY_NORMAL);
-  m_queued.push_back(make_pair(jobID, image));
+  m_queued.insert(make_pair(hash, make_pair(jobID, image)));
 }
 
 void CGUILargeTextureManager::OnJobComplete(unsigned int jobID, bool success, CJob *job)
 {
   // see if we still have this job id
   CSingleLock lock(m_listSection);
-  for (queueIterator it = m_queued.begin(); it != m_queued.end(); ++it)
+  CImageLoader *loader = (CImageLoader *)job;
+  unsigned int hash = CGUITextureManager::GetNameHash(loader->m_path);
+  pair<queueIterator, queueIterator> range = m_queued.equal_range(hash);
+  for (queueIterator it = range.first; it != range.second; ++it)
   {
-    if (it->first == jobID)
+    if (it->second.first == jobID)
     { // found our job
-      CImageLoader *loader = (CImageLoader *)job;
-      CLargeTexture *image = it->second;
+      CLargeTexture *image = it->second.second;
       image->SetTexture(loader->m_texture);
       loader->m_texture = NULL; // we want to keep the texture, and jobs are auto-deleted.
       m_queued.erase(it);
-      m_allocated.push_back(image);
+      m_allocated.insert(make_pair(hash, image));
       return;
     }
   }
@@ -92,56 +92,83 @@ public:
    \brief Request a texture to be unloaded.
 
    When textures are finished with, this function should be called.  This decrements the texture's
-   reference count, and schedules it to be unloaded once the reference count reaches zero.  If the
-   texture is still queued for loading, or is in the process of loading, the image load is cancelled.
+   reference count, and once it reaches zero the image may be unloaded when the images no longer fit
+   the memory budget.  If the texture is still queued for loading, or is in the process of loading,
+   the image load is cancelled.
 
    \param path path of the image to release.
    \param immediately if set true the image is immediately unloaded once its reference count reaches zero
-                      rather than being unloaded after a delay.
+                      rather than being kept until the memory is needed.
    */
   void ReleaseImage(const CStdString &path, bool immediately = false);
 
+  /*!
+   \brief Request images to be loaded ahead of being shown.
+
+   Images not already loaded or queued are loaded in the background at low priority without being
+   referenced, so they're ready by the time GetImage() asks for them and are otherwise unloaded like
+   any other unused image.  Prefetches from a previous call that haven't been asked for and aren't in
+   this list are cancelled, so callers should pass everything they still want each time.
+
+   \param paths paths of the images to load, most wanted first.
+   \sa GetImage()
+   */
+  void PrefetchImages(const std::vector<CStdString> &paths);
+
   /*!
    \brief Cleanup images that are no longer in use.
 
    Loaded textures are reference counted, and upon reaching reference count 0 through ReleaseImage()
-   they are flagged as unused with the current time.  After a delay they may be unloaded, hence
-   CleanupUnusedImages() should be called periodically to ensure this occurs.
+   they are flagged as unused with the current time.  Once the loaded images take more than the
+   <largetexturebudget> the least recently used of them are unloaded, hence CleanupUnusedImages()
+   should be called periodically to ensure this occurs.
 
-   \param immediately set to true to cleanup images regardless of whether the delay has passed
+   \param immediately set to true to cleanup all unused images regardless of the budget
    */
   void CleanupUnusedImages(bool immediately = false);
 
+  uint32_t GetMemoryUsage() const;                                      ///< Bytes held by loaded images
+  unsigned int GetImageCount() const { return m_allocated.size(); }    ///< Loaded images, including unused ones not yet freed
+  unsigned int GetQueuedCount() const { return m_queued.size(); }
+  unsigned int GetLookupCount() const { return m_lookups; }            ///< Path lookups since startup
+
 private:
   class CLargeTexture
   {
   public:
-    CLargeTexture(const CStdString &path);
+    CLargeTexture(const CStdString &path, unsigned int refCount = 1);
     virtual ~CLargeTexture();
 
     void AddRef();
     bool DecrRef(bool deleteImmediately);
-    bool DeleteIfRequired(bool deleteImmediately = false);
+    bool IsUnused() const { return m_refCount == 0; };
+    unsigned int GetTimeUnused() const { return m_timeUnused; };
+    void Touch();
     void SetTexture(CBaseTexture* texture);
 
     const CStdString &GetPath() const { return m_path; };
     const CTextureArray &GetTexture() const { return m_texture; };
+    uint32_t GetMemoryUsage() const;
 
   private:
-    static const unsigned int TIME_TO_DELETE = 2000;
-
     unsigned int m_refCount;
     CStdString m_path;
     CTextureArray m_texture;
-    unsigned int m_timeToDelete;
+    unsigned int m_timeUnused; ///< frame time it was last wanted, for least recently used eviction
   };
 
-  void QueueImage(const CStdString &path);
+  void QueueImage(const CStdString &path, unsigned int hash);
+
+  // Both lists are indexed by a hash of the path (CGUITextureManager::GetNameHash), as they're
+  // searched for every large image control every frame.
+  typedef std::multimap<unsigned int, std::pair<unsigned int, CLargeTexture *> > queueList; ///< hash -> (job id, image)
+  typedef std::multimap<unsigned int, CLargeTexture *> allocatedList;                        ///< hash -> image
+  queueList m_queued;
+  allocatedList m_allocated;
+  typedef allocatedList::iterator listIterator;
+  typedef queueList::iterator queueIterator;
 
-  std::vector< std::pair<unsigned int, CLargeTexture *> > m_queued;
-  std::vector<CLargeTexture *> m_allocated;
-  typedef std::vector<CLargeTexture *>::iterator listIterator;
-  typedef std::vector< std::pair<unsigned int, CLargeTexture *> >::iterator queueIterator;
+  unsigned int m_lookups;
 
   CCriticalSection m_listSection;
 };
@@ -69,6 +69,7 @@
 #include "utils/Builtins.h"
 #include "PlexMediaServerQueue.h"
 #include "PlexSourceScanner.h"
+#include "PlexDirectoryExecutor.h"
 
 #define CONTROL_BTNVIEWASICONS     2
 #define CONTROL_BTNSORTBY          3
@@ -127,12 +128,15 @@ CGUIMediaWindow::CGUIMediaWindow(int id, const char *xmlFile)
   m_iLastControl = -1;
   m_iSelectedItem = -1;
   m_mediaRefresher = NULL;
+  m_pageJobID = 0;
 
   m_guiState.reset(CGUIViewState::GetViewState(GetID(), *m_vecItems));
 }
 
 CGUIMediaWindow::~CGUIMediaWindow()
 {
+  CancelPageLoad();
+
   if (m_mediaRefresher)
     m_mediaRefresher->die();
   
@@ -294,6 +298,8 @@ bool CGUIMediaWindow::OnMessage(CGUIMessage& message)
         m_mediaRefresher = NULL;
       }
       
+      CancelPageLoad();
+      
       CGUIWindow::OnMessage(message);
       // Call ClearFileItems() after our window has finished doing any WindowClose
       // animations
@@ -502,6 +508,16 @@ bool CGUIMediaWindow::OnMessage(CGUIMessage& message)
       return true;
     }
     break;
+  case GUI_MSG_PAGE_LOADED:
+    {
+      // Drop pages for listings we've since navigated away from.
+      if ((unsigned int)message.GetParam1() == m_pageJobID && message.GetItem())
+      {
+        m_pageJobID = 0;
+        OnPageLoaded(*(CFileItemList* )message.GetItem().get());
+      }
+      return true;
+    }
   case GUI_MSG_PLAYBACK_STARTED:
   case GUI_MSG_PLAYBACK_ENDED:
   case GUI_MSG_PLAYBACK_STOPPED:
@@ -828,7 +844,11 @@ bool CGUIMediaWindow::Update(const CStdString &strDirectory)
 
   m_history.SetSelectedItem(strSelectedItem, strOldDirectory);
 
+  // Any page still loading belongs to the listing we're replacing.
+  CancelPageLoad();
+
   CFileItemList items;
+  items.m_pageSize = g_advancedSettings.m_plexPageSize;
   
   // Save the default view mode.
   if (strOldDirectory == strDirectory)
@@ -986,6 +1006,9 @@ bool CGUIMediaWindow::Update(const CStdString &strDirectory)
     OnMessage(msg);
   }
   
+  // Fetch the rest of a paged listing in the background.
+  LoadNextPage();
+  
   return true;
 }
 
@@ -1862,3 +1885,82 @@ void CGUIMediaWindow::Render()
   
   CGUIWindow::Render();
 }
+
+// \brief Queue a background fetch of the next page of the current listing,
+// if the source told us there's more than we've got.
+void CGUIMediaWindow::LoadNextPage()
+{
+  CancelPageLoad();
+
+  if (m_vecItems->HasMorePages() && g_advancedSettings.m_plexPageSize > 0)
+  {
+    CPlexDirectoryJob* job = new CPlexDirectoryJob(m_vecItems->m_strPath, m_vecItems->m_pageEnd, g_advancedSettings.m_plexPageSize);
+    m_pageJobID = CPlexDirectoryExecutor::Get().AddJob(job, this);
+  }
+}
+
+void CGUIMediaWindow::CancelPageLoad()
+{
+  if (m_pageJobID)
+  {
+    CPlexDirectoryExecutor::Get().CancelJob(m_pageJobID);
+    m_pageJobID = 0;
+  }
+}
+
+// \brief Called on a worker thread; hand the page over to the GUI thread.
+void CGUIMediaWindow::OnJobComplete(unsigned int jobID, bool success, CJob *job)
+{
+  if (success == false)
+  {
+    CLog::Log(LOGERROR, "%s - Unable to load next page of %s", __FUNCTION__, ((CPlexDirectoryJob* )job)->m_url.c_str());
+    return;
+  }
+
+  CFileItemListPtr page(new CFileItemList());
+  page->Assign(((CPlexDirectoryJob* )job)->m_items);
+
+  CGUIMessage msg(GUI_MSG_PAGE_LOADED, GetID(), 0, jobID, 0, CGUIListItemPtr(page));
+  g_windowManager.SendThreadMessage(msg, GetID());
+}
+
+// \brief Append a freshly loaded page to the listing, keeping the selection.
+void CGUIMediaWindow::OnPageLoaded(CFileItemList &page)
+{
+  OnPrepareFileItems(page);
+  page.FillInDefaultIcons();
+
+  m_unfilteredItems->Append(page);
+  m_vecItems->m_totalSize = page.m_totalSize;
+
+  // A page that didn't get us any further would be asked for again and again, so take the
+  // listing as complete, whatever size the server claims it has.
+  if (page.m_pageEnd <= m_vecItems->m_pageEnd)
+  {
+    CLog::Log(LOGWARNING, "%s - Empty page at %d of %d in %s, not loading any more", __FUNCTION__, m_vecItems->m_pageEnd, page.m_totalSize, m_vecItems->m_strPath.c_str());
+    m_vecItems->m_totalSize = m_vecItems->m_pageEnd;
+  }
+  else
+  {
+    m_vecItems->m_pageEnd = page.m_pageEnd;
+  }
+
+  CStdString filter(GetProperty("filter"));
+  if (filter.IsEmpty())
+  {
+    m_vecItems->Append(page);
+    FormatAndSort(*m_vecItems);
+    m_viewControl.SetItems(*m_vecItems);
+    UpdateButtons();
+  }
+  else
+  {
+    FormatAndSort(*m_unfilteredItems);
+    OnFilterItems(filter);
+  }
+
+  if (GetBackgroundLoader())
+    GetBackgroundLoader()->Load(*m_vecItems);
+
+  LoadNextPage();
+}
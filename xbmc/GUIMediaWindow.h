@@ -28,6 +28,7 @@
 #include "GUIDialogContextMenu.h"
 #include "BackgroundInfoLoader.h"
 #include "FileItem.h"
+#include "utils/Job.h"
 
 class CFileItemList;
 class MediaRefresher;
@@ -35,7 +36,7 @@ class MediaRefresher;
 #define CONTENT_LIST_FILTERS 13000
 
 // base class for all media windows
-class CGUIMediaWindow : public CGUIWindow
+class CGUIMediaWindow : public CGUIWindow, public IJobCallback
 {
 public:
   CGUIMediaWindow(int id, const char *xmlFile);
@@ -60,6 +61,9 @@ public:
     m_updatedItem = CFileItemPtr(pItem); 
   }
 
+  // PLEX: Background page loads for large sections.
+  virtual void OnJobComplete(unsigned int jobID, bool success, CJob *job);
+
 protected:
   virtual void LoadAdditionalTags(TiXmlElement *root);
   CGUIControl *GetFirstFocusableControl(int id);
@@ -112,6 +116,11 @@ protected:
   void UpdateFileList();
   virtual void OnDeleteItem(int iItem);
   void OnRenameItem(int iItem);
+
+  // PLEX: Paged listings.
+  void LoadNextPage();
+  void CancelPageLoad();
+  void OnPageLoaded(CFileItemList &page);
   
   virtual void Render();
   
@@ -139,6 +148,7 @@ protected:
   
   MediaRefresher* m_mediaRefresher;
   CStopWatch m_refreshTimer;
+  unsigned int m_pageJobID;
 
   // save control state on window exit
   int m_iLastControl;
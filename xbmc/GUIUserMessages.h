@@ -150,3 +150,5 @@
 // Send when a search helper has finished.
 #define GUI_MSG_SEARCH_HELPER_COMPLETE GUI_MSG_USER + 47
 
+// Send when the next page of a paged listing has arrived.
+#define GUI_MSG_PAGE_LOADED GUI_MSG_USER + 48
@@ -324,7 +324,7 @@ void CGUIWindowHome::UpdateContentForSelectedItem(const std::string& key)
         // Asynchronously fetch the fanart for the section.
         globalArt = false;
         m_globalArt = false;
-        m_workerManager->enqueue(WINDOW_HOME, AppendPathToURL(sectionUrl, "arts"), CONTENT_LIST_FANART);
+        m_workerManager->enqueue(WINDOW_HOME, AppendPathToURL(sectionUrl, "arts"), CONTENT_LIST_FANART, CJob::PRIORITY_LOW);
       }
     }
     else if (itemID >= 1 && itemID <= 4)
@@ -342,7 +342,7 @@ void CGUIWindowHome::UpdateContentForSelectedItem(const std::string& key)
       m_globalArt = true;
       
       if (g_guiSettings.GetBool("lookandfeel.enableglobalslideshow") == true)
-        m_workerManager->enqueue(WINDOW_HOME, "http://127.0.0.1:32400/library/arts", CONTENT_LIST_FANART);
+        m_workerManager->enqueue(WINDOW_HOME, "http://127.0.0.1:32400/library/arts", CONTENT_LIST_FANART, CJob::PRIORITY_LOW);
       else
         SET_CONTROL_HIDDEN(SLIDESHOW_MULTIIMAGE);
     }
@@ -672,7 +672,7 @@ bool CGUIWindowHome::OnMessage(CGUIMessage& message)
       else
       {
         if (g_guiSettings.GetBool("lookandfeel.enableglobalslideshow") == true)
-          m_workerManager->enqueue(WINDOW_HOME, "http://127.0.0.1:32400/library/arts", CONTENT_LIST_FANART);
+          m_workerManager->enqueue(WINDOW_HOME, "http://127.0.0.1:32400/library/arts", CONTENT_LIST_FANART, CJob::PRIORITY_LOW);
         else
           SET_CONTROL_HIDDEN(SLIDESHOW_MULTIIMAGE);
       }
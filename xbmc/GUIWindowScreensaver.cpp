@@ -44,6 +44,9 @@ void CGUIWindowScreensaver::Render()
 {
   CSingleLock lock (m_critSection);
 
+  // the addon may draw anything, anywhere
+  g_graphicsContext.GetDirtyRegions().MarkDirty();
+
 #ifdef HAS_SCREENSAVER
   if (m_addon)
   {
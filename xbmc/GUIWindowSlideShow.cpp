@@ -273,6 +273,9 @@ void CGUIWindowSlideShow::Render()
   int iSlides = m_slides->Size();
   if (!iSlides) return ;
 
+  // slides are drawn directly, so the tracker can't see them
+  g_graphicsContext.GetDirtyRegions().MarkDirty();
+
   if (m_iNextSlide < 0 || m_iNextSlide >= m_slides->Size())
     m_iNextSlide = 0;
   if (m_iCurrentSlide < 0 || m_iCurrentSlide >= m_slides->Size())
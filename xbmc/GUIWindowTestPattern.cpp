@@ -79,6 +79,10 @@ bool CGUIWindowTestPattern::OnMessage(CGUIMessage& message)
 
 void CGUIWindowTestPattern::Render()
 {
+  // drawn directly, so the tracker can't see it
+  g_graphicsContext.GetDirtyRegions().MarkDirty();
+  g_graphicsContext.FlushBatches();
+
   BeginRender();
 
   int top = g_settings.m_ResInfo[g_graphicsContext.GetVideoResolution()].Overscan.top;
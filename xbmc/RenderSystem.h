@@ -76,6 +76,8 @@ public:
 
   virtual void SetViewPort(CRect& viewPort) = 0;
   virtual void GetViewPort(CRect& viewPort) = 0;
+  virtual void SetScissors(const CRect &rect) = 0;  ///< restrict drawing, including clears, to rect
+  virtual void ResetScissors() = 0;                 ///< draw anywhere in the viewport again
 
   virtual void CaptureStateBlock() = 0;
   virtual void ApplyStateBlock() = 0;
@@ -32,6 +32,7 @@
 #include "GUISettings.h"
 #include "AdvancedSettings.h"
 #include "utils/SystemInfo.h"
+#include "MathUtils.h"
 #include "Application.h"
 #include "Util.h"
 #include "win32/WIN32Util.h"
@@ -905,6 +906,28 @@ void CRenderSystemDX::SetViewPort(CRect& viewPort)
   m_pD3DDevice->SetViewport(&newviewport);
 }
 
+void CRenderSystemDX::SetScissors(const CRect& rect)
+{
+  if (!m_bRenderCreated)
+    return;
+
+  RECT scissor;
+  scissor.left   = MathUtils::round_int(rect.x1);
+  scissor.top    = MathUtils::round_int(rect.y1);
+  scissor.right  = MathUtils::round_int(rect.x2);
+  scissor.bottom = MathUtils::round_int(rect.y2);
+  m_pD3DDevice->SetScissorRect(&scissor);
+  m_pD3DDevice->SetRenderState(D3DRS_SCISSORTESTENABLE, TRUE);
+}
+
+void CRenderSystemDX::ResetScissors()
+{
+  if (!m_bRenderCreated)
+    return;
+
+  m_pD3DDevice->SetRenderState(D3DRS_SCISSORTESTENABLE, FALSE);
+}
+
 void CRenderSystemDX::Register(ID3DResource *resource)
 {
   CSingleLock lock(m_resourceSection);
@@ -46,6 +46,8 @@ public:
 
   virtual void SetViewPort(CRect& viewPort);
   virtual void GetViewPort(CRect& viewPort);
+  virtual void SetScissors(const CRect &rect);
+  virtual void ResetScissors();
 
   virtual void CaptureStateBlock();
   virtual void ApplyStateBlock();
@@ -74,6 +76,7 @@ protected:
   bool       m_bVsyncInit;
   int        m_width;
   int        m_height;
+  int        m_viewPort[4]; ///< GL viewport, kept here as the scissor box no longer always matches it
 
   CStdString m_RenderExtensions;
 
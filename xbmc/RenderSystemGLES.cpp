@@ -31,6 +31,7 @@
 #include "utils/log.h"
 #include "utils/TimeUtils.h"
 #include "utils/SystemInfo.h"
+#include "MathUtils.h"
 
 
 CRenderSystemGLES::CRenderSystemGLES()
@@ -38,6 +39,7 @@ CRenderSystemGLES::CRenderSystemGLES()
  , m_pGUIshader(0)
 {
   m_enumRenderingSystem = RENDERING_SYSTEM_OPENGLES;
+  memset(m_viewPort, 0, sizeof(m_viewPort));
 }
 
 CRenderSystemGLES::~CRenderSystemGLES()
@@ -100,6 +102,9 @@ bool CRenderSystemGLES::ResetRenderSystem(int width, int height, bool fullScreen
 
   CRect rect( 0, 0, width, height );
   SetViewPort( rect );
+  m_viewPort[0] = m_viewPort[1] = 0;
+  m_viewPort[2] = width;
+  m_viewPort[3] = height;
 
   glEnable(GL_TEXTURE_2D); 
   glEnable(GL_SCISSOR_TEST); 
@@ -460,14 +465,11 @@ void CRenderSystemGLES::GetViewPort(CRect& viewPort)
 {
   if (!m_bRenderCreated)
     return;
-  
-  GLint glvp[4];
-  glGetIntegerv(GL_SCISSOR_BOX, glvp);
-  
-  viewPort.x1 = glvp[0];
-  viewPort.y1 = m_height - glvp[1] - glvp[3];
-  viewPort.x2 = glvp[0] + glvp[2];
-  viewPort.y2 = viewPort.y1 + glvp[3];
+
+  viewPort.x1 = m_viewPort[0];
+  viewPort.y1 = m_height - m_viewPort[1] - m_viewPort[3];
+  viewPort.x2 = m_viewPort[0] + m_viewPort[2];
+  viewPort.y2 = viewPort.y1 + m_viewPort[3];
 }
 
 // FIXME make me const so that I can accept temporary objects
@@ -478,6 +480,30 @@ void CRenderSystemGLES::SetViewPort(CRect& viewPort)
 
   glScissor((GLint) viewPort.x1, (GLint) (m_height - viewPort.y1 - viewPort.Height()), (GLsizei) viewPort.Width(), (GLsizei) viewPort.Height());
   glViewport((GLint) viewPort.x1, (GLint) (m_height - viewPort.y1 - viewPort.Height()), (GLsizei) viewPort.Width(), (GLsizei) viewPort.Height());
+  m_viewPort[0] = (int) viewPort.x1;
+  m_viewPort[1] = (int) (m_height - viewPort.y1 - viewPort.Height());
+  m_viewPort[2] = (int) viewPort.Width();
+  m_viewPort[3] = (int) viewPort.Height();
+}
+
+void CRenderSystemGLES::SetScissors(const CRect &rect)
+{
+  if (!m_bRenderCreated)
+    return;
+
+  GLint x1 = MathUtils::round_int(rect.x1);
+  GLint y1 = MathUtils::round_int(rect.y1);
+  GLint x2 = MathUtils::round_int(rect.x2);
+  GLint y2 = MathUtils::round_int(rect.y2);
+  glScissor(x1, m_height - y2, x2 - x1, y2 - y1);
+}
+
+void CRenderSystemGLES::ResetScissors()
+{
+  if (!m_bRenderCreated)
+    return;
+
+  glScissor(m_viewPort[0], m_viewPort[1], m_viewPort[2], m_viewPort[3]);
 }
 
 void CRenderSystemGLES::InitialiseGUIShader()
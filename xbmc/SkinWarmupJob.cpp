@@ -0,0 +1,143 @@
+/*
+ *      Copyright (C) 2005-2010 Team XBMC
+ *      http://www.xbmc.org
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, write to
+ *  the Free Software Foundation, 675 Mass Ave, Cambridge, MA 02139, USA.
+ *  http://www.gnu.org/copyleft/gpl.html
+ *
+ */
+#include "SkinWarmupJob.h"
+#include "addons/Skin.h"
+#include "TextureManager.h"
+#include "utils/JobManager.h"
+#include "utils/Stopwatch.h"
+#include "utils/log.h"
+#include "tinyXML/tinyxml.h"
+
+using namespace std;
+
+// few enough per job that idle workers take a share of them
+#define TEXTURES_PER_JOB  8
+
+// includes including each other shouldn't send us round in circles
+#define MAX_INCLUDE_DEPTH 16
+
+CSkinWarmupJob::CSkinWarmupJob(const ADDON::SkinPtr &skin)
+{
+  m_skin = skin;
+}
+
+CSkinWarmupJob::~CSkinWarmupJob()
+{
+  for (unsigned int i = 0; i < m_documents.size(); i++)
+    delete m_documents[i];
+}
+
+bool CSkinWarmupJob::DoWork()
+{
+  CStopWatch timer;
+  timer.StartZero();
+
+  // our own copy of the includes, as the skin's may be in the middle of being loaded
+  LoadIncludes(m_skin->GetSkinPath("includes.xml"));
+
+  CStdString homePath = m_skin->GetSkinPath("Home.xml");
+  TiXmlDocument home;
+  if (!home.LoadFile(homePath) || !home.RootElement())
+    return false;
+
+  set<CStdString> textures;
+  FindTextures(home.RootElement(), textures, 0);
+
+  vector<CStdString> batch;
+  for (set<CStdString>::const_iterator i = textures.begin(); i != textures.end(); ++i)
+  {
+    batch.push_back(*i);
+    if (batch.size() == TEXTURES_PER_JOB)
+    {
+      CJobManager::GetInstance().AddJob(new CPreloadJob(batch), NULL, CJob::PRIORITY_HIGH);
+      batch.clear();
+    }
+  }
+  if (batch.size())
+    CJobManager::GetInstance().AddJob(new CPreloadJob(batch), NULL, CJob::PRIORITY_HIGH);
+
+  CLog::Log(LOGDEBUG, "%s - found %u textures in %s in %.2fms", __FUNCTION__, (unsigned int)textures.size(), homePath.c_str(), timer.GetElapsedMilliseconds());
+  return true;
+}
+
+void CSkinWarmupJob::LoadIncludes(const CStdString &file)
+{
+  if (!m_includeFiles.insert(file).second)
+    return;
+
+  TiXmlDocument *doc = new TiXmlDocument;
+  if (!doc->LoadFile(file) || !doc->RootElement() || doc->RootElement()->ValueStr() != "includes")
+  {
+    delete doc;
+    return;
+  }
+  m_documents.push_back(doc);
+
+  for (const TiXmlElement *node = doc->RootElement()->FirstChildElement("include"); node; node = node->NextSiblingElement("include"))
+  {
+    if (node->Attribute("name") && node->FirstChild())
+      m_includes.insert(make_pair(node->Attribute("name"), node));
+    else if (node->Attribute("file"))
+      LoadIncludes(m_skin->GetSkinPath(node->Attribute("file")));
+  }
+}
+
+void CSkinWarmupJob::FindTextures(const TiXmlElement *element, set<CStdString> &textures, unsigned int depth)
+{
+  if (depth > MAX_INCLUDE_DEPTH)
+    return;
+
+  for (const TiXmlElement *child = element->FirstChildElement(); child; child = child->NextSiblingElement())
+  {
+    CStdString tag = child->ValueStr();
+    tag.ToLower();
+    const char *text = child->FirstChild() ? child->FirstChild()->Value() : NULL;
+
+    if (tag == "include")
+    { // conditional includes are followed either way, a texture we don't need costs little
+      if (child->Attribute("file"))
+        LoadIncludes(m_skin->GetSkinPath(child->Attribute("file")));
+      map<CStdString, const TiXmlElement*>::const_iterator include = text ? m_includes.find(text) : m_includes.end();
+      if (include != m_includes.end())
+        FindTextures(include->second, textures, depth + 1);
+    }
+    else if (tag.Find("texture") >= 0 && text)
+    { // anything built from info labels is only known once the window is up
+      CStdString texture(text);
+      texture.Trim();
+      if (!texture.IsEmpty() && texture != "-" && texture.Find('$') < 0)
+        textures.insert(texture);
+    }
+    else
+      FindTextures(child, textures, depth);
+  }
+}
+
+bool CSkinWarmupJob::CPreloadJob::DoWork()
+{
+  CStopWatch timer;
+  timer.StartZero();
+
+  unsigned int decoded = g_TextureManager.Preload(m_textures);
+
+  CLog::Log(LOGDEBUG, "%s - decoded %u of %u textures in %.2fms", __FUNCTION__, decoded, (unsigned int)m_textures.size(), timer.GetElapsedMilliseconds());
+  return true;
+}
@@ -0,0 +1,69 @@
+#pragma once
+/*
+ *      Copyright (C) 2005-2010 Team XBMC
+ *      http://www.xbmc.org
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, write to
+ *  the Free Software Foundation, 675 Mass Ave, Cambridge, MA 02139, USA.
+ *  http://www.gnu.org/copyleft/gpl.html
+ *
+ */
+#include "system.h"
+#include "StdString.h"
+#include "utils/Job.h"
+#include "addons/IAddon.h"
+
+#include <map>
+#include <set>
+#include <vector>
+
+class TiXmlDocument;
+class TiXmlElement;
+
+/*!
+ \brief Decodes the textures the home window uses while the skin is still being loaded.
+
+ Walks the skin's Home.xml, following its includes, for the textures it names and hands
+ them out in batches to the job manager's workers, which decode them with
+ CGUITextureManager::Preload().  By the time the home window allocates its resources
+ most of its textures only need uploading to the GPU.
+ */
+class CSkinWarmupJob : public CJob
+{
+public:
+  CSkinWarmupJob(const ADDON::SkinPtr &skin);
+  virtual ~CSkinWarmupJob();
+
+  virtual const char *GetType() const { return "skinwarmup"; };
+  virtual bool DoWork();
+
+private:
+  class CPreloadJob : public CJob
+  {
+  public:
+    CPreloadJob(const std::vector<CStdString> &textures) : m_textures(textures) {};
+    virtual const char *GetType() const { return "texturepreload"; };
+    virtual bool DoWork();
+  private:
+    std::vector<CStdString> m_textures;
+  };
+
+  void LoadIncludes(const CStdString &file);
+  void FindTextures(const TiXmlElement *element, std::set<CStdString> &textures, unsigned int depth);
+
+  ADDON::SkinPtr m_skin;
+  std::vector<TiXmlDocument*> m_documents;
+  std::map<CStdString, const TiXmlElement*> m_includes;
+  std::set<CStdString> m_includeFiles;
+};
@@ -605,6 +605,7 @@ void CSlideShowPic::Render()
 
 void CSlideShowPic::Render(float *x, float *y, CBaseTexture* pTexture, color_t color)
 {
+  g_graphicsContext.FlushBatches();
 #ifdef HAS_DX
   struct VERTEX
   {
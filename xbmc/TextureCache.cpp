@@ -33,6 +33,7 @@
 #include "Picture.h"
 #include "TextureManager.h"
 #include "SpecialProtocol.h"
+#include "GraphicContext.h"
 
 using namespace XFILE;
 
@@ -54,6 +55,13 @@ bool CTextureCache::CCacheJob::operator==(const CJob* job) const
   return false;
 }
 
+unsigned int CTextureCache::CCacheJob::GetHash() const
+{
+  Crc32 crc;
+  crc.Compute(m_original);
+  return crc;
+}
+
 bool CTextureCache::CCacheJob::DoWork()
 {
   m_hash = CacheImage(m_url, m_original, m_oldHash);
@@ -93,6 +101,7 @@ CStdString CTextureCache::CCacheJob::CacheImage(const CStdString &url, const CSt
 CTextureCache::CDDSJob::CDDSJob(const CStdString &original)
 {
   m_original = original;
+  m_mtime = 0;
 }
 
 bool CTextureCache::CDDSJob::operator==(const CJob* job) const
@@ -106,16 +115,34 @@ bool CTextureCache::CDDSJob::operator==(const CJob* job) const
   return false;
 }
 
+unsigned int CTextureCache::CDDSJob::GetHash() const
+{
+  Crc32 crc;
+  crc.Compute(m_original);
+  return crc;
+}
+
 bool CTextureCache::CDDSJob::DoWork()
 {
   CTexture texture;
   if (CUtil::GetExtension(m_original).Equals(".dds"))
     return false;
-  if (texture.LoadFromFile(m_original))
+  struct __stat64 st;
+  if (CFile::Stat(m_original, &st) == 0)
+    m_mtime = st.st_mtime;
+  // no bigger than the large texture loader would have made it
+  if (texture.LoadFromFile(m_original, std::min(g_graphicsContext.GetWidth(), 2048), std::min(g_graphicsContext.GetHeight(), 1080)))
   { // convert to DDS
     CDDSImage dds;
     CLog::Log(LOGDEBUG, "Creating DDS version of: %s", m_original.c_str());
-    return dds.Create(CUtil::ReplaceExtension(m_original, ".dds"), texture.GetWidth(), texture.GetHeight(), texture.GetPitch(), texture.GetPixels(), 40);
+    // write it aside first so nobody loads a half written file
+    CStdString ddsPath = CUtil::ReplaceExtension(m_original, ".dds");
+    CStdString tempPath = ddsPath + ".tmp";
+    if (!dds.Create(tempPath, texture.GetWidth(), texture.GetHeight(), texture.GetPitch(), texture.GetPixels(), 40))
+      return false;
+    if (CFile::Exists(ddsPath))
+      CFile::Delete(ddsPath);
+    return CFile::Rename(tempPath, ddsPath);
   }
   return false;
 }
@@ -154,6 +181,11 @@ bool CTextureCache::IsCachedImage(const CStdString &url) const
     return true;
   if (url != "-" && !CURL::IsFullPath(url))
     return true;
+  return IsThumbnail(url);
+}
+
+bool CTextureCache::IsThumbnail(const CStdString &url) const
+{
   CStdString basePath(g_settings.GetThumbnailsFolder());
   if (0 == strncmp(url.c_str(), basePath.c_str(), basePath.GetLength()))
     return true;
@@ -185,18 +217,50 @@ CStdString CTextureCache::GetWrappedThumbURL(const CStdString &image)
   return CUtil::AddFileToFolder("thumb://" + url, CUtil::GetFileName(image));
 }
 
+CStdString CTextureCache::GetDDSImage(const CStdString &image)
+{
+  // skin images aren't necessarily writeable, so only the thumbnails folder gets .dds versions
+  if (CUtil::GetExtension(image).Equals(".dds") || !IsThumbnail(image))
+    return image;
+
+  CStdString ddsPath = CUtil::ReplaceExtension(image, ".dds");
+  struct __stat64 ddsStat;
+  struct __stat64 imageStat;
+  bool haveImageStat = false;
+  if (CFile::Stat(ddsPath, &ddsStat) == 0)
+  {
+    // the original is rewritten in place when it changes, so a .dds older than it is stale
+    haveImageStat = CFile::Stat(image, &imageStat) == 0;
+    if (!haveImageStat || imageStat.st_mtime <= ddsStat.st_mtime)
+      return ddsPath;
+  }
+
+  if (!g_advancedSettings.m_useDDSFanart)
+    return image;
+  if (!haveImageStat && CFile::Stat(image, &imageStat) != 0)
+    return image;
+
+  // a conversion that failed will fail again, until the original is rewritten
+  CSingleLock lock(m_ddsSection);
+  std::map<CStdString, int64_t>::const_iterator i = m_ddsFailures.find(image);
+  if (i != m_ddsFailures.end() && i->second == (int64_t)imageStat.st_mtime)
+    return image;
+  lock.Leave();
+
+  AddJob(new CDDSJob(image));
+  return image;
+}
+
 CStdString CTextureCache::CheckAndCacheImage(const CStdString &url, bool returnDDS)
 {
   CStdString path(GetCachedImage(url));
   if (!path.IsEmpty())
   {
-    if (returnDDS && 0 != strncmp(url.c_str(), "special://skin/", 15)) // TODO: should skin images be .dds'd (currently they're not necessarily writeable)
-    { // check for dds version
-      CStdString ddsPath = CUtil::ReplaceExtension(path, ".dds");
-      if (CFile::Exists(ddsPath))
+    if (returnDDS)
+    {
+      CStdString ddsPath = GetDDSImage(path);
+      if (ddsPath != path)
         return ddsPath;
-      if (g_advancedSettings.m_useDDSFanart)
-        AddJob(new CDDSJob(path));
     }
     
     // We're not going to give up just yet for PMS-sourced images. This will result in the texture
@@ -345,6 +409,18 @@ void CTextureCache::OnJobComplete(unsigned int jobID, bool success, CJob *job)
     if (g_advancedSettings.m_useDDSFanart)
       AddJob(new CDDSJob(GetCachedPath(cacheJob->m_original)));
   }
+  else if (strcmp(job->GetType(), "ddscompress") == 0)
+  {
+    CDDSJob *ddsJob = (CDDSJob *)job;
+    CSingleLock lock(m_ddsSection);
+    if (success)
+      m_ddsFailures.erase(ddsJob->m_original);
+    else if (ddsJob->m_mtime)
+    {
+      CLog::Log(LOGDEBUG, "Unable to create DDS version of: %s", ddsJob->m_original.c_str());
+      m_ddsFailures[ddsJob->m_original] = ddsJob->m_mtime;
+    }
+  }
   return CJobQueue::OnJobComplete(jobID, success, job);
 }
 
@@ -21,6 +21,8 @@
 
 #pragma once
 
+#include <map>
+
 #include "StdString.h"
 #include "utils/JobManager.h"
 #include "TextureDatabase.h"
@@ -30,7 +32,9 @@
  \brief Texture cache class for handling the caching of images.
 
  Manages the caching of images for use as control textures. Images are cached
- both as originals (direct copies) and as .dds textures for fast loading. Images
+ both as originals (direct copies) and as .dds textures for fast loading. The
+ .dds versions are DXT1/DXT5 compressed in the background and uploaded as is, so
+ they take a fraction of the decode time and texture memory of the originals. Images
  may be periodically checked for updates and may be purged from the cache if
  unused for a set period of time.
 
@@ -66,6 +70,17 @@ public:
    */
   CStdString CheckAndCacheImage(const CStdString &image, bool returnDDS = true);
 
+  /*! \brief retrieve the .dds version of an image in the thumbnails folder
+
+   If there's no .dds version yet, or the image has been rewritten since it was made,
+   one is created in the background (unless <useddsfanart> is off) and the image
+   itself is returned in the meantime.
+
+   \param image full path of the image
+   \return path of an up to date .dds version of image, or image if there is none
+   */
+  CStdString GetDDSImage(const CStdString &image);
+
   /*! \brief retrieve the cached version of the given image (if it exists)
    \param image url of the image
    \return cached url of this image, empty if none exists
@@ -114,9 +129,11 @@ private:
 
     virtual const char* GetType() const { return "ddscompress"; };
     virtual bool operator==(const CJob *job) const;
+    virtual unsigned int GetHash() const;
     virtual bool DoWork();
 
     CStdString m_original;
+    int64_t    m_mtime;     ///< modification time of the original we tried to convert
   };
 
   /*! \brief Job class for caching textures
@@ -128,6 +145,7 @@ private:
 
     virtual const char* GetType() const { return "cacheimage"; };
     virtual bool operator==(const CJob *job) const;
+    virtual unsigned int GetHash() const;
     virtual bool DoWork();
 
     /*! \brief Cache an image either full size or thumb sized
@@ -156,6 +174,12 @@ private:
    */
   bool IsCachedImage(const CStdString &image) const;
 
+  /*! \brief Check if the given image lives in the thumbnails folder, which we may write .dds versions into
+   \param image url of the image
+   \return true if the image is in the thumbnails folder, false otherwise.
+   */
+  bool IsThumbnail(const CStdString &image) const;
+
   /*! \brief Add this image to the database
    Thread-safe wrapper of CTextureDatabase::AddCachedTexture
    \param image url of the original image
@@ -192,5 +216,10 @@ private:
 
   CCriticalSection m_databaseSection;
   CTextureDatabase m_database;
+
+  // Originals that couldn't be converted to .dds, by the modification time they had then,
+  // so they aren't decoded again every time they're shown until they're rewritten.
+  std::map<CStdString, int64_t> m_ddsFailures;
+  CCriticalSection m_ddsSection;
 };
 
@@ -38,6 +38,7 @@
 #include "utils/log.h"
 #include "utils/SingleLock.h"
 #include "Shortcut.h"
+#include "Crc32.h"
 
 #include "cores/dvdplayer/DVDFileInfo.h"
 
@@ -149,6 +150,13 @@ bool CThumbExtractor::operator==(const CJob* job) const
   return false;
 }
 
+unsigned int CThumbExtractor::GetHash() const
+{
+  Crc32 crc;
+  crc.Compute(m_listpath);
+  return crc;
+}
+
 bool CThumbExtractor::DoWork()
 {
   if (CUtil::IsLiveTV(m_path)
@@ -303,15 +311,17 @@ bool CVideoThumbLoader::LoadItem(CFileItem* pItem)
   }
 #endif
   
-  // Walk through properties and see if there are any image resources to be loaded.
-  CGUIListItem::PropertyMap& properties = pItem->GetPropertyDict();
-  typedef pair<CStdString, CStdString> PropertyPair;
-  BOOST_FOREACH(PropertyPair pair, properties)
+  // Walk through properties and see if there are any image resources to be loaded. Take a
+  // copy, since setting properties below reshuffles the item's own list.
+  //
+  CGUIListItem::PropertyMap properties = pItem->GetPropertyDict();
+  BOOST_FOREACH(const CGUIListItem::Property& property, properties)
   {
-    if (pair.first.substr(0, 6) == "cache$")
+    const CStdString& key = CGUIListItem::GetPropertyName(property.first);
+    if (key.substr(0, 6) == "cache$")
     {
-      string name = pair.first.substr(6);
-      string url = pair.second;
+      string name = key.substr(6);
+      string url = *property.second;
       
       string localFile = CFileItem::GetCachedPlexMediaServerThumb(url);
       if (CFile::Exists(localFile) == false)
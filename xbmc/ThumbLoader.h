@@ -53,6 +53,7 @@ public:
   }
 
   virtual bool operator==(const CJob* job) const;
+  virtual unsigned int GetHash() const;
 
   CStdString m_path; ///< path of video to extract thumb from
   CStdString m_target; ///< thumbpath
@@ -196,6 +196,11 @@ void CSkinInfo::ResolveIncludes(TiXmlElement *node, const CStdString &type)
   m_includes.ResolveIncludes(node, type);
 }
 
+void CSkinInfo::ResolveAllIncludes(TiXmlElement *node, vector< pair<CStdString, bool> > &conditions)
+{
+  m_includes.ResolveAllIncludes(node, conditions);
+}
+
 bool CSkinInfo::ResolveConstant(const CStdString &constant, float &value) const
 {
   return m_includes.ResolveConstant(constant, value);
@@ -94,6 +94,17 @@ public:
   static RESOLUTION TranslateResolution(const CStdString &res, RESOLUTION def);
 
   void ResolveIncludes(TiXmlElement *node, const CStdString &type = "");
+
+  /*! \brief Resolve every include in a window, eg before caching it
+   \param node the root of the window
+   \param conditions [out] conditions that decided which includes were used, with their current value
+   \sa CGUIIncludes::ResolveAllIncludes
+   */
+  void ResolveAllIncludes(TiXmlElement *node, std::vector< std::pair<CStdString, bool> > &conditions);
+
+  /*! \brief Include files loaded so far, which resolved windows may depend on
+   */
+  const std::vector<CStdString> &GetIncludeFiles() const { return m_includes.GetFiles(); };
   bool ResolveConstant(const CStdString &constant, float &value) const;
   bool ResolveConstant(const CStdString &constant, unsigned int &value) const;
 
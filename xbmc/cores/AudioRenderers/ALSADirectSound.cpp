@@ -489,9 +489,14 @@ unsigned int CALSADirectSound::AddPackets(const void* data, unsigned int len)
     return 0;
   }
 
-  // handle volume de-amp
+  // handle volume de-amp, the remap applies it as it goes when there is one
   if (!m_bPassthrough)
-    m_amp.DeAmplify((short *)data, inputSamples);
+  {
+    if (m_remap.CanRemap())
+      m_remap.SetGain(m_amp.GetFactor());
+    else
+      m_amp.DeAmplify((short *)data, inputSamples);
+  }
 
   int writeResult;
   if (m_bPassthrough && m_nCurrentVolume == VOLUME_MINIMUM)
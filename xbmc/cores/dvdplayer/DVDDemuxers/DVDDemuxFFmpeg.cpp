@@ -208,6 +208,7 @@ CDVDDemuxFFmpeg::CDVDDemuxFFmpeg() : CDVDDemux()
   m_pFormatContext = NULL;
   m_pInput = NULL;
   m_ioContext = NULL;
+  m_ioMapBuffer = NULL;
   InitializeCriticalSection(&m_critSection);
   for (int i = 0; i < MAX_STREAMS; i++) m_streams[i] = NULL;
   m_iCurrentPts = DVD_NOPTS_VALUE;
@@ -291,11 +292,25 @@ bool CDVDDemuxFFmpeg::Open(CDVDInputStream* pInput)
   }
   else
   {
-    unsigned char* buffer = (unsigned char*)m_dllAvUtil.av_malloc(FFMPEG_FILE_BUFFER_SIZE);
-    m_ioContext = m_dllAvFormat.av_alloc_put_byte(buffer, FFMPEG_FILE_BUFFER_SIZE, 0, m_pInput, dvd_file_read, NULL, dvd_file_seek);
-    m_ioContext->max_packet_size = m_pInput->GetBlockSize();
-    if(m_ioContext->max_packet_size)
-      m_ioContext->max_packet_size *= FFMPEG_FILE_BUFFER_SIZE / m_ioContext->max_packet_size;
+    CDVDInputStream::IMapped* mapped = dynamic_cast<CDVDInputStream::IMapped*>(m_pInput);
+    int size = 0;
+    if (mapped)
+      m_ioMapBuffer = mapped->GetMapBuffer(size);
+
+    if (m_ioMapBuffer)
+    {
+      // the stream maps the file into our buffer, so it's always refilled from its start
+      m_ioContext = m_dllAvFormat.av_alloc_put_byte(m_ioMapBuffer, size, 0, m_pInput, dvd_file_read, NULL, dvd_file_seek);
+      m_ioContext->max_packet_size = size;
+    }
+    else
+    {
+      unsigned char* buffer = (unsigned char*)m_dllAvUtil.av_malloc(FFMPEG_FILE_BUFFER_SIZE);
+      m_ioContext = m_dllAvFormat.av_alloc_put_byte(buffer, FFMPEG_FILE_BUFFER_SIZE, 0, m_pInput, dvd_file_read, NULL, dvd_file_seek);
+      m_ioContext->max_packet_size = m_pInput->GetBlockSize();
+      if(m_ioContext->max_packet_size)
+        m_ioContext->max_packet_size *= FFMPEG_FILE_BUFFER_SIZE / m_ioContext->max_packet_size;
+    }
 
     if (m_pInput->IsStreamType(DVDSTREAM_TYPE_DVD))
     {
@@ -333,7 +348,7 @@ bool CDVDDemuxFFmpeg::Open(CDVDInputStream* pInput)
       pd.filename = strFile.c_str();
 
       // read data using avformat's buffers
-      pd.buf_size = m_dllAvFormat.get_buffer(m_ioContext, pd.buf, m_ioContext->max_packet_size ? m_ioContext->max_packet_size : m_ioContext->buffer_size);
+      pd.buf_size = m_dllAvFormat.get_buffer(m_ioContext, pd.buf, std::min(m_ioContext->max_packet_size ? m_ioContext->max_packet_size : m_ioContext->buffer_size, FFMPEG_FILE_BUFFER_SIZE));
       if (pd.buf_size <= 0)
       {
         SetError(g_localizeStrings.Get(42000));
@@ -529,7 +544,7 @@ void CDVDDemuxFFmpeg::Dispose()
         m_ioContext = m_pFormatContext->pb;
       }
       m_dllAvFormat.av_close_input_stream(m_pFormatContext);
-      if (m_ioContext->buffer)
+      if (m_ioContext->buffer && m_ioContext->buffer != m_ioMapBuffer)
         m_dllAvUtil.av_free(m_ioContext->buffer);
       m_dllAvUtil.av_free(m_ioContext);
     }
@@ -537,6 +552,7 @@ void CDVDDemuxFFmpeg::Dispose()
       m_dllAvFormat.av_close_input_file(m_pFormatContext);
   }
   m_ioContext = NULL;
+  m_ioMapBuffer = NULL;
   m_pFormatContext = NULL;
   m_speed = DVD_PLAYSPEED_NORMAL;
 
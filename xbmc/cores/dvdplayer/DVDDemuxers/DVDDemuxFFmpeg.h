@@ -132,6 +132,7 @@ protected:
   CDemuxStream* m_streams[MAX_STREAMS]; // maximum number of streams that ffmpeg can handle
 
   ByteIOContext* m_ioContext;
+  unsigned char* m_ioMapBuffer; // owned by the input stream rather than by ffmpeg
 
   DllAvFormat m_dllAvFormat;
   DllAvCodec  m_dllAvCodec;
@@ -25,6 +25,7 @@
 #include "DVDDemuxUtils.h"
 #include "DVDClock.h"
 #include "utils/log.h"
+#include "utils/Atomics.h"
 extern "C" {
 #if (defined USE_EXTERNAL_FFMPEG)
   #if (defined HAVE_LIBAVCODEC_AVCODEC_H)
@@ -37,13 +38,75 @@ extern "C" {
 #endif
 }
 
-void CDVDDemuxUtils::FreeDemuxPacket(DemuxPacket* pPacket)
+// Packets and their data buffers are recycled rather than going back to the heap, so that
+// demuxing a high bitrate stream doesn't make thousands of allocations a second across the
+// demux, audio and video threads. Buffers are pooled by size in powers of two; the free
+// lists are guarded by spin locks that are only held to swap a pointer.
+#define PACKET_POOL_MIN_SHIFT 10                 // smallest pooled buffer, 1 KiB
+#define PACKET_POOL_CLASSES   13                 // no buffer, then 1 KiB .. 2 MiB
+#define PACKET_POOL_MAX_FREE  (32 * 1024 * 1024) // most bytes kept on the free lists
+
+namespace
 {
-  if (pPacket)
+  struct PooledPacket
+  {
+    DemuxPacket   packet;    // first, so that a DemuxPacket* is its PooledPacket*
+    PooledPacket* next;      // free list link
+    BYTE*         buffer;    // owned data buffer, capacity bytes
+    int           capacity;
+    int           sizeClass; // free list it goes back to, -1 if too big to pool
+  };
+
+  struct PacketFreeList
+  {
+    PooledPacket* head;
+    long          lock;
+  };
+
+  // Plain data, so it's zeroed before any code runs.
+  PacketFreeList s_freeLists[PACKET_POOL_CLASSES];
+  volatile long  s_freeBytes;
+  volatile long  s_inUseBytes;
+  volatile long  s_peakBytes;
+  volatile long  s_hits;
+  volatile long  s_misses;
+
+  int GetSizeClass(int bufferSize)
+  {
+    if (bufferSize == 0)
+      return 0;
+
+    for (int sizeClass = 1; sizeClass < PACKET_POOL_CLASSES; sizeClass++)
+    {
+      if (bufferSize <= (1 << (PACKET_POOL_MIN_SHIFT + sizeClass - 1)))
+        return sizeClass;
+    }
+    return -1;
+  }
+
+  PooledPacket* PopFreePacket(int sizeClass)
+  {
+    PacketFreeList& list = s_freeLists[sizeClass];
+    CAtomicSpinLock lock(list.lock);
+    PooledPacket* pooled = list.head;
+    if (pooled)
+      list.head = pooled->next;
+    return pooled;
+  }
+
+  void PushFreePacket(PooledPacket* pooled)
+  {
+    PacketFreeList& list = s_freeLists[pooled->sizeClass];
+    CAtomicSpinLock lock(list.lock);
+    pooled->next = list.head;
+    list.head = pooled;
+  }
+
+  void DeletePooledPacket(PooledPacket* pooled)
   {
     try {
-      if (pPacket->pData) _aligned_free(pPacket->pData);
-      delete pPacket;
+      if (pooled->buffer) _aligned_free(pooled->buffer);
+      delete pooled;
     }
     catch(...) {
       CLog::Log(LOGERROR, "%s - Exception thrown while freeing packet", __FUNCTION__);
@@ -51,47 +114,110 @@ void CDVDDemuxUtils::FreeDemuxPacket(DemuxPacket* pPacket)
   }
 }
 
+void CDVDDemuxUtils::FreeDemuxPacket(DemuxPacket* pPacket)
+{
+  if (pPacket)
+  {
+    PooledPacket* pooled = (PooledPacket*)pPacket;
+    AtomicSubtract(&s_inUseBytes, pooled->capacity);
+
+    if (pooled->sizeClass >= 0 && s_freeBytes + pooled->capacity <= PACKET_POOL_MAX_FREE)
+    {
+      AtomicAdd(&s_freeBytes, pooled->capacity);
+      PushFreePacket(pooled);
+    }
+    else
+    {
+      DeletePooledPacket(pooled);
+    }
+  }
+}
+
 DemuxPacket* CDVDDemuxUtils::AllocateDemuxPacket(int iDataSize)
 {
-  DemuxPacket* pPacket = new DemuxPacket;
-  if (!pPacket) return NULL;
+  // need to allocate a few bytes more.
+  // From avcodec.h (ffmpeg)
+  /**
+    * Required number of additionally allocated bytes at the end of the input bitstream for decoding.
+    * this is mainly needed because some optimized bitstream readers read
+    * 32 or 64 bit at once and could read over the end<br>
+    * Note, if the first 23 bits of the additional bytes are not 0 then damaged
+    * MPEG bitstreams could cause overread and segfault
+    */
+  int bufferSize = iDataSize > 0 ? iDataSize + FF_INPUT_BUFFER_PADDING_SIZE : 0;
+  int sizeClass = GetSizeClass(bufferSize);
 
-  try
-  {
-    memset(pPacket, 0, sizeof(DemuxPacket));
+  PooledPacket* pooled = NULL;
+  if (sizeClass >= 0)
+    pooled = PopFreePacket(sizeClass);
 
-    if (iDataSize > 0)
+  if (pooled)
+  {
+    AtomicSubtract(&s_freeBytes, pooled->capacity);
+    AtomicIncrement(&s_hits);
+  }
+  else
+  {
+    AtomicIncrement(&s_misses);
+    try
     {
-      // need to allocate a few bytes more.
-      // From avcodec.h (ffmpeg)
-      /**
-        * Required number of additionally allocated bytes at the end of the input bitstream for decoding.
-        * this is mainly needed because some optimized bitstream readers read
-        * 32 or 64 bit at once and could read over the end<br>
-        * Note, if the first 23 bits of the additional bytes are not 0 then damaged
-        * MPEG bitstreams could cause overread and segfault
-        */
-      pPacket->pData =(BYTE*)_aligned_malloc(iDataSize + FF_INPUT_BUFFER_PADDING_SIZE, 16);
-      if (!pPacket->pData)
+      pooled = new PooledPacket;
+      pooled->next      = NULL;
+      pooled->buffer    = NULL;
+      pooled->sizeClass = sizeClass;
+      pooled->capacity  = sizeClass > 0 ? 1 << (PACKET_POOL_MIN_SHIFT + sizeClass - 1) : bufferSize;
+
+      if (pooled->capacity > 0)
       {
-        FreeDemuxPacket(pPacket);
-        return NULL;
+        pooled->buffer = (BYTE*)_aligned_malloc(pooled->capacity, 16);
+        if (!pooled->buffer)
+        {
+          delete pooled;
+          return NULL;
+        }
       }
-
-      // reset the last 8 bytes to 0;
-      memset(pPacket->pData + iDataSize, 0, FF_INPUT_BUFFER_PADDING_SIZE);
     }
-
-    // setup defaults
-    pPacket->dts       = DVD_NOPTS_VALUE;
-    pPacket->pts       = DVD_NOPTS_VALUE;
-    pPacket->iStreamId = -1;
+    catch(...)
+    {
+      CLog::Log(LOGERROR, "%s - Exception thrown", __FUNCTION__);
+      return NULL;
+    }
   }
-  catch(...)
+
+  long inUse = AtomicAdd(&s_inUseBytes, pooled->capacity);
+  long peak;
+  while (inUse > (peak = s_peakBytes) && cas(&s_peakBytes, peak, inUse) != peak) {}
+
+  DemuxPacket* pPacket = &pooled->packet;
+  memset(pPacket, 0, sizeof(DemuxPacket));
+
+  if (iDataSize > 0)
   {
-    CLog::Log(LOGERROR, "%s - Exception thrown", __FUNCTION__);
-    FreeDemuxPacket(pPacket);
-    pPacket = NULL;
+    pPacket->pData = pooled->buffer;
+
+    // reset the last 8 bytes to 0;
+    memset(pPacket->pData + iDataSize, 0, FF_INPUT_BUFFER_PADDING_SIZE);
   }
+
+  // setup defaults
+  pPacket->dts       = DVD_NOPTS_VALUE;
+  pPacket->pts       = DVD_NOPTS_VALUE;
+  pPacket->iStreamId = -1;
+
   return pPacket;
 }
+
+void CDVDDemuxUtils::TrimPacketPool()
+{
+  for (int sizeClass = 0; sizeClass < PACKET_POOL_CLASSES; sizeClass++)
+  {
+    PooledPacket* pooled;
+    while ((pooled = PopFreePacket(sizeClass)) != NULL)
+    {
+      AtomicSubtract(&s_freeBytes, pooled->capacity);
+      DeletePooledPacket(pooled);
+    }
+  }
+
+  CLog::Log(LOGDEBUG, "%s - packet pool: %ld hits, %ld misses, peak %ld bytes in use", __FUNCTION__, (long)s_hits, (long)s_misses, (long)s_peakBytes);
+}
@@ -28,5 +28,10 @@ class CDVDDemuxUtils
 public:
   static void FreeDemuxPacket(DemuxPacket* pPacket);
   static DemuxPacket* AllocateDemuxPacket(int iDataSize = 0);
+
+  /*! \brief Give the memory of recycled packets back to the heap, and log the pool's stats.
+   Packets in use are unaffected.
+   */
+  static void TrimPacketPool();
 };
 
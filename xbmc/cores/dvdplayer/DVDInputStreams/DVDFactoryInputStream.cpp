@@ -23,6 +23,7 @@
 #include "DVDFactoryInputStream.h"
 #include "DVDInputStream.h"
 #include "DVDInputStreamFile.h"
+#include "DVDInputStreamMapped.h"
 #include "DVDInputStreamNavigator.h"
 #include "DVDInputStreamHttp.h"
 #include "DVDInputStreamFFmpeg.h"
@@ -42,6 +43,7 @@
 #endif
 #include "FileItem.h"
 #include "MediaManager.h"
+#include "AdvancedSettings.h"
 
 CDVDInputStream* CDVDFactoryInputStream::CreateInputStream(IDVDPlayer* pPlayer, const std::string& file, const std::string& content)
 {
@@ -91,6 +93,11 @@ CDVDInputStream* CDVDFactoryInputStream::CreateInputStream(IDVDPlayer* pPlayer,
     return new CDVDInputStreamMMS();
 #endif
 
+#ifdef _LINUX
+  else if(g_advancedSettings.m_videoMapLocalFiles && CDVDInputStreamMapped::CanOpen(file))
+    return new CDVDInputStreamMapped();
+#endif
+
   // our file interface handles all these types of streams
   return (new CDVDInputStreamFile());
 }
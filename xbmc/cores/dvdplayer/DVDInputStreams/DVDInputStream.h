@@ -26,6 +26,11 @@
 
 #include "FileItem.h"
 
+namespace XFILE
+{
+  class ICacheInterface;
+}
+
 enum DVDStreamType
 {
   DVDSTREAM_TYPE_NONE      = -1,
@@ -84,6 +89,15 @@ public:
     virtual bool SeekChapter(int ch) = 0;
   };
 
+  class IMapped
+  {
+    public:
+    virtual ~IMapped() {};
+    /* memory, valid until the stream is closed, that Read() fills by mapping the
+       file over it instead of copying into it when reading page aligned chunks */
+    virtual BYTE* GetMapBuffer(int& size) = 0;
+  };
+
   CDVDInputStream(DVDStreamType m_streamType);
   virtual ~CDVDInputStream();
   virtual bool Open(const char* strFileName, const std::string& content);
@@ -102,6 +116,7 @@ public:
   virtual bool IsEOF() = 0;
   virtual int GetCurrentGroupId() { return 0; }
   virtual BitstreamStats GetBitstreamStats() const { return m_stats; }
+  virtual XFILE::ICacheInterface* GetCache() { return NULL; }
 
   void SetFileItem(const CFileItem& item);
   
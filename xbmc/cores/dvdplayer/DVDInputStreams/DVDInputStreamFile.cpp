@@ -22,6 +22,8 @@
 #include "DVDInputStreamFile.h"
 #include "FileItem.h"
 #include "FileSystem/File.h"
+#include "utils/TimeUtils.h"
+#include "utils/log.h"
 
 using namespace XFILE;
 
@@ -29,6 +31,8 @@ CDVDInputStreamFile::CDVDInputStreamFile(DVDStreamType streamType) : CDVDInputSt
 {
   m_pFile = NULL;
   m_eof = true;
+  m_bytesCopied = 0;
+  m_openTime = 0;
 }
 
 CDVDInputStreamFile::~CDVDInputStreamFile()
@@ -67,6 +71,8 @@ bool CDVDInputStreamFile::Open(const char* strFile, const std::string& content)
     m_content = m_pFile->GetImplemenation()->GetContent();
 
   m_eof = true;
+  m_bytesCopied = 0;
+  m_openTime = CTimeUtils::GetTimeMS();
   return true;
 }
 
@@ -75,6 +81,9 @@ void CDVDInputStreamFile::Close()
 {
   if (m_pFile)
   {
+    float seconds = (CTimeUtils::GetTimeMS() - m_openTime) / 1000.0f;
+    CLog::Log(LOGDEBUG, "%s - copied %"PRId64" bytes (%.1f KB/s) in %.1fs",
+              __FUNCTION__, m_bytesCopied, seconds > 0 ? m_bytesCopied / 1024.0f / seconds : 0.0f, seconds);
     m_pFile->Close();
     delete m_pFile;
   }
@@ -92,6 +101,7 @@ int CDVDInputStreamFile::Read(BYTE* buf, int buf_size)
 
   /* we currently don't support non completing reads */
   if( ret <= 0 ) m_eof = true;
+  else m_bytesCopied += ret;
 
   return (int)(ret & 0xFFFFFFFF);
 }
@@ -122,6 +132,14 @@ BitstreamStats CDVDInputStreamFile::GetBitstreamStats() const
   return m_pFile->GetBitstreamStats();
 }
 
+ICacheInterface* CDVDInputStreamFile::GetCache()
+{
+  if (!m_pFile)
+    return NULL;
+
+  return m_pFile->GetCache();
+}
+
 int CDVDInputStreamFile::GetBlockSize()
 {
   if(m_pFile)
@@ -36,8 +36,11 @@ public:
   virtual bool IsEOF();
   virtual __int64 GetLength();
   virtual BitstreamStats GetBitstreamStats() const ;
+  virtual XFILE::ICacheInterface* GetCache();
   virtual int GetBlockSize();
 protected:
   XFILE::CFile* m_pFile;
   bool m_eof;
+  int64_t m_bytesCopied;
+  unsigned int m_openTime;
 };
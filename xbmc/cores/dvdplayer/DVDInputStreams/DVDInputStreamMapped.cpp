@@ -0,0 +1,309 @@
+/*
+ *      Copyright (C) 2005-2010 Team XBMC
+ *      http://www.xbmc.org
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, write to
+ *  the Free Software Foundation, 675 Mass Ave, Cambridge, MA 02139, USA.
+ *  http://www.gnu.org/copyleft/gpl.html
+ *
+ */
+
+#include "system.h"
+#include "DVDInputStreamMapped.h"
+
+#ifdef _LINUX
+
+#include "URL.h"
+#include "FileSystem/IFile.h"
+#include "FileSystem/SpecialProtocol.h"
+#include "utils/TimeUtils.h"
+#include "utils/log.h"
+
+#include <sys/mman.h>
+#include <sys/stat.h>
+#ifdef __APPLE__
+#include <sys/mount.h>
+#else
+#include <sys/vfs.h>
+#endif
+#include <fcntl.h>
+#include <unistd.h>
+#include <errno.h>
+#include <algorithm>
+
+// what the demuxer parses from, a page multiple
+#define MAPPED_BUFFER_SIZE    (1024 * 1024)
+// how far ahead of the reader the kernel is asked to have the file read
+#define MAPPED_READAHEAD_SIZE (8 * 1024 * 1024)
+
+CDVDInputStreamMapped::CDVDInputStreamMapped() : CDVDInputStream(DVDSTREAM_TYPE_FILE)
+{
+  m_fd = -1;
+  m_length = 0;
+  m_position = 0;
+  m_readAhead = 0;
+  m_pageSize = 4096;
+  m_buffer = NULL;
+  m_eof = true;
+  m_bytesMapped = 0;
+  m_bytesCopied = 0;
+  m_openTime = 0;
+}
+
+CDVDInputStreamMapped::~CDVDInputStreamMapped()
+{
+  Close();
+}
+
+// A mapped page that can't be read is a SIGBUS rather than a failed read, so only files on
+// disks that can't go away under us are mapped. NFS and CIFS mounts look just as local.
+static bool IsFixedFilesystem(const char* path)
+{
+  struct statfs fs;
+  if (statfs(path, &fs) != 0)
+    return false;
+#ifdef __APPLE__
+#ifdef MNT_REMOVABLE
+  if (fs.f_flags & MNT_REMOVABLE)
+    return false;
+#endif
+  return (fs.f_flags & MNT_LOCAL) != 0;
+#else
+  switch ((uint32_t)fs.f_type)
+  {
+  case 0xEF53:     // ext2/3/4
+  case 0x58465342: // xfs
+  case 0x9123683E: // btrfs
+  case 0x3153464A: // jfs
+  case 0x52654973: // reiserfs
+  case 0xF2F52010: // f2fs
+  case 0x01021994: // tmpfs
+    return true;
+  }
+  return false;
+#endif
+}
+
+bool CDVDInputStreamMapped::CanOpen(const std::string& file)
+{
+  CStdString path = CSpecialProtocol::TranslatePath(file);
+  if (!CURL(path).IsLocal())
+    return false;
+
+  struct stat st;
+  return stat(path.c_str(), &st) == 0 && S_ISREG(st.st_mode) && IsFixedFilesystem(path.c_str());
+}
+
+bool CDVDInputStreamMapped::Open(const char* strFile, const std::string& content)
+{
+  if (!CDVDInputStream::Open(strFile, content)) return false;
+
+  CStdString path = CSpecialProtocol::TranslatePath(strFile);
+  m_fd = open(path.c_str(), O_RDONLY);
+  if (m_fd < 0)
+    return false;
+
+  struct stat st;
+  if (fstat(m_fd, &st) != 0 || !S_ISREG(st.st_mode))
+  {
+    Close();
+    return false;
+  }
+  m_length = st.st_size;
+  m_pageSize = (int)sysconf(_SC_PAGESIZE);
+
+  // pages of the file are mapped over this by Read(), it stays writable as those mappings
+  // are private, so reads that can't be mapped are still read into it
+  m_buffer = (BYTE*)mmap(NULL, MAPPED_BUFFER_SIZE, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANON, -1, 0);
+  if (m_buffer == MAP_FAILED)
+  {
+    CLog::Log(LOGERROR, "%s - unable to map buffer (%d)", __FUNCTION__, errno);
+    m_buffer = NULL;
+    Close();
+    return false;
+  }
+
+#ifdef __APPLE__
+  fcntl(m_fd, F_RDAHEAD, 1);
+#else
+  posix_fadvise(m_fd, 0, 0, POSIX_FADV_SEQUENTIAL);
+#endif
+
+  m_position = 0;
+  m_readAhead = 0;
+  m_bytesMapped = 0;
+  m_bytesCopied = 0;
+  m_openTime = CTimeUtils::GetTimeMS();
+  m_eof = false;
+  return true;
+}
+
+void CDVDInputStreamMapped::Close()
+{
+  if (m_fd >= 0)
+  {
+    float seconds = (CTimeUtils::GetTimeMS() - m_openTime) / 1000.0f;
+    CLog::Log(LOGDEBUG, "%s - mapped %"PRId64" bytes, copied %"PRId64" bytes (%.1f KB/s) in %.1fs",
+              __FUNCTION__, m_bytesMapped, m_bytesCopied, seconds > 0 ? m_bytesCopied / 1024.0f / seconds : 0.0f, seconds);
+    close(m_fd);
+  }
+  if (m_buffer)
+    munmap(m_buffer, MAPPED_BUFFER_SIZE);
+
+  CDVDInputStream::Close();
+  m_fd = -1;
+  m_buffer = NULL;
+  m_eof = true;
+}
+
+bool CDVDInputStreamMapped::UpdateLength()
+{
+  struct stat st;
+  if (fstat(m_fd, &st) != 0 || st.st_size <= m_length)
+    return false;
+  m_length = st.st_size;
+  return true;
+}
+
+void CDVDInputStreamMapped::ReadAhead()
+{
+  // ask for more once the reader is halfway through what was asked for last
+  int64_t target = std::min(m_position + MAPPED_READAHEAD_SIZE, m_length);
+  if (target - m_readAhead < MAPPED_READAHEAD_SIZE / 2)
+    return;
+
+  int64_t start = std::max(m_readAhead, m_position);
+#ifdef __APPLE__
+  struct radvisory advice;
+  advice.ra_offset = (off_t)start;
+  advice.ra_count  = (int)(target - start);
+  fcntl(m_fd, F_RDADVISE, &advice);
+#else
+  posix_fadvise(m_fd, (off_t)start, (off_t)(target - start), POSIX_FADV_WILLNEED);
+#endif
+  m_readAhead = target;
+}
+
+int CDVDInputStreamMapped::Read(BYTE* buf, int buf_size)
+{
+  if (m_fd < 0) return -1;
+
+  // the file may still be being written, by a download or a recording
+  if (m_position >= m_length)
+    UpdateLength();
+
+  int64_t size = std::min((int64_t)buf_size, m_length - m_position);
+  if (size <= 0)
+  {
+    m_eof = true;
+    return 0;
+  }
+
+  ReadAhead();
+
+  if (buf >= m_buffer && buf + buf_size <= m_buffer + MAPPED_BUFFER_SIZE)
+  {
+    int offset = (int)(m_position % m_pageSize);
+    if (offset == 0 && (buf - m_buffer) % m_pageSize == 0)
+    {
+      // the rest of the file's last page reads as zeros
+      size_t length = (size_t)((size + m_pageSize - 1) / m_pageSize * m_pageSize);
+      if (mmap(buf, length, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_FIXED, m_fd, (off_t)m_position) != MAP_FAILED)
+      {
+        madvise(buf, length, MADV_SEQUENTIAL);
+        m_position += size;
+        m_bytesMapped += size;
+        return (int)size;
+      }
+
+      // a failed MAP_FIXED may have unmapped what was there
+      CLog::Log(LOGWARNING, "%s - unable to map file at %"PRId64" (%d)", __FUNCTION__, m_position, errno);
+      if (mmap(buf, length, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANON | MAP_FIXED, -1, 0) == MAP_FAILED)
+        return -1;
+    }
+    else if (offset)
+    {
+      // after a seek, read up to the next page so that the following reads can be mapped
+      size = std::min(size, (int64_t)(m_pageSize - offset));
+    }
+  }
+
+  ssize_t ret = pread(m_fd, buf, (size_t)size, (off_t)m_position);
+  if (ret <= 0)
+  {
+    m_eof = true;
+    return ret < 0 ? -1 : 0;
+  }
+
+  m_position += ret;
+  m_bytesCopied += ret;
+  return (int)ret;
+}
+
+__int64 CDVDInputStreamMapped::Seek(__int64 offset, int whence)
+{
+  if (m_fd < 0) return -1;
+
+  int64_t position;
+  switch (whence)
+  {
+  case SEEK_SET:
+    position = offset;
+    break;
+  case SEEK_CUR:
+    position = m_position + offset;
+    break;
+  case SEEK_END:
+    position = m_length + offset;
+    break;
+  case SEEK_POSSIBLE:
+    return 1;
+  default:
+    return -1;
+  }
+
+  if (position < 0)
+    return -1;
+
+  if (position != m_position)
+  {
+    m_position = position;
+    m_readAhead = position;
+  }
+  m_eof = false;
+  return m_position;
+}
+
+bool CDVDInputStreamMapped::IsEOF()
+{
+  return m_fd < 0 || m_eof;
+}
+
+__int64 CDVDInputStreamMapped::GetLength()
+{
+  return m_length;
+}
+
+int CDVDInputStreamMapped::GetBlockSize()
+{
+  return m_pageSize;
+}
+
+BYTE* CDVDInputStreamMapped::GetMapBuffer(int& size)
+{
+  size = MAPPED_BUFFER_SIZE;
+  return m_buffer;
+}
+
+#endif
@@ -0,0 +1,69 @@
+#pragma once
+
+/*
+ *      Copyright (C) 2005-2010 Team XBMC
+ *      http://www.xbmc.org
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, write to
+ *  the Free Software Foundation, 675 Mass Ave, Cambridge, MA 02139, USA.
+ *  http://www.gnu.org/copyleft/gpl.html
+ *
+ */
+
+#include "DVDInputStream.h"
+
+#ifdef _LINUX
+
+/*
+ * Reads local files through mmap rather than read(). Page aligned reads into the buffer
+ * given out by GetMapBuffer() map the file's pages there, so the demuxer parses straight
+ * out of the page cache, anything else is read into the caller's buffer as usual.
+ */
+class CDVDInputStreamMapped : public CDVDInputStream, public CDVDInputStream::IMapped
+{
+public:
+  CDVDInputStreamMapped();
+  virtual ~CDVDInputStreamMapped();
+  virtual bool Open(const char* strFile, const std::string &content);
+  virtual void Close();
+  virtual int Read(BYTE* buf, int buf_size);
+  virtual __int64 Seek(__int64 offset, int whence);
+  virtual bool Pause(double dTime) { return false; };
+  virtual bool IsEOF();
+  virtual __int64 GetLength();
+  virtual int GetBlockSize();
+
+  virtual BYTE* GetMapBuffer(int& size);
+
+  /* true for regular files on a fixed, local disk */
+  static bool CanOpen(const std::string& file);
+
+protected:
+  bool UpdateLength();
+  void ReadAhead();
+
+  int     m_fd;
+  int64_t m_length;
+  int64_t m_position;
+  int64_t m_readAhead;  // where the kernel has been asked to read ahead to
+  int     m_pageSize;
+  BYTE*   m_buffer;
+  bool    m_eof;
+
+  int64_t      m_bytesMapped;
+  int64_t      m_bytesCopied;
+  unsigned int m_openTime;
+};
+
+#endif
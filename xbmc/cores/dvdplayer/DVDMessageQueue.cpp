@@ -36,6 +36,7 @@ CDVDMessageQueue::CDVDMessageQueue(const string &owner)
   m_bInitialized  = false;
   m_bCaching      = false;
   m_bEmptied      = true;
+  m_iWaiting      = 0;
   m_iMaxDataSize  = 0;
 
   m_TimeBack      = DVD_NOPTS_VALUE;
@@ -74,6 +75,17 @@ void CDVDMessageQueue::Flush(CDVDMsg::Message type)
       it++;
   }
 
+  for(SData::iterator it = m_data.begin(); it != m_data.end();)
+  {
+    if ((*it)->IsType(type) ||  type == CDVDMsg::NONE)
+    {
+      (*it)->Release();
+      it = m_data.erase(it);
+    }
+    else
+      it++;
+  }
+
   if (type == CDVDMsg::DEMUXER_PACKET ||  type == CDVDMsg::NONE)
   {
     m_iDataSize = 0;
@@ -120,14 +132,22 @@ MsgQueueReturnCode CDVDMessageQueue::Put(CDVDMsg* pMsg, int priority)
     return MSGQ_INVALID_MSG;
   }
 
-  SList::iterator it = m_list.begin();
-  while(it != m_list.end())
+  if (priority == 0)
   {
-    if(priority <= it->priority)
-      break;
-    it++;
+    // the queue takes over the caller's reference
+    m_data.push_back(pMsg);
+  }
+  else
+  {
+    SList::iterator it = m_list.begin();
+    while(it != m_list.end())
+    {
+      if(priority <= it->priority)
+        break;
+      it++;
+    }
+    m_list.insert(it, DVDMessageListItem(pMsg, priority));
   }
-  m_list.insert(it, DVDMessageListItem(pMsg, priority));
 
   if (pMsg->IsType(CDVDMsg::DEMUXER_PACKET) && priority == 0)
   {
@@ -144,9 +164,12 @@ MsgQueueReturnCode CDVDMessageQueue::Put(CDVDMsg* pMsg, int priority)
     }
   }
 
-  pMsg->Release();
+  if (priority != 0)
+    pMsg->Release();
 
-  SetEvent(m_hEvent); // inform waiter for new packet
+  // inform waiter for new packet; a reader that isn't waiting will find it anyway
+  if (m_iWaiting > 0)
+    SetEvent(m_hEvent);
 
   return MSGQ_OK;
 }
@@ -165,7 +188,7 @@ MsgQueueReturnCode CDVDMessageQueue::Get(CDVDMsg** pMsg, unsigned int iTimeoutIn
     return MSGQ_NOT_INITIALIZED;
   }
 
-  if(m_list.empty() && m_bEmptied == false && priority == 0 && m_owner != "teletext")
+  if(m_list.empty() && m_data.empty() && m_bEmptied == false && priority == 0 && m_owner != "teletext")
   {
     CLog::Log(LOGWARNING, "CDVDMessageQueue(%s)::Get - asked for new data packet, with nothing available", m_owner.c_str());
     m_bEmptied = true;
@@ -178,9 +201,20 @@ MsgQueueReturnCode CDVDMessageQueue::Get(CDVDMsg** pMsg, unsigned int iTimeoutIn
       DVDMessageListItem& item(m_list.back());
       priority = item.priority;
 
-      if (item.message->IsType(CDVDMsg::DEMUXER_PACKET) && item.priority == 0)
+      *pMsg = item.message->Acquire();
+      m_list.pop_back();
+
+      ret = MSGQ_OK;
+      break;
+    }
+    else if(!m_data.empty() && priority <= 0 && !m_bCaching)
+    {
+      CDVDMsg* message = m_data.front();
+      priority = 0;
+
+      if (message->IsType(CDVDMsg::DEMUXER_PACKET))
       {
-        DemuxPacket* packet = ((CDVDMsgDemuxerPacket*)item.message)->GetPacket();
+        DemuxPacket* packet = ((CDVDMsgDemuxerPacket*)message)->GetPacket();
         if(packet)
         {
           m_iDataSize -= packet->iSize;
@@ -194,8 +228,9 @@ MsgQueueReturnCode CDVDMessageQueue::Get(CDVDMsg** pMsg, unsigned int iTimeoutIn
           m_bEmptied = false;
       }
 
-      *pMsg = item.message->Acquire();
-      m_list.pop_back();
+      // hand the queue's reference on to the caller
+      *pMsg = message;
+      m_data.pop_front();
 
       ret = MSGQ_OK;
       break;
@@ -208,13 +243,17 @@ MsgQueueReturnCode CDVDMessageQueue::Get(CDVDMsg** pMsg, unsigned int iTimeoutIn
     else
     {
       ResetEvent(m_hEvent);
+      m_iWaiting++;
       lock.Leave();
 
       // wait for a new message
-      if (WaitForSingleObject(m_hEvent, iTimeoutInMilliSeconds) == WAIT_TIMEOUT)
-        return MSGQ_TIMEOUT;
+      DWORD result = WaitForSingleObject(m_hEvent, iTimeoutInMilliSeconds);
 
       lock.Enter();
+      m_iWaiting--;
+
+      if (result == WAIT_TIMEOUT)
+        return MSGQ_TIMEOUT;
     }
   }
 
@@ -237,6 +276,11 @@ unsigned CDVDMessageQueue::GetPacketCount(CDVDMsg::Message type)
     if(it->message->IsType(type))
       count++;
   }
+  for(SData::iterator it = m_data.begin(); it != m_data.end();it++)
+  {
+    if((*it)->IsType(type))
+      count++;
+  }
 
   return count;
 }
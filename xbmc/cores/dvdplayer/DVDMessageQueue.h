@@ -24,6 +24,7 @@
 #include "DVDMessage.h"
 #include <string>
 #include <list>
+#include <deque>
 #include "CriticalSection.h"
 
 struct DVDMessageListItem
@@ -135,9 +136,16 @@ private:
 
   int m_iMaxDataSize;
   bool m_bEmptied;
+  int  m_iWaiting; // readers blocked in Get, the only ones that need waking
   std::string m_owner;
 
+  // Messages of priority 0 (the stream's packets) are kept first in, first out on their own,
+  // holding the queue's reference to the message directly. The few prioritized control
+  // messages go in a list sorted by priority, highest at the back, and are always handed
+  // out before the packets.
+  typedef std::deque<CDVDMsg*> SData;
   typedef std::list<DVDMessageListItem> SList;
+  SData m_data;
   SList m_list;
 };
 
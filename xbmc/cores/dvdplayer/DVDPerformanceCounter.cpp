@@ -21,6 +21,7 @@
 
 #include "DVDPerformanceCounter.h"
 #include "DVDMessageQueue.h"
+#include "FileSystem/CacheStrategy.h"
 
 #include "dvd_config.h"
 
@@ -66,6 +67,28 @@ HRESULT __stdcall DVDPerformanceCounterVideoQueue(PLARGE_INTEGER numerator, PLAR
   return S_OK;
 }
 
+HRESULT __stdcall DVDPerformanceCounterInputCache(PLARGE_INTEGER numerator, PLARGE_INTEGER demoninator)
+{
+  numerator->QuadPart = 0LL;
+  g_dvdPerformanceCounter.Lock();
+  int iLevel = g_dvdPerformanceCounter.m_pInputCache ? g_dvdPerformanceCounter.m_pInputCache->GetCacheLevel() : -1;
+  if (iLevel > 0)
+    numerator->QuadPart = iLevel;
+  g_dvdPerformanceCounter.Unlock();
+  return S_OK;
+}
+
+HRESULT __stdcall DVDPerformanceCounterInputUnderruns(PLARGE_INTEGER numerator, PLARGE_INTEGER demoninator)
+{
+  numerator->QuadPart = 0LL;
+  g_dvdPerformanceCounter.Lock();
+  XFILE::SCacheStatus status;
+  if (g_dvdPerformanceCounter.m_pInputCache && g_dvdPerformanceCounter.m_pInputCache->GetCacheStatus(status))
+    numerator->QuadPart = status.underruns;
+  g_dvdPerformanceCounter.Unlock();
+  return S_OK;
+}
+
 inline __int64 get_thread_cpu_usage(ProcessPerformance* p)
 {
   if (p->hThread)
@@ -123,6 +146,7 @@ CDVDPerformanceCounter::CDVDPerformanceCounter()
 {
   m_pAudioQueue = NULL;
   m_pVideoQueue = NULL;
+  m_pInputCache = NULL;
 
   memset(&m_videoDecodePerformance, 0, sizeof(m_videoDecodePerformance)); // video decoding
   memset(&m_audioDecodePerformance, 0, sizeof(m_audioDecodePerformance)); // audio decoding + output to audio device
@@ -150,6 +174,8 @@ bool CDVDPerformanceCounter::Initialize()
   DmRegisterPerformanceCounter("DVDVideoDecodePerformance",   DMCOUNT_SYNC, DVDPerformanceCounterVideoDecodePerformance);
   DmRegisterPerformanceCounter("DVDAudioDecodePerformance",   DMCOUNT_SYNC, DVDPerformanceCounterAudioDecodePerformance);
   DmRegisterPerformanceCounter("DVDMainPerformance",          DMCOUNT_SYNC, DVDPerformanceCounterMainPerformance);
+  DmRegisterPerformanceCounter("DVDInputCache",               DMCOUNT_SYNC, DVDPerformanceCounterInputCache);
+  DmRegisterPerformanceCounter("DVDInputUnderruns",           DMCOUNT_SYNC, DVDPerformanceCounterInputUnderruns);
 
 #endif
 
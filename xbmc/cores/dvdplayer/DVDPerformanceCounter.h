@@ -27,6 +27,11 @@
 
 class CDVDMessageQueue;
 
+namespace XFILE
+{
+  class ICacheInterface;
+}
+
 typedef struct stProcessPerformance
 {
   ULARGE_INTEGER  timer_thread;
@@ -61,8 +66,12 @@ public:
   void EnableMainPerformance(HANDLE hThread)        { Lock(); m_mainPerformance.hThread = hThread; Unlock(); }
   void DisableMainPerformance()                     { Lock(); m_mainPerformance.hThread = NULL; Unlock(); }
 
+  void EnableInputCache(XFILE::ICacheInterface* pCache) { Lock(); m_pInputCache = pCache; Unlock(); }
+  void DisableInputCache()                          { Lock(); m_pInputCache = NULL; Unlock(); }
+
   CDVDMessageQueue*         m_pAudioQueue;
   CDVDMessageQueue*         m_pVideoQueue;
+  XFILE::ICacheInterface*   m_pInputCache;
 
   ProcessPerformance        m_videoDecodePerformance;
   ProcessPerformance        m_audioDecodePerformance;
@@ -47,6 +47,7 @@
 #include "Application.h"
 #include "DVDPerformanceCounter.h"
 #include "FileSystem/File.h"
+#include "FileSystem/CacheStrategy.h"
 #include "Picture.h"
 #include "Codecs/DllSwScale.h"
 #ifdef HAS_VIDEO_PLAYBACK
@@ -442,6 +443,7 @@ void CDVDPlayer::OnStartup()
 
 bool CDVDPlayer::OpenInputStream()
 {
+  g_dvdPerformanceCounter.DisableInputCache();
   if(m_pInputStream)
     SAFE_DELETE(m_pInputStream);
 
@@ -471,6 +473,8 @@ bool CDVDPlayer::OpenInputStream()
     return false;
   }
 
+  g_dvdPerformanceCounter.EnableInputCache(m_pInputStream->GetCache());
+
   // find any available external subtitles for non dvd files
   if (!m_pInputStream->IsStreamType(DVDSTREAM_TYPE_DVD)
   &&  !m_pInputStream->IsStreamType(DVDSTREAM_TYPE_TV)
@@ -2213,6 +2217,7 @@ void CDVDPlayer::OnExit()
     m_pSubtitleDemuxer = NULL;
 
     // destroy the inputstream
+    g_dvdPerformanceCounter.DisableInputCache();
     if (m_pInputStream)
     {
       CLog::Log(LOGNOTICE, "CDVDPlayer::OnExit() deleting input stream");
@@ -2225,6 +2230,8 @@ void CDVDPlayer::OnExit()
 
     m_messenger.End();
 
+    // everything's been played or flushed, so the recycled packets aren't needed any more
+    CDVDDemuxUtils::TrimPacketPool();
   }
   catch (...)
   {
@@ -2747,10 +2754,22 @@ void CDVDPlayer::GetGeneralInfo(CStdString& strGeneralInfo)
     CStdString strEDL;
     strEDL.AppendFormat(", edl:%s", m_Edl.GetInfo().c_str());
 
-    strGeneralInfo.Format("C( ad:% 6.3f, a/v:% 6.3f%s, dcpu:%2i%% acpu:%2i%% vcpu:%2i%% )"
+    // seconds of the stream cached ahead, of those wanted, and how often playback has caught up with it
+    CStdString strCache;
+    XFILE::SCacheStatus status;
+    XFILE::ICacheInterface* cache = m_pInputStream ? m_pInputStream->GetCache() : NULL;
+    if (cache && cache->GetCacheStatus(status) && status.readRate > 0)
+      strCache.Format(", cache:%.1f/%.1fs in:%.1fMbit stalls:%u"
+                     , (double)status.forward / status.readRate
+                     , (double)status.target / status.readRate
+                     , status.writeRate * 8.0 / 1000000
+                     , status.underruns);
+
+    strGeneralInfo.Format("C( ad:% 6.3f, a/v:% 6.3f%s%s, dcpu:%2i%% acpu:%2i%% vcpu:%2i%% )"
                          , dDelay
                          , dDiff
                          , strEDL.c_str()
+                         , strCache.c_str()
                          , (int)(CThread::GetRelativeUsage()*100)
                          , (int)(m_dvdPlayerAudio.GetRelativeUsage()*100)
                          , (int)(m_dvdPlayerVideo.GetRelativeUsage()*100));
@@ -24,6 +24,7 @@
 #include "GUISettings.h"
 #include "FileItem.h"
 #include "MusicInfoTag.h"
+#include "utils/PCMAmplifier.h"
 #include "utils/SingleLock.h"
 #include "utils/log.h"
 #include <math.h>
@@ -269,14 +270,7 @@ void CAudioDecoder::ProcessAudio(float *data, int numsamples)
 {
   if (g_guiSettings.m_replayGain.iType != REPLAY_GAIN_NONE)
   {
-    float gainFactor = GetReplayGain();
-    for (int i = 0; i < numsamples; i++)
-    {
-      data[i] *= gainFactor;
-      // check the range (is this needed here?)
-      if (data[i] > 1.0f) data[i] = 1.0f;
-      if (data[i] < -1.0f) data[i] = -1.0f;
-    }
+    CPCMAmplifier::Scale(data, numsamples, GetReplayGain());
   }
 }
 
@@ -31,6 +31,10 @@
 #endif
 #endif
 
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+
 #include "log.h"
 #include "AdvancedSettings.h"
 
@@ -57,6 +61,7 @@ CCPUInfo::CCPUInfo(void)
 {
   m_fProcStat = m_fProcTemperature = m_fCPUInfo = NULL;
   m_lastUsedPercentage = 0;
+  m_cpuFeatures = 0;
 
 #ifdef __APPLE__
   size_t len = 4;
@@ -158,6 +163,12 @@ CCPUInfo::CCPUInfo(void)
           m_cores[nCurrId].m_strModel.Trim();
         }
       }
+      else if (strncmp(buffer, "Features", strlen("Features"))==0)
+      {
+        // arm lists what the cpu supports here rather than in cpuid
+        if (strstr(buffer, " neon"))
+          m_cpuFeatures |= CPU_FEATURE_NEON;
+      }
     }
   }
   else
@@ -168,6 +179,39 @@ CCPUInfo::CCPUInfo(void)
 
   readProcStat(m_userTicks, m_niceTicks, m_systemTicks, m_idleTicks, m_ioTicks);
 #endif
+
+  ReadCPUFeatures();
+}
+
+void CCPUInfo::ReadCPUFeatures()
+{
+#if defined(_MSC_VER) && (defined(_M_IX86) || defined(_M_X64))
+  int info[4];
+  __cpuid(info, 1);
+  unsigned int ecx = info[2], edx = info[3];
+#elif defined(__i386__)
+  // ebx holds the GOT in PIC code, so it has to be preserved by hand
+  unsigned int eax = 1, ebx, ecx, edx;
+  __asm__ ("movl %%ebx, %%esi\n\t"
+           "cpuid\n\t"
+           "xchgl %%ebx, %%esi"
+           : "+a" (eax), "=S" (ebx), "=c" (ecx), "=d" (edx));
+#elif defined(__x86_64__)
+  unsigned int eax = 1, ebx, ecx, edx;
+  __asm__ ("cpuid" : "+a" (eax), "=b" (ebx), "=c" (ecx), "=d" (edx));
+#else
+  unsigned int ecx = 0, edx = 0;
+#endif
+
+  if (edx & (1 << 23)) m_cpuFeatures |= CPU_FEATURE_MMX;
+  if (edx & (1 << 25)) m_cpuFeatures |= CPU_FEATURE_SSE;
+  if (edx & (1 << 26)) m_cpuFeatures |= CPU_FEATURE_SSE2;
+  if (ecx & (1 << 0))  m_cpuFeatures |= CPU_FEATURE_SSE3;
+
+#if defined(__ARM_NEON__) && defined(__APPLE__)
+  // there's no /proc/cpuinfo to ask, and a build using neon only runs on devices having it
+  m_cpuFeatures |= CPU_FEATURE_NEON;
+#endif
 }
 
 CCPUInfo::~CCPUInfo()
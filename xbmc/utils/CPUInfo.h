@@ -29,6 +29,20 @@
 #include <string>
 #include <map>
 
+#define CPU_FEATURE_MMX      0x0001
+#define CPU_FEATURE_SSE      0x0002
+#define CPU_FEATURE_SSE2     0x0004
+#define CPU_FEATURE_SSE3     0x0008
+#define CPU_FEATURE_NEON     0x0010
+
+// whether the compiler can build SIMD code, GetCPUFeatures() says whether the CPU can run it
+#if defined(__SSE2__) || (defined(_MSC_VER) && (defined(_M_IX86) || defined(_M_X64)))
+#define HAS_SSE2_INTRINSICS
+#endif
+#if defined(__ARM_NEON__)
+#define HAS_NEON_INTRINSICS
+#endif
+
 struct CoreInfo
 {
   int    m_id;
@@ -61,7 +75,10 @@ public:
 
   CStdString GetCoresUsageString() const;
 
+  unsigned int GetCPUFeatures() const { return m_cpuFeatures; }
+
 private:
+  void ReadCPUFeatures();
   bool readProcStat(unsigned long long& user, unsigned long long& nice, unsigned long long& system,
     unsigned long long& idle, unsigned long long& io);
 
@@ -79,6 +96,7 @@ private:
   time_t m_lastReadTime;
   std::string m_cpuModel;
   int m_cpuCount;
+  unsigned int m_cpuFeatures;
 
   std::map<int, CoreInfo> m_cores;
 };
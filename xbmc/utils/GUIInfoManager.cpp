@@ -75,6 +75,8 @@
 #include "addons/Skin.h"
 #include "MediaManager.h"
 #include "TimeUtils.h"
+#include "GUIControlProfiler.h"
+#include "tinyXML/tinyxml.h"
 #include "SingleLock.h"
 #include "log.h"
 #include "PlayList.h"
@@ -98,6 +100,7 @@ CGUIInfoManager::CCombinedValue& CGUIInfoManager::CCombinedValue::operator =(con
   this->m_info = mSrc.m_info;
   this->m_id = mSrc.m_id;
   this->m_postfix = mSrc.m_postfix;
+  this->m_sources = mSrc.m_sources;
   return *this;
 }
 
@@ -112,6 +115,9 @@ CGUIInfoManager::CGUIInfoManager(void)
   m_performingSeek = false;
   m_nextWindowID = WINDOW_INVALID;
   m_prevWindowID = WINDOW_INVALID;
+  m_changedSources = 0;
+  m_windowState = 0;
+  m_playerState = 0;
   m_stringParameters.push_back("__ZZZZ__");   // to offset the string parameters by 1 to assure that all entries are non-zero
   m_currentFile = CFileItemPtr(new CFileItem);
   m_currentSlide = new CFileItem;
@@ -167,7 +173,10 @@ int CGUIInfoManager::TranslateString(const CStdString &condition)
     return TranslateBooleanExpression(strCondition);
   }
   //Just single command.
-  return TranslateSingleString(strCondition);
+  int ret = TranslateSingleString(strCondition);
+  if (ret)
+    m_conditionNames.insert(make_pair(ret, strCondition));
+  return ret;
 }
 
 
@@ -1037,8 +1046,7 @@ CStdString CGUIInfoManager::GetLabel(int info, int contextWindow)
     if (!m_currentFile)
       return "";
 
-    CStdString property = m_listitemProperties[info - LISTITEM_PROPERTY_START-MUSICPLAYER_PROPERTY_OFFSET];
-    return m_currentFile->GetProperty(property);
+    return m_currentFile->GetProperty(m_listitemPropertyKeys[info - LISTITEM_PROPERTY_START-MUSICPLAYER_PROPERTY_OFFSET]);
   }
 
   if (info >= LISTITEM_START && info <= LISTITEM_END)
@@ -1750,13 +1758,29 @@ int CGUIInfoManager::GetInt(int info, int contextWindow) const
 }
 // checks the condition and returns it as necessary.  Currently used
 // for toggle button controls and visibility of images.
-bool CGUIInfoManager::GetBool(int condition1, int contextWindow, const CGUIListItem *item)
+bool CGUIInfoManager::GetBool(int condition, int contextWindow, const CGUIListItem *item)
 {
   // check our cache
-  bool bReturn = false;
-  if (!item && IsCached(condition1, contextWindow, bReturn)) // never use cache for list items
-    return bReturn;
+  bool result = false;
+  if (!item && IsCached(condition, contextWindow, result)) // never use cache for list items
+  {
+    if (CGUIControlProfiler::IsRunning())
+      ProfileCondition(condition, true, 0);
+    return result;
+  }
+
+  if (!CGUIControlProfiler::IsRunning())
+    return EvaluateBool(condition, contextWindow, item);
 
+  int64_t start = CurrentHostCounter();
+  result = EvaluateBool(condition, contextWindow, item);
+  ProfileCondition(condition, false, CurrentHostCounter() - start);
+  return result;
+}
+
+bool CGUIInfoManager::EvaluateBool(int condition1, int contextWindow, const CGUIListItem *item)
+{
+  bool bReturn = false;
   int condition = abs(condition1);
 
   if(condition >= COMBINED_VALUES_START && (condition - COMBINED_VALUES_START) < (int)(m_CombinedValues.size()) )
@@ -3695,6 +3719,7 @@ int CGUIInfoManager::TranslateBooleanExpression(const CStdString &expression)
   CCombinedValue comb;
   comb.m_info = expression;
   comb.m_id = COMBINED_VALUES_START + m_CombinedValues.size();
+  comb.m_sources = INFO_SOURCE_NONE;
 
   // operator stack
   stack<char> save;
@@ -3710,7 +3735,10 @@ int CGUIInfoManager::TranslateBooleanExpression(const CStdString &expression)
       {
         int iOp = TranslateSingleString(operand);
         if (iOp)
+        {
           comb.m_postfix.push_back(iOp);
+          comb.m_sources |= GetInfoSources(iOp);
+        }
         operand.clear();
       }
       // handle closing parenthesis
@@ -3753,7 +3781,10 @@ int CGUIInfoManager::TranslateBooleanExpression(const CStdString &expression)
   {
     int op = TranslateSingleString(operand);
     if (op)
+    {
       comb.m_postfix.push_back(op);
+      comb.m_sources |= GetInfoSources(op);
+    }
   }
 
   // finish up by adding any operators
@@ -3775,6 +3806,10 @@ int CGUIInfoManager::TranslateBooleanExpression(const CStdString &expression)
 void CGUIInfoManager::Clear()
 {
   m_CombinedValues.clear();
+
+  // the ids of combined values are handed out again
+  CSingleLock lock(m_critInfo);
+  m_boolCache.clear();
 }
 
 void CGUIInfoManager::UpdateFPS()
@@ -3801,6 +3836,7 @@ int CGUIInfoManager::AddListItemProp(const CStdString &str, int offset)
   if (m_listitemProperties.size() < LISTITEM_PROPERTY_END - LISTITEM_PROPERTY_START)
   {
     m_listitemProperties.push_back(str);
+    m_listitemPropertyKeys.push_back(CGUIListItem::GetPropertyKey(str));
     return LISTITEM_PROPERTY_START + offset + m_listitemProperties.size() - 1;
   }
 
@@ -3840,14 +3876,15 @@ CStdString CGUIInfoManager::GetItemLabel(const CFileItem *item, int info) const
   if (info >= LISTITEM_PROPERTY_START && info - LISTITEM_PROPERTY_START < (int)m_listitemProperties.size())
   { // grab the property
     CStdString property = m_listitemProperties[info - LISTITEM_PROPERTY_START];
+    CGUIListItem::PropertyKey key = m_listitemPropertyKeys[info - LISTITEM_PROPERTY_START];
     
     // If we don't have fanart (yet?) and we have fallback fanart, use it.
     if (property == "fanart_image" &&
-        item->GetProperty(property).size() == 0 &&
+        item->GetProperty(key).size() == 0 &&
         item->GetProperty("fanart_image_fallback").size() > 0)
       return item->GetProperty("fanart_image_fallback");
     
-    return item->GetProperty(property);
+    return item->GetProperty(key);
   }
 
   switch (info)
@@ -4257,8 +4294,7 @@ bool CGUIInfoManager::GetItemBool(const CGUIListItem *item, int condition, int s
   if (!item) return false;
   if (condition >= LISTITEM_PROPERTY_START && condition - LISTITEM_PROPERTY_START < (int)m_listitemProperties.size())
   { // grab the property
-    CStdString property = m_listitemProperties[condition - LISTITEM_PROPERTY_START];
-    CStdString val = item->GetProperty(property);
+    CStdString val = item->GetProperty(m_listitemPropertyKeys[condition - LISTITEM_PROPERTY_START]);
     return (val == "1" || val.CompareNoCase("true") == 0);
   }
   else if (condition == LISTITEM_ISPLAYING)
@@ -4307,12 +4343,123 @@ void CGUIInfoManager::ResetCache()
   m_containerMoves.clear();
 }
 
+void CGUIInfoManager::ResetFrameCache()
+{
+  UpdateCache();
+  CSingleLock lock(m_critInfo);
+  InvalidateCache(INFO_SOURCE_ALWAYS);
+  // reset any animation triggers as well
+  m_containerMoves.clear();
+}
+
 void CGUIInfoManager::ResetPersistentCache()
 {
   CSingleLock lock(m_critInfo);
   m_persistentBoolCache.clear();
 }
 
+void CGUIInfoManager::UpdateCache()
+{
+  // window and player state change all over the place, so look for changes rather than
+  // be told about them
+  uint32_t windowState = g_windowManager.GetStateHash();
+  windowState = windowState * 31 + m_nextWindowID;
+  windowState = windowState * 31 + m_prevWindowID;
+  uint32_t playerState = GetPlayerState();
+
+  CSingleLock lock(m_critInfo);
+  unsigned int changed = m_changedSources;
+  if (windowState != m_windowState)
+    changed |= INFO_SOURCE_WINDOW;
+  if (playerState != m_playerState)
+    changed |= INFO_SOURCE_PLAYER;
+  m_windowState = windowState;
+  m_playerState = playerState;
+  m_changedSources = 0;
+
+  if (changed)
+    InvalidateCache(changed);
+}
+
+void CGUIInfoManager::SetSourceChanged(unsigned int sources)
+{
+  CSingleLock lock(m_critInfo);
+  m_changedSources |= sources;
+  InvalidateCache(sources);
+}
+
+void CGUIInfoManager::InvalidateCache(unsigned int sources)
+{
+  CSingleLock lock(m_critInfo);
+  map<int, CachedBool>::iterator it = m_boolCache.begin();
+  while (it != m_boolCache.end())
+  {
+    if (it->second.sources & sources)
+      m_boolCache.erase(it++);
+    else
+      ++it;
+  }
+}
+
+uint32_t CGUIInfoManager::GetPlayerState() const
+{
+  if (!g_application.IsPlaying())
+    return 0;
+
+  uint32_t state = 1;
+  if (g_application.IsPlayingAudio()) state |= 2;
+  if (g_application.IsPlayingVideo()) state |= 4;
+  if (g_application.IsPaused())       state |= 8;
+  return state | ((uint32_t)(g_application.GetPlaySpeed() & 0xffff) << 16);
+}
+
+unsigned int CGUIInfoManager::GetInfoSources(int condition) const
+{
+  condition = abs(condition);
+  if (condition >= COMBINED_VALUES_START)
+  {
+    if (condition - COMBINED_VALUES_START < (int)m_CombinedValues.size())
+      return m_CombinedValues[condition - COMBINED_VALUES_START].m_sources;
+    return INFO_SOURCE_ALWAYS;
+  }
+  if (condition >= MULTI_INFO_START && condition <= MULTI_INFO_END)
+  {
+    if (condition - MULTI_INFO_START >= (int)m_multiInfo.size())
+      return INFO_SOURCE_ALWAYS;
+    switch (abs(m_multiInfo[condition - MULTI_INFO_START].m_info))
+    {
+    case SKIN_BOOL:
+    case SKIN_STRING:
+      return INFO_SOURCE_SKIN;
+    case WINDOW_NEXT:
+    case WINDOW_PREVIOUS:
+    case WINDOW_IS_VISIBLE:
+    case WINDOW_IS_TOPMOST:
+    case WINDOW_IS_ACTIVE:
+      return INFO_SOURCE_WINDOW;
+    }
+    return INFO_SOURCE_ALWAYS;
+  }
+  if (condition >= PLAYER_HAS_MEDIA && condition <= PLAYER_FORWARDING_32x)
+    return INFO_SOURCE_PLAYER;
+  if (condition >= SKIN_HAS_THEME_START && condition <= SKIN_HAS_THEME_END)
+    return INFO_SOURCE_SKIN;
+  switch (condition)
+  {
+  case SYSTEM_ALWAYS_TRUE:
+  case SYSTEM_ALWAYS_FALSE:
+  case SYSTEM_ETHERNET_LINK_ACTIVE:
+  case SYSTEM_PLATFORM_XBOX:
+  case SYSTEM_PLATFORM_LINUX:
+  case SYSTEM_PLATFORM_WINDOWS:
+  case SYSTEM_PLATFORM_OSX:
+    return INFO_SOURCE_NONE;
+  case WINDOW_IS_MEDIA:
+    return INFO_SOURCE_WINDOW;
+  }
+  return INFO_SOURCE_ALWAYS;
+}
+
 inline void CGUIInfoManager::CacheBool(int condition, int contextWindow, bool result, bool persistent)
 {
   // windows have id's up to 13100 or thereabouts (ie 2^14 needed)
@@ -4322,7 +4469,10 @@ inline void CGUIInfoManager::CacheBool(int condition, int contextWindow, bool re
   if (persistent)
     m_persistentBoolCache.insert(pair<int, bool>(hash, result));
   else
-    m_boolCache.insert(pair<int, bool>(hash, result));
+  {
+    CachedBool cached = { result, GetInfoSources(condition) };
+    m_boolCache.insert(pair<int, CachedBool>(hash, cached));
+  }
 }
 
 bool CGUIInfoManager::IsCached(int condition, int contextWindow, bool &result) const
@@ -4332,13 +4482,13 @@ bool CGUIInfoManager::IsCached(int condition, int contextWindow, bool &result) c
 
   CSingleLock lock(m_critInfo);
   int hash = ((contextWindow & 0x3fff) << 18) | (condition & 0x3ffff);
-  map<int, bool>::const_iterator it = m_boolCache.find(hash);
-  if (it != m_boolCache.end())
+  map<int, CachedBool>::const_iterator cached = m_boolCache.find(hash);
+  if (cached != m_boolCache.end())
   {
-    result = (*it).second;
+    result = (*cached).second.result;
     return true;
   }
-  it = m_persistentBoolCache.find(hash);
+  map<int, bool>::const_iterator it = m_persistentBoolCache.find(hash);
   if (it != m_persistentBoolCache.end())
   {
     result = (*it).second;
@@ -4348,6 +4498,74 @@ bool CGUIInfoManager::IsCached(int condition, int contextWindow, bool &result) c
   return false;
 }
 
+void CGUIInfoManager::ProfileCondition(int condition, bool cacheHit, int64_t time)
+{
+  CSingleLock lock(m_critInfo);
+  map<int, ConditionProfile>::iterator it = m_conditionProfile.find(condition);
+  if (it == m_conditionProfile.end())
+  {
+    ConditionProfile profile = { 0, 0, 0 };
+    it = m_conditionProfile.insert(make_pair(condition, profile)).first;
+  }
+  if (cacheHit)
+    it->second.cacheHits++;
+  else
+  {
+    it->second.evaluations++;
+    it->second.time += time;
+  }
+}
+
+void CGUIInfoManager::ResetConditionProfile()
+{
+  CSingleLock lock(m_critInfo);
+  m_conditionProfile.clear();
+}
+
+void CGUIInfoManager::SaveConditionProfile(TiXmlElement *root) const
+{
+  CSingleLock lock(m_critInfo);
+
+  // most expensive first, time includes any conditions an expression is made of
+  multimap<int64_t, int> byTime;
+  for (map<int, ConditionProfile>::const_iterator it = m_conditionProfile.begin(); it != m_conditionProfile.end(); ++it)
+    byTime.insert(make_pair(-it->second.time, it->first));
+
+  TiXmlElement *conditions = new TiXmlElement("conditions");
+  root->LinkEndChild(conditions);
+  double scale = 1000.0 / CurrentHostFrequency();
+  for (multimap<int64_t, int>::const_iterator it = byTime.begin(); it != byTime.end(); ++it)
+  {
+    int condition = it->second;
+    const ConditionProfile &profile = m_conditionProfile.find(condition)->second;
+
+    CStdString expression;
+    int id = abs(condition);
+    if (id >= COMBINED_VALUES_START && id - COMBINED_VALUES_START < (int)m_CombinedValues.size())
+      expression = m_CombinedValues[id - COMBINED_VALUES_START].m_info;
+    else
+    {
+      map<int, CStdString>::const_iterator name = m_conditionNames.find(condition);
+      if (name != m_conditionNames.end())
+        expression = name->second;
+      else
+        expression.Format("%d", condition);
+    }
+
+    TiXmlElement *element = new TiXmlElement("condition");
+    element->SetAttribute("expression", expression.c_str());
+    element->SetAttribute("evaluations", (int)profile.evaluations);
+    element->SetAttribute("cachehits", (int)profile.cacheHits);
+    CStdString time;
+    time.Format("%.3f", profile.time * scale);
+    element->SetAttribute("time", time.c_str());
+    CStdString sources;
+    sources.Format("%x", GetInfoSources(condition));
+    element->SetAttribute("sources", sources.c_str());
+    conditions->LinkEndChild(element);
+  }
+}
+
 // Called from tuxbox service thread to update current status
 void CGUIInfoManager::UpdateFromTuxBox()
 {
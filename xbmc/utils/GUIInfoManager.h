@@ -532,9 +532,17 @@ typedef boost::shared_ptr < CFileItem > CFileItemPtr;
 #define MULTI_INFO_END                99999
 #define COMBINED_VALUES_START        100000
 
+// what a condition's value depends on, so cached values are only dropped when that changes
+#define INFO_SOURCE_NONE              0           // never changes, eg the platform
+#define INFO_SOURCE_WINDOW            (1 << 0)    // active window, dialogs and next/previous window
+#define INFO_SOURCE_PLAYER            (1 << 1)    // whether anything is playing, and how
+#define INFO_SOURCE_SKIN              (1 << 2)    // skin settings
+#define INFO_SOURCE_ALWAYS            (1 << 31)   // anything else, evaluated afresh every frame
+
 // forward
 class CInfoLabel;
 class CGUIWindow;
+class TiXmlElement;
 
 // Info Flags
 // Stored in the top 8 bits of GUIInfo::m_data1
@@ -649,9 +657,33 @@ public:
   void SetNextWindow(int windowID) { m_nextWindowID = windowID; };
   void SetPreviousWindow(int windowID) { m_prevWindowID = windowID; };
 
+  /*! \brief Drop every cached condition result
+   */
   void ResetCache();
+
+  /*! \brief Drop cached condition results at the end of a frame
+   Results that only depend on window, player or skin state are kept until that state changes,
+   everything else is evaluated again next frame.
+   \sa UpdateCache, SetSourceChanged
+   */
+  void ResetFrameCache();
+
+  /*! \brief Drop cached condition results whose window or player state has changed
+   Called before rendering so that changes made while processing input show up that frame.
+   */
+  void UpdateCache();
+
+  /*! \brief Drop cached condition results that depend on the given sources
+   \param sources INFO_SOURCE_* flags
+   */
+  void SetSourceChanged(unsigned int sources);
   void ResetPersistentCache();
 
+  /*! \brief Record how often, and for how long, each condition is evaluated while the GUI profiler runs
+   */
+  void ResetConditionProfile();
+  void SaveConditionProfile(TiXmlElement *root) const;
+
   CStdString GetItemLabel(const CFileItem *item, int info) const;
   CStdString GetItemImage(const CFileItem *item, int info) const;
 
@@ -704,6 +736,7 @@ protected:
   // Array of multiple information mapped to a single integer lookup
   std::vector<GUIInfo> m_multiInfo;
   std::vector<std::string> m_listitemProperties;
+  std::vector<unsigned int> m_listitemPropertyKeys; ///< interned keys for m_listitemProperties
 
   CStdString m_currentMovieDuration;
 
@@ -744,6 +777,7 @@ protected:
     CStdString m_info;    // the text expression
     int m_id;             // the id used to identify this expression
     std::list<int> m_postfix;  // the postfix binary expression
+    unsigned int m_sources;    // INFO_SOURCE_* flags of all the operands
     CCombinedValue& operator=(const CCombinedValue& mSrc);
   };
 
@@ -753,10 +787,35 @@ protected:
 
   std::vector<CCombinedValue> m_CombinedValues;
 
+  bool EvaluateBool(int condition, int contextWindow, const CGUIListItem *item);
+
   // routines for caching the bool results
   bool IsCached(int condition, int contextWindow, bool &result) const;
   void CacheBool(int condition, int contextWindow, bool result, bool persistent=false);
-  std::map<int, bool> m_boolCache;
+  unsigned int GetInfoSources(int condition) const;
+  uint32_t GetPlayerState() const;
+  void InvalidateCache(unsigned int sources);
+
+  struct CachedBool
+  {
+    bool result;
+    unsigned int sources;
+  };
+  std::map<int, CachedBool> m_boolCache;
+  unsigned int m_changedSources;  // sources changed since the last UpdateCache()
+  uint32_t m_windowState;         // window and player state at the last UpdateCache()
+  uint32_t m_playerState;
+
+  // condition profiling
+  struct ConditionProfile
+  {
+    unsigned int evaluations;
+    unsigned int cacheHits;
+    int64_t time;
+  };
+  void ProfileCondition(int condition, bool cacheHit, int64_t time);
+  std::map<int, ConditionProfile> m_conditionProfile;
+  std::map<int, CStdString> m_conditionNames;  // for single conditions, combined ones keep their own
 
   // persistent cache
   std::map<int, bool> m_persistentBoolCache;
@@ -105,7 +105,7 @@ public:
     PRIORITY_NORMAL,
     PRIORITY_HIGH
   };
-  CJob() { m_callback = NULL; };
+  CJob() { m_callback = NULL; m_cancelled = false; };
 
   /*!
    \brief Destructor for job objects.
@@ -145,6 +145,39 @@ public:
     return false;
   }
 
+  /*!
+   \brief Hash of the fields compared by operator==.
+
+   Jobs that are equal must return the same hash.  CJobQueue uses it to find duplicates without
+   comparing against every queued job, so subclasses overriding operator== should override this too.
+
+   \return the hash, or 0 to be compared against all other jobs that return 0.
+   \sa CJobQueue
+   */
+  virtual unsigned int GetHash() const { return 0; }
+
+  /*!
+   \brief Affinity group of the job.
+
+   Jobs in the same non-zero group are queued on the same worker thread where possible, so that
+   related work (e.g. the same file or server) tends to run back to back on one thread. Idle
+   workers may still take them, so this is a hint rather than a guarantee of ordering.
+
+   \return the affinity group, or 0 for none.
+   \sa CJobManager
+   */
+  virtual unsigned int GetAffinity() const { return 0; }
+
+  /*!
+   \brief Cheap check for whether the job has been cancelled while running.
+
+   Unlike ShouldCancel() this takes no locks and makes no callbacks, so it may be polled often.
+
+   \return true if CJobManager::CancelJob() has been called for this job.
+   \sa ShouldCancel()
+   */
+  bool IsCancelled() const { return m_cancelled; }
+
   /*!
    \brief Function for longer jobs to report progress and check whether they have been cancelled.
    
@@ -161,4 +194,5 @@ public:
 private:
   friend class CJobManager;
   CJobManager *m_callback;
+  volatile bool m_cancelled;
 };
@@ -22,11 +22,16 @@
 #include "JobManager.h"
 #include <algorithm>
 #include "SingleLock.h"
+#include "Atomics.h"
+#include "CPUInfo.h"
+#include "AdvancedSettings.h"
 
 using namespace std;
 
 bool CJob::ShouldCancel(unsigned int progress, unsigned int total) const
 {
+  if (m_cancelled)
+    return true;
   if (m_callback)
     return m_callback->OnJobProgress(progress, total, this);
   return false;
@@ -87,7 +92,10 @@ void CJobQueue::OnJobComplete(unsigned int jobID, bool success, CJob *job)
   // check if this job is in our processing list
   Processing::iterator i = find(m_processing.begin(), m_processing.end(), job);
   if (i != m_processing.end())
+  {
+    RemoveFromIndex(job);
     m_processing.erase(i);
+  }
   // request a new job be queued
   QueueNextJob();
 }
@@ -96,8 +104,7 @@ void CJobQueue::AddJob(CJob *job)
 {
   CSingleLock lock(m_section);
   // check if we have this job already.  If so, we're done.
-  if (find(m_jobQueue.begin(), m_jobQueue.end(), job) != m_jobQueue.end() ||
-      find(m_processing.begin(), m_processing.end(), job) != m_processing.end())
+  if (HasJob(job))
   {
     delete job;
     return;
@@ -107,9 +114,34 @@ void CJobQueue::AddJob(CJob *job)
     m_jobQueue.push_back(CJobPointer(job));
   else
     m_jobQueue.push_front(CJobPointer(job));
+  m_index.insert(make_pair(job->GetHash(), job));
   QueueNextJob();
 }
 
+bool CJobQueue::HasJob(const CJob *job) const
+{
+  pair<Index::const_iterator, Index::const_iterator> range = m_index.equal_range(job->GetHash());
+  for (Index::const_iterator i = range.first; i != range.second; ++i)
+  {
+    if (*i->second == job)
+      return true;
+  }
+  return false;
+}
+
+void CJobQueue::RemoveFromIndex(const CJob *job)
+{
+  pair<Index::iterator, Index::iterator> range = m_index.equal_range(job->GetHash());
+  for (Index::iterator i = range.first; i != range.second; ++i)
+  {
+    if (i->second == job)
+    {
+      m_index.erase(i);
+      return;
+    }
+  }
+}
+
 void CJobQueue::QueueNextJob()
 {
   CSingleLock lock(m_section);
@@ -129,6 +161,7 @@ void CJobQueue::CancelJobs()
   for_each(m_jobQueue.begin(), m_jobQueue.end(), mem_fun_ref(&CJobPointer::FreeJob));
   m_jobQueue.clear();
   m_processing.clear();
+  m_index.clear();
 }
 
 CJobManager &CJobManager::GetInstance()
@@ -140,6 +173,7 @@ CJobManager &CJobManager::GetInstance()
 CJobManager::CJobManager()
 {
   m_jobCounter = 0;
+  m_active = 0;
   m_running = true;
 }
 
@@ -148,15 +182,18 @@ void CJobManager::CancelJobs()
   CSingleLock lock(m_section);
   m_running = false;
 
-  // clear any pending jobs
-  for (unsigned int priority = CJob::PRIORITY_LOW; priority <= CJob::PRIORITY_HIGH; ++priority)
+  // cancel any callbacks on jobs still processing, and mark the rest to be
+  // thrown away by whoever pops them
+  for (Jobs::iterator i = m_jobs.begin(); i != m_jobs.end(); ++i)
   {
-    for_each(m_jobQueue[priority].begin(), m_jobQueue[priority].end(), mem_fun_ref(&CWorkItem::FreeJob));
-    m_jobQueue[priority].clear();
+    CWorkItem *item = i->second;
+    item->Cancel();
+    if (find(m_processing.begin(), m_processing.end(), item) != m_processing.end())
+      item->m_job->m_cancelled = true;
+    else
+      item->m_cancelled = true;
   }
-
-  // cancel any callbacks on jobs still processing
-  for_each(m_processing.begin(), m_processing.end(), mem_fun_ref(&CWorkItem::Cancel));
+  m_jobs.clear();
 
   // tell our workers to finish
   while (m_workers.size())
@@ -166,6 +203,17 @@ void CJobManager::CancelJobs()
     Sleep(0); // yield after setting the event to give the workers some time to die
     lock.Enter();
   }
+
+  // clear any pending jobs
+  for (unsigned int priority = CJob::PRIORITY_LOW; priority <= CJob::PRIORITY_HIGH; ++priority)
+  {
+    for (JobQueue::iterator i = m_jobQueue[priority].begin(); i != m_jobQueue[priority].end(); ++i)
+    {
+      (*i)->FreeJob();
+      delete *i;
+    }
+    m_jobQueue[priority].clear();
+  }
 }
 
 CJobManager::~CJobManager()
@@ -177,32 +225,96 @@ unsigned int CJobManager::AddJob(CJob *job, IJobCallback *callback, CJob::PRIORI
   CSingleLock lock(m_section);
 
   // create a work item for this job
-  CWorkItem work(job, m_jobCounter++, callback);
-  m_jobQueue[priority].push_back(work);
+  CWorkItem *work = new CWorkItem(job, m_jobCounter++, callback, priority);
+  m_jobs[work->m_id] = work;
+
+  CJobWorker *worker = GetWorkerForJob(job);
+  if (worker)
+  {
+    CSingleLock workerLock(worker->m_section);
+    worker->m_jobQueue[priority].push_back(work);
+  }
+  else
+    m_jobQueue[priority].push_back(work);
 
   StartWorkers(priority);
-  return work.m_id;
+  return work->m_id;
 }
 
 void CJobManager::CancelJob(unsigned int jobID)
 {
   CSingleLock lock(m_section);
 
-  // check whether we have this job in the queue
-  for (unsigned int priority = CJob::PRIORITY_LOW; priority <= CJob::PRIORITY_HIGH; ++priority)
+  Jobs::iterator i = m_jobs.find(jobID);
+  if (i == m_jobs.end())
+    return;
+
+  CWorkItem *item = i->second;
+  item->Cancel();
+  if (find(m_processing.begin(), m_processing.end(), item) != m_processing.end())
   {
-    JobQueue::iterator i = find(m_jobQueue[priority].begin(), m_jobQueue[priority].end(), jobID);
-    if (i != m_jobQueue[priority].end())
-    {
-      delete i->m_job;
-      m_jobQueue[priority].erase(i);
-      return;
-    }
+    // job is in progress, so only thing to do is to remove callback and let it know
+    item->m_job->m_cancelled = true;
+  }
+  else
+  {
+    // still queued - rather than search the queues for it, leave it to be freed when popped
+    item->m_cancelled = true;
+    m_jobs.erase(i);
   }
-  // or if we're processing it
-  Processing::iterator it = find(m_processing.begin(), m_processing.end(), jobID);
-  if (it != m_processing.end())
-    it->m_callback = NULL; // job is in progress, so only thing to do is to remove callback
+}
+
+bool CJobManager::RaisePriority(unsigned int jobID, CJob::PRIORITY priority)
+{
+  CSingleLock lock(m_section);
+
+  Jobs::iterator i = m_jobs.find(jobID);
+  if (i == m_jobs.end())
+    return false;
+
+  CWorkItem *item = i->second;
+  if (find(m_processing.begin(), m_processing.end(), item) != m_processing.end())
+    return false;
+  if (item->m_priority >= priority)
+    return true;
+
+  // as with CancelJob(), the old item is left in its queue to be freed when popped, but without
+  // the job, which goes on with a new item in the higher priority queue
+  CWorkItem *raised = new CWorkItem(item->m_job, item->m_id, item->m_callback, priority);
+  item->m_job = NULL;
+  item->m_cancelled = true;
+  i->second = raised;
+
+  CJobWorker *worker = GetWorkerForJob(raised->m_job);
+  if (worker)
+  {
+    CSingleLock workerLock(worker->m_section);
+    worker->m_jobQueue[priority].push_back(raised);
+  }
+  else
+    m_jobQueue[priority].push_back(raised);
+
+  StartWorkers(priority);
+  return true;
+}
+
+CJobWorker *CJobManager::GetWorkerForJob(const CJob *job) const
+{
+  CSingleLock lock(m_section);
+  if (m_workers.empty())
+    return NULL;
+
+  unsigned int affinity = job->GetAffinity();
+  if (affinity)
+    return m_workers[affinity % m_workers.size()];
+
+  // jobs added by a job (or from its callback) stay with that worker
+  for (Workers::const_iterator i = m_workers.begin(); i != m_workers.end(); ++i)
+  {
+    if ((*i)->IsCurrentThread())
+      return *i;
+  }
+  return NULL;
 }
 
 void CJobManager::StartWorkers(CJob::PRIORITY priority)
@@ -210,11 +322,11 @@ void CJobManager::StartWorkers(CJob::PRIORITY priority)
   CSingleLock lock(m_section);
 
   // check how many free threads we have
-  if (m_processing.size() >= GetMaxWorkers(priority))
+  if (m_active >= (long)GetMaxWorkers(priority))
     return;
 
   // do we have any sleeping threads?
-  if (m_processing.size() < m_workers.size())
+  if (m_active < (long)m_workers.size())
   {
     m_jobEvent.Set();
     return;
@@ -224,43 +336,95 @@ void CJobManager::StartWorkers(CJob::PRIORITY priority)
   m_workers.push_back(new CJobWorker(this));
 }
 
-CJob *CJobManager::PopJob()
+CJob *CJobManager::PopJob(CJobWorker *worker)
 {
-  CSingleLock lock(m_section);
   for (int priority = CJob::PRIORITY_HIGH; priority >= CJob::PRIORITY_LOW; --priority)
   {
-    if (m_jobQueue[priority].size() && m_processing.size() < GetMaxWorkers(CJob::PRIORITY(priority)))
+    // claim a slot before looking, so that lower priority jobs always leave some free
+    if (AtomicIncrement(&m_active) > (long)GetMaxWorkers(CJob::PRIORITY(priority)))
     {
-      CWorkItem job = m_jobQueue[priority].front();
-      m_jobQueue[priority].pop_front();
+      AtomicDecrement(&m_active);
+      continue;
+    }
+
+    CWorkItem *item;
+    while ((item = PopWorkItem(worker, CJob::PRIORITY(priority))) != NULL)
+    {
+      CSingleLock lock(m_section);
+      if (item->m_cancelled)
+      {
+        lock.Leave();
+        item->FreeJob();
+        delete item;
+        continue;
+      }
       // add to the processing vector
-      m_processing.push_back(job);
-      job.m_job->m_callback = this;
-      return job.m_job;
+      m_processing.push_back(item);
+      item->m_job->m_callback = this;
+      return item->m_job;
     }
+
+    AtomicDecrement(&m_active);
   }
   return NULL;
 }
 
-CJob *CJobManager::GetNextJob(const CJobWorker *worker)
+CJobManager::CWorkItem *CJobManager::PopWorkItem(CJobWorker *worker, CJob::PRIORITY priority)
 {
+  // our own queue first, which doesn't need the manager's lock
+  {
+    CSingleLock lock(worker->m_section);
+    JobQueue &queue = worker->m_jobQueue[priority];
+    if (queue.size())
+    {
+      CWorkItem *item = queue.front();
+      queue.pop_front();
+      return item;
+    }
+  }
+
   CSingleLock lock(m_section);
+  if (m_jobQueue[priority].size())
+  {
+    CWorkItem *item = m_jobQueue[priority].front();
+    m_jobQueue[priority].pop_front();
+    return item;
+  }
+
+  // nothing shared either, so take the newest job from a worker that has some to spare
+  for (Workers::iterator i = m_workers.begin(); i != m_workers.end(); ++i)
+  {
+    if (*i == worker)
+      continue;
+
+    CSingleLock victimLock((*i)->m_section);
+    JobQueue &queue = (*i)->m_jobQueue[priority];
+    if (queue.size())
+    {
+      CWorkItem *item = queue.back();
+      queue.pop_back();
+      return item;
+    }
+  }
+  return NULL;
+}
+
+CJob *CJobManager::GetNextJob(CJobWorker *worker)
+{
   while (m_running)
   {
     // grab a job off the queue if we have one
-    CJob *job = PopJob();
+    CJob *job = PopJob(worker);
     if (job)
       return job;
     // no jobs are left - sleep for 30 seconds to allow new jobs to come in
-    lock.Leave();
-    bool newJob = m_jobEvent.WaitMSec(30000);
-    lock.Enter();
-    if (!newJob)
+    if (!m_jobEvent.WaitMSec(30000))
       break;
   }
   // ensure no jobs have come in during the period after
   // timeout and before we held the lock
-  CJob *job = PopJob();
+  CSingleLock lock(m_section);
+  CJob *job = PopJob(worker);
   if (job)
     return job;
   // have no jobs
@@ -272,15 +436,18 @@ bool CJobManager::OnJobProgress(unsigned int progress, unsigned int total, const
 {
   CSingleLock lock(m_section);
   // find the job in the processing queue, and check whether it's cancelled (no callback)
-  Processing::const_iterator i = find(m_processing.begin(), m_processing.end(), job);
-  if (i != m_processing.end())
+  for (Processing::const_iterator i = m_processing.begin(); i != m_processing.end(); ++i)
   {
-    CWorkItem item(*i);
-    lock.Leave(); // leave section prior to call
-    if (item.m_callback)
+    if (**i == job)
     {
-      item.m_callback->OnJobProgress(item.m_id, progress, total, job);
-      return false;
+      CWorkItem item(**i);
+      lock.Leave(); // leave section prior to call
+      if (item.m_callback)
+      {
+        item.m_callback->OnJobProgress(item.m_id, progress, total, job);
+        return false;
+      }
+      break;
     }
   }
   return true; // couldn't find the job, or it's been cancelled
@@ -290,20 +457,25 @@ void CJobManager::OnJobComplete(bool success, CJob *job)
 {
   CSingleLock lock(m_section);
   // remove the job from the processing queue
-  Processing::iterator i = find(m_processing.begin(), m_processing.end(), job);
-  if (i != m_processing.end())
+  for (Processing::iterator i = m_processing.begin(); i != m_processing.end(); ++i)
   {
-    // tell any listeners we're done with the job, then delete it
-    CWorkItem item(*i);
-    lock.Leave();
-    if (item.m_callback)
-      item.m_callback->OnJobComplete(item.m_id, success, item.m_job);
-    lock.Enter();
-    Processing::iterator j = find(m_processing.begin(), m_processing.end(), job);
-    if (j != m_processing.end())
-      m_processing.erase(j);
-    lock.Leave();
-    item.FreeJob();
+    if (**i == job)
+    {
+      // tell any listeners we're done with the job, then delete it
+      CWorkItem *work = *i;
+      IJobCallback *callback = work->m_callback;
+      lock.Leave();
+      if (callback)
+        callback->OnJobComplete(work->m_id, success, job);
+      lock.Enter();
+      m_processing.erase(find(m_processing.begin(), m_processing.end(), work));
+      m_jobs.erase(work->m_id);
+      lock.Leave();
+      work->FreeJob();
+      delete work;
+      AtomicDecrement(&m_active);
+      return;
+    }
   }
 }
 
@@ -313,11 +485,38 @@ void CJobManager::RemoveWorker(const CJobWorker *worker)
   // remove our worker
   Workers::iterator i = find(m_workers.begin(), m_workers.end(), worker);
   if (i != m_workers.end())
+  {
+    // hand anything still queued on it over to the others
+    CSingleLock workerLock((*i)->m_section);
+    for (unsigned int priority = CJob::PRIORITY_LOW; priority <= CJob::PRIORITY_HIGH; ++priority)
+    {
+      JobQueue &queue = (*i)->m_jobQueue[priority];
+      for (JobQueue::iterator j = queue.begin(); j != queue.end(); ++j)
+      {
+        if (m_running)
+          m_jobQueue[priority].push_back(*j);
+        else
+        {
+          (*j)->FreeJob();
+          delete *j;
+        }
+      }
+      queue.clear();
+    }
+    workerLock.Leave();
     m_workers.erase(i); // workers auto-delete
+  }
 }
 
 unsigned int CJobManager::GetMaxWorkers(CJob::PRIORITY priority) const
 {
-  static const unsigned int max_workers = 5;
+  // size for the machine unless told otherwise; the jobs are a mix of decoding and waiting on
+  // the network, so allow a couple per core
+  unsigned int max_workers = g_advancedSettings.m_jobWorkers;
+  if (max_workers == 0)
+    max_workers = std::min(std::max(5, g_cpuInfo.getCPUCount() * 2), 16);
+
+  // keep a worker free for each level of priority above this one
+  max_workers = std::max(max_workers, (unsigned int)CJob::PRIORITY_HIGH + 1);
   return max_workers - (CJob::PRIORITY_HIGH - priority);
 }
@@ -20,6 +20,7 @@
  *
  */
 
+#include <map>
 #include <queue>
 #include <vector>
 #include <string>
@@ -28,17 +29,7 @@
 #include "Job.h"
 
 class CJobManager;
-
-class CJobWorker : public CThread
-{
-public:
-  CJobWorker(CJobManager *manager);
-  virtual ~CJobWorker();
-
-  void Process();
-private:
-  CJobManager  *m_jobManager;
-};
+class CJobWorker;
 
 /*!
  \ingroup jobs
@@ -129,10 +120,17 @@ public:
 private:
   void QueueNextJob();
 
+  /*! \brief Whether an equal job is queued or processing, found through the CJob::GetHash() index
+   */
+  bool HasJob(const CJob *job) const;
+  void RemoveFromIndex(const CJob *job);
+
   typedef std::deque<CJobPointer> Queue;
   typedef std::vector<CJobPointer> Processing;
+  typedef std::multimap<unsigned int, const CJob*> Index;
   Queue m_jobQueue;
   Processing m_processing;
+  Index m_index;
 
   unsigned int m_jobsAtOnce;
   CJob::PRIORITY m_priority;
@@ -149,6 +147,12 @@ private:
  priority levels.  Lower priority jobs are executed only if there are sufficient
  spare worker threads free to allow for higher priority jobs that may arise.
 
+ Each worker has its own queues.  Jobs added from a worker (e.g. from a job callback)
+ or with an affinity group go to a worker's queues, the rest to the shared ones.  A
+ worker takes from its own queues first, then the shared ones, then steals from the
+ other workers, so the manager's lock is only held briefly and never while searching
+ through the queued jobs.
+
  \sa CJob and IJobCallback
  */
 class CJobManager
@@ -156,16 +160,14 @@ class CJobManager
   class CWorkItem
   {
   public:
-    CWorkItem(CJob *job, unsigned int id, IJobCallback *callback)
+    CWorkItem(CJob *job, unsigned int id, IJobCallback *callback, CJob::PRIORITY priority)
     {
       m_job = job;
       m_id = id;
       m_callback = callback;
+      m_priority = priority;
+      m_cancelled = false;
     }
-    bool operator==(unsigned int jobID) const
-    {
-      return m_id == jobID;
-    };
     bool operator==(const CJob *job) const
     {
       return m_job == job;
@@ -179,11 +181,15 @@ class CJobManager
     {
       m_callback = NULL;
     };
-    CJob         *m_job;
-    unsigned int  m_id;
-    IJobCallback *m_callback;
+    CJob          *m_job;
+    unsigned int   m_id;
+    IJobCallback  *m_callback;
+    CJob::PRIORITY m_priority;
+    bool           m_cancelled; ///< cancelled while queued; freed by whoever pops it
   };
 
+  typedef std::deque<CWorkItem*> JobQueue;
+
 public:
   /*!
    \brief The only way through which the global instance of the CJobManager should be accessed.
@@ -208,6 +214,16 @@ public:
    */
   void CancelJob(unsigned int jobID);
 
+  /*!
+   \brief Move a job that hasn't started yet up to a higher priority.
+   For jobs queued ahead of need that turn out to be needed now.
+   \param jobID the id of the job, retrieved previously from AddJob()
+   \param priority the priority it should now run at; jobs already at or above it are left be
+   \return true if the job is still queued, false if it has started, finished or been cancelled
+   \sa AddJob()
+   */
+  bool RaisePriority(unsigned int jobID, CJob::PRIORITY priority);
+
   /*!
    \brief Cancel all remaining jobs, preparing for shutdown
    Should be called prior to destroying any objects that may be being used as callbacks
@@ -224,7 +240,7 @@ protected:
    \param worker a pointer to the current CJobWorker instance requesting a job.
    \sa CJob
    */
-  CJob *GetNextJob(const CJobWorker *worker);
+  CJob *GetNextJob(CJobWorker *worker);
 
   /*!
    \brief Callback from CJobWorker after a job has completed.
@@ -253,10 +269,20 @@ private:
   CJobManager const& operator=(CJobManager const&);
   virtual ~CJobManager();
 
-  /*! \brief Pop a job off the job queue and add to the processing queue ready to process
+  /*! \brief Pop a job off the job queues and add to the processing queue ready to process
+   \param worker the worker that will process the job.
    \return the job to process, NULL if no jobs are available
    */
-  CJob *PopJob();
+  CJob *PopJob(CJobWorker *worker);
+
+  /*! \brief Take the next work item of the given priority: from the worker's own queue, then
+   the shared queue, then the back of another worker's queue.
+   */
+  CWorkItem *PopWorkItem(CJobWorker *worker, CJob::PRIORITY priority);
+
+  /*! \brief The worker the given job should be queued on, NULL for the shared queues
+   */
+  CJobWorker *GetWorkerForJob(const CJob *job) const;
 
   void StartWorkers(CJob::PRIORITY priority);
   void RemoveWorker(const CJobWorker *worker);
@@ -264,15 +290,36 @@ private:
 
   unsigned int m_jobCounter;
 
-  typedef std::deque<CWorkItem>    JobQueue;
-  typedef std::vector<CWorkItem>   Processing;
+  typedef std::map<unsigned int, CWorkItem*> Jobs;
+  typedef std::vector<CWorkItem*>  Processing;
   typedef std::vector<CJobWorker*> Workers;
 
   JobQueue   m_jobQueue[CJob::PRIORITY_HIGH+1];
+  Jobs       m_jobs;       ///< queued and processing jobs by id
   Processing m_processing;
   Workers    m_workers;
+  volatile long m_active;  ///< workers that have claimed a job, or are about to
 
   CCriticalSection m_section;
   CEvent           m_jobEvent;
   bool             m_running;
 };
+
+class CJobWorker : public CThread
+{
+public:
+  CJobWorker(CJobManager *manager);
+  virtual ~CJobWorker();
+
+  void Process();
+private:
+  friend class CJobManager;
+
+  CJobManager  *m_jobManager;
+
+  /*! \brief Jobs queued on this worker. It pops them from the front, other workers steal from
+   the back. Only accessed with m_section held; the manager's lock, if needed, is taken first.
+   */
+  CJobManager::JobQueue m_jobQueue[CJob::PRIORITY_HIGH+1];
+  CCriticalSection      m_section;
+};
@@ -0,0 +1,114 @@
+/*
+ *      Copyright (C) 2005-2010 Team XBMC
+ *      http://www.xbmc.org
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, write to
+ *  the Free Software Foundation, 675 Mass Ave, Cambridge, MA 02139, USA.
+ *  http://www.gnu.org/copyleft/gpl.html
+ *
+ */
+
+#include "system.h"
+#include "MappedFile.h"
+#include "FileSystem/SpecialProtocol.h"
+#ifdef _WIN32
+#include "utils/CharsetConverter.h"
+#else
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+CMappedFile::CMappedFile()
+{
+  m_data = NULL;
+  m_size = 0;
+#ifdef _WIN32
+  m_file = INVALID_HANDLE_VALUE;
+  m_mapping = NULL;
+#endif
+}
+
+CMappedFile::~CMappedFile()
+{
+  Close();
+}
+
+bool CMappedFile::Open(const CStdString &path)
+{
+  Close();
+
+  CStdString file = CSpecialProtocol::TranslatePath(path);
+#ifdef _WIN32
+  CStdStringW fileW;
+  g_charsetConverter.utf8ToW(file, fileW, false);
+  m_file = CreateFileW(fileW.c_str(), GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING, FILE_FLAG_RANDOM_ACCESS, NULL);
+  if (m_file == INVALID_HANDLE_VALUE)
+    return false;
+
+  LARGE_INTEGER size;
+  if (!GetFileSizeEx((HANDLE)m_file, &size) || size.QuadPart == 0 || size.HighPart)
+  {
+    Close();
+    return false;
+  }
+  m_mapping = CreateFileMapping((HANDLE)m_file, NULL, PAGE_READONLY, 0, 0, NULL);
+  if (m_mapping)
+    m_data = (const uint8_t *)MapViewOfFile((HANDLE)m_mapping, FILE_MAP_READ, 0, 0, 0);
+  if (!m_data)
+  {
+    Close();
+    return false;
+  }
+  m_size = (size_t)size.QuadPart;
+#else
+  int fd = open(file.c_str(), O_RDONLY);
+  if (fd < 0)
+    return false;
+
+  struct stat st;
+  if (fstat(fd, &st) == 0 && st.st_size > 0 && (uint64_t)st.st_size <= (size_t)-1)
+  {
+    void *data = mmap(NULL, (size_t)st.st_size, PROT_READ, MAP_SHARED, fd, 0);
+    if (data != MAP_FAILED)
+    {
+      m_data = (const uint8_t *)data;
+      m_size = (size_t)st.st_size;
+    }
+  }
+  // the mapping holds its own reference to the file
+  close(fd);
+#endif
+  return m_data != NULL;
+}
+
+void CMappedFile::Close()
+{
+#ifdef _WIN32
+  if (m_data)
+    UnmapViewOfFile(m_data);
+  if (m_mapping)
+    CloseHandle((HANDLE)m_mapping);
+  if (m_file != INVALID_HANDLE_VALUE)
+    CloseHandle((HANDLE)m_file);
+  m_mapping = NULL;
+  m_file = INVALID_HANDLE_VALUE;
+#else
+  if (m_data)
+    munmap((void *)m_data, m_size);
+#endif
+  m_data = NULL;
+  m_size = 0;
+}
@@ -0,0 +1,56 @@
+#pragma once
+/*
+ *      Copyright (C) 2005-2010 Team XBMC
+ *      http://www.xbmc.org
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, write to
+ *  the Free Software Foundation, 675 Mass Ave, Cambridge, MA 02139, USA.
+ *  http://www.gnu.org/copyleft/gpl.html
+ *
+ */
+
+#include "StdString.h"
+#include <stdint.h>
+
+/*!
+ \brief Read only view of a local file, mapped into memory.
+
+ Only works on files the OS can map, ie special:// paths that translate to a local file.
+ The mapping stays valid until Close() is called or the object is destroyed.
+ */
+class CMappedFile
+{
+public:
+  CMappedFile();
+  ~CMappedFile();
+
+  bool Open(const CStdString &path);
+  void Close();
+
+  const uint8_t *GetData() const { return m_data; };
+  size_t GetSize() const { return m_size; };
+  bool IsOpen() const { return m_data != NULL; };
+
+private:
+  // non-copyable
+  CMappedFile(const CMappedFile &);
+  CMappedFile &operator=(const CMappedFile &);
+
+  const uint8_t *m_data;
+  size_t         m_size;
+#ifdef _WIN32
+  void          *m_file;
+  void          *m_mapping;
+#endif
+};
@@ -20,8 +20,15 @@
  */
 
 #include "PCMAmplifier.h"
+#include "CPUInfo.h"
 
 #include <math.h>
+#ifdef HAS_SSE2_INTRINSICS
+#include <emmintrin.h>
+#endif
+#ifdef HAS_NEON_INTRINSICS
+#include <arm_neon.h>
+#endif
 
 CPCMAmplifier::CPCMAmplifier() : m_nVolume(VOLUME_MAXIMUM), m_dFactor(0)
 {
@@ -60,7 +67,38 @@ void CPCMAmplifier::DeAmplify(short *pcm, int nSamples)
     return;
   }
 
-  for (int nSample=0; nSample<nSamples; nSample++)
+  int nSample = 0;
+  float factor = (float)m_dFactor;
+
+#ifdef HAS_SSE2_INTRINSICS
+  if (g_cpuInfo.GetCPUFeatures() & CPU_FEATURE_SSE2)
+  {
+    const __m128 f = _mm_set1_ps(factor);
+    for (; nSample + 8 <= nSamples; nSample += 8)
+    {
+      __m128i s  = _mm_loadu_si128((__m128i *)(pcm + nSample));
+      __m128i lo = _mm_srai_epi32(_mm_unpacklo_epi16(s, s), 16);
+      __m128i hi = _mm_srai_epi32(_mm_unpackhi_epi16(s, s), 16);
+      lo = _mm_cvttps_epi32(_mm_mul_ps(_mm_cvtepi32_ps(lo), f));
+      hi = _mm_cvttps_epi32(_mm_mul_ps(_mm_cvtepi32_ps(hi), f));
+      _mm_storeu_si128((__m128i *)(pcm + nSample), _mm_packs_epi32(lo, hi));
+    }
+  }
+#endif
+#ifdef HAS_NEON_INTRINSICS
+  if (g_cpuInfo.GetCPUFeatures() & CPU_FEATURE_NEON)
+  {
+    for (; nSample + 8 <= nSamples; nSample += 8)
+    {
+      int16x8_t s  = vld1q_s16(pcm + nSample);
+      int32x4_t lo = vcvtq_s32_f32(vmulq_n_f32(vcvtq_f32_s32(vmovl_s16(vget_low_s16(s))), factor));
+      int32x4_t hi = vcvtq_s32_f32(vmulq_n_f32(vcvtq_f32_s32(vmovl_s16(vget_high_s16(s))), factor));
+      vst1q_s16(pcm + nSample, vcombine_s16(vqmovn_s32(lo), vqmovn_s32(hi)));
+    }
+  }
+#endif
+
+  for (; nSample<nSamples; nSample++)
   {
     int nSampleValue = pcm[nSample]; // must be int. so that we can check over/under flow
     nSampleValue = (int)((double)nSampleValue * m_dFactor);
@@ -68,3 +106,42 @@ void CPCMAmplifier::DeAmplify(short *pcm, int nSamples)
     pcm[nSample] = (short)nSampleValue;
   }
 }
+
+void CPCMAmplifier::Scale(float *pcm, int nSamples, float factor)
+{
+  int nSample = 0;
+
+#ifdef HAS_SSE2_INTRINSICS
+  if (g_cpuInfo.GetCPUFeatures() & CPU_FEATURE_SSE2)
+  {
+    const __m128 f   = _mm_set1_ps(factor);
+    const __m128 max = _mm_set1_ps( 1.0f);
+    const __m128 min = _mm_set1_ps(-1.0f);
+    for (; nSample + 4 <= nSamples; nSample += 4)
+    {
+      __m128 s = _mm_mul_ps(_mm_loadu_ps(pcm + nSample), f);
+      _mm_storeu_ps(pcm + nSample, _mm_max_ps(_mm_min_ps(s, max), min));
+    }
+  }
+#endif
+#ifdef HAS_NEON_INTRINSICS
+  if (g_cpuInfo.GetCPUFeatures() & CPU_FEATURE_NEON)
+  {
+    const float32x4_t max = vdupq_n_f32( 1.0f);
+    const float32x4_t min = vdupq_n_f32(-1.0f);
+    for (; nSample + 4 <= nSamples; nSample += 4)
+    {
+      float32x4_t s = vmulq_n_f32(vld1q_f32(pcm + nSample), factor);
+      vst1q_f32(pcm + nSample, vmaxq_f32(vminq_f32(s, max), min));
+    }
+  }
+#endif
+
+  for (; nSample < nSamples; nSample++)
+  {
+    float value = pcm[nSample] * factor;
+    if (value > 1.0f) value = 1.0f;
+    if (value < -1.0f) value = -1.0f;
+    pcm[nSample] = value;
+  }
+}
@@ -35,6 +35,12 @@ public:
   // only works on 16bit samples
   void DeAmplify(short *pcm, int nSamples);
 
+  // what DeAmplify() scales by, for those applying it along with other processing
+  float GetFactor() const { return m_dFactor >= 1.0 ? 1.0f : (float)m_dFactor; }
+
+  // scales float samples, clipping them to -1 ... 1
+  static void Scale(float *pcm, int nSamples, float factor);
+
 protected:
   int m_nVolume;
   double m_dFactor;
@@ -28,11 +28,18 @@
 
 #include "MathUtils.h"
 #include "PCMRemap.h"
+#include "utils/CPUInfo.h"
 #include "utils/log.h"
 #include "GUISettings.h"
 #ifdef _WIN32
 #include "../win32/PlatformDefs.h"
 #endif
+#ifdef HAS_SSE2_INTRINSICS
+#include <emmintrin.h>
+#endif
+#ifdef HAS_NEON_INTRINSICS
+#include <arm_neon.h>
+#endif
 
 static enum PCMChannels PCMLayoutMap[PCM_MAX_LAYOUT][PCM_MAX_CH + 1] =
 {
@@ -161,13 +168,146 @@ static struct PCMMapInfo PCMDownmixTable[PCM_MAX_CH][PCM_MAX_MIX] =
   }
 };
 
+/*
+  Vectorised remaps work on the whole mix matrix, which costs the same whichever levels are
+  used, and saturate when packing back down to 16 bits rather than clamping each sample.
+  IN_CH and OUT_CH are the channel counts for the common layouts, letting the compiler unroll them,
+  or 0 to take the counts at runtime.
+*/
+#ifdef HAS_SSE2_INTRINSICS
+template<int IN_CH, int OUT_CH>
+static void RemapSSE2(const int16_t *in, int16_t *out, unsigned int frames, const float (*matrix)[PCM_MATRIX_CH], int inChannels, int outChannels)
+{
+  const int inCh  = IN_CH  ? IN_CH  : inChannels;
+  const int outCh = OUT_CH ? OUT_CH : outChannels;
+
+  __m128 lo[PCM_MATRIX_CH], hi[PCM_MATRIX_CH];
+  for (int i = 0; i < inCh; ++i)
+  {
+    lo[i] = _mm_loadu_ps(matrix[i]);
+    hi[i] = _mm_loadu_ps(matrix[i] + 4);
+  }
+
+  int16_t packed[8];
+  for (unsigned int f = 0; f < frames; ++f)
+  {
+    __m128 accLo = _mm_setzero_ps();
+    __m128 accHi = _mm_setzero_ps();
+    for (int i = 0; i < inCh; ++i)
+    {
+      __m128 sample = _mm_set1_ps((float)in[i]);
+      accLo = _mm_add_ps(accLo, _mm_mul_ps(sample, lo[i]));
+      if (outCh > 4)
+        accHi = _mm_add_ps(accHi, _mm_mul_ps(sample, hi[i]));
+    }
+
+    __m128i result = _mm_packs_epi32(_mm_cvtps_epi32(accLo), _mm_cvtps_epi32(accHi));
+    if (outCh == 8)
+      _mm_storeu_si128((__m128i *)out, result);
+    else
+    {
+      _mm_storeu_si128((__m128i *)packed, result);
+      memcpy(out, packed, outCh * sizeof(int16_t));
+    }
+
+    in  += inCh;
+    out += outCh;
+  }
+}
+#endif
+
+#ifdef HAS_NEON_INTRINSICS
+static inline int16x4_t PackNEON(float32x4_t value)
+{
+  // round to nearest, conversion truncates
+  const float32x4_t half = vdupq_n_f32(0.5f);
+  uint32x4_t negative = vcltq_f32(value, vdupq_n_f32(0.0f));
+  value = vaddq_f32(value, vbslq_f32(negative, vnegq_f32(half), half));
+  return vqmovn_s32(vcvtq_s32_f32(value));
+}
+
+template<int IN_CH, int OUT_CH>
+static void RemapNEON(const int16_t *in, int16_t *out, unsigned int frames, const float (*matrix)[PCM_MATRIX_CH], int inChannels, int outChannels)
+{
+  const int inCh  = IN_CH  ? IN_CH  : inChannels;
+  const int outCh = OUT_CH ? OUT_CH : outChannels;
+
+  float32x4_t lo[PCM_MATRIX_CH], hi[PCM_MATRIX_CH];
+  for (int i = 0; i < inCh; ++i)
+  {
+    lo[i] = vld1q_f32(matrix[i]);
+    hi[i] = vld1q_f32(matrix[i] + 4);
+  }
+
+  int16_t packed[8];
+  for (unsigned int f = 0; f < frames; ++f)
+  {
+    float32x4_t accLo = vdupq_n_f32(0.0f);
+    float32x4_t accHi = vdupq_n_f32(0.0f);
+    for (int i = 0; i < inCh; ++i)
+    {
+      float sample = (float)in[i];
+      accLo = vmlaq_n_f32(accLo, lo[i], sample);
+      if (outCh > 4)
+        accHi = vmlaq_n_f32(accHi, hi[i], sample);
+    }
+
+    int16x8_t result = vcombine_s16(PackNEON(accLo), PackNEON(accHi));
+    if (outCh == 8)
+      vst1q_s16(out, result);
+    else
+    {
+      vst1q_s16(packed, result);
+      memcpy(out, packed, outCh * sizeof(int16_t));
+    }
+
+    in  += inCh;
+    out += outCh;
+  }
+}
+#endif
+
+/* stereo, 5.1 and 7.1 to each other, anything else up to PCM_MATRIX_CH channels takes the generic kernel */
+#define PCM_KERNELS(KERNEL) \
+  if (in == 2 && out == 2) return KERNEL<2, 2>; \
+  if (in == 2 && out == 6) return KERNEL<2, 6>; \
+  if (in == 2 && out == 8) return KERNEL<2, 8>; \
+  if (in == 6 && out == 2) return KERNEL<6, 2>; \
+  if (in == 6 && out == 6) return KERNEL<6, 6>; \
+  if (in == 6 && out == 8) return KERNEL<6, 8>; \
+  if (in == 8 && out == 2) return KERNEL<8, 2>; \
+  if (in == 8 && out == 6) return KERNEL<8, 6>; \
+  if (in == 8 && out == 8) return KERNEL<8, 8>; \
+  return KERNEL<0, 0>;
+
+static CPCMRemap::RemapKernel GetRemapKernel(unsigned int in, unsigned int out, const char *&name)
+{
+#ifdef HAS_SSE2_INTRINSICS
+  if (g_cpuInfo.GetCPUFeatures() & CPU_FEATURE_SSE2)
+  {
+    name = "SSE2";
+    PCM_KERNELS(RemapSSE2)
+  }
+#endif
+#ifdef HAS_NEON_INTRINSICS
+  if (g_cpuInfo.GetCPUFeatures() & CPU_FEATURE_NEON)
+  {
+    name = "NEON";
+    PCM_KERNELS(RemapNEON)
+  }
+#endif
+  name = "scalar";
+  return NULL;
+}
+
 CPCMRemap::CPCMRemap() :
   m_inSet       (false),
   m_outSet      (false),
   m_ignoreLayout(false),
   m_inChannels  (0),
   m_outChannels (0),
-  m_inSampleSize(0)
+  m_inSampleSize(0),
+  m_gain        (1.0f)
 {
   Dispose();
 }
@@ -179,6 +319,8 @@ CPCMRemap::~CPCMRemap()
 
 void CPCMRemap::Dispose()
 {
+  m_kernel     = NULL;
+  m_kernelName = "scalar";
 }
 
 /* resolves the channels recursively and returns the new index of tablePtr */
@@ -407,6 +549,27 @@ void CPCMRemap::BuildMap()
     }
     CLog::Log(LOGDEBUG, "CPCMRemap: %s = %s\n", PCMChannelStr(m_outMap[out_ch]).c_str(), s.c_str());
   }
+
+  BuildMatrix();
+  CLog::Log(LOGDEBUG, "CPCMRemap: Using %s remap for %u to %u channels", m_kernelName, m_inChannels, m_outChannels);
+}
+
+/* flattens the lookup map, with the gain applied, for the vectorised kernels */
+void CPCMRemap::BuildMatrix()
+{
+  m_kernel = NULL;
+  m_kernelName = "scalar";
+  if (m_inChannels > PCM_MATRIX_CH || m_outChannels > PCM_MATRIX_CH || m_inSampleSize != 2)
+    return;
+
+  memset(m_matrix, 0, sizeof(m_matrix));
+  for(unsigned int out_ch = 0; out_ch < m_outChannels; ++out_ch)
+  {
+    for(struct PCMMapInfo *info = m_lookupMap[m_outMap[out_ch]]; info->channel != PCM_INVALID; ++info)
+      m_matrix[info->in_offset / m_inSampleSize][out_ch] += (info->copy ? 1.0f : info->level) * m_gain;
+  }
+
+  m_kernel = GetRemapKernel(m_inChannels, m_outChannels, m_kernelName);
 }
 
 void CPCMRemap::DumpMap(CStdString info, unsigned int channels, enum PCMChannels *channelMap)
@@ -499,6 +662,12 @@ void CPCMRemap::Remap(void *data, void *out, unsigned int samples)
     the output may have channels the input does not have, so zero the data
     to stop random data being sent to them.
   */
+  if (m_kernel)
+  {
+    m_kernel((const int16_t*)data, (int16_t*)out, samples, m_matrix, m_inChannels, m_outChannels);
+    return;
+  }
+
   memset(out, 0, samples * (m_inSampleSize * m_outChannels));
   for(i = 0; i < samples; ++i)
   {
@@ -511,7 +680,7 @@ void CPCMRemap::Remap(void *data, void *out, unsigned int samples)
       if (info->channel == PCM_INVALID) continue;
 
       /* if it is a 1-1 map, we just copy the data to avoid rounding errors */
-      if (info->copy)
+      if (info->copy && m_gain == 1.0f)
       {
         src = insample  + info->in_offset;
         dst = outsample + ch * m_inSampleSize;
@@ -524,6 +693,7 @@ void CPCMRemap::Remap(void *data, void *out, unsigned int samples)
         src    = insample + info->in_offset;
         value += (float)(*(int16_t*)src) * info->level;
       }
+      value *= m_gain;
       dst = outsample + ch * m_inSampleSize;
 
       //convert to signed int and clamp to 16 bit
@@ -541,6 +711,16 @@ void CPCMRemap::Remap(void *data, void *out, unsigned int samples)
   }
 }
 
+void CPCMRemap::SetGain(float gain)
+{
+  if (gain == m_gain)
+    return;
+
+  m_gain = gain;
+  if (m_inSet && m_outSet)
+    BuildMatrix();
+}
+
 bool CPCMRemap::CanRemap()
 {
   return (m_inSet && m_outSet);
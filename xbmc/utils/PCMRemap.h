@@ -65,6 +65,9 @@ enum PCMLayout
   PCM_LAYOUT_7_1
 };
 
+/* the most channels the vectorised remap kernels handle */
+#define PCM_MATRIX_CH 8
+
 struct PCMMapInfo
 {
   enum  PCMChannels channel;
@@ -76,6 +79,9 @@ struct PCMMapInfo
 
 class CPCMRemap
 {
+public:
+  typedef void (*RemapKernel)(const int16_t *in, int16_t *out, unsigned int frames, const float (*matrix)[PCM_MATRIX_CH], int inChannels, int outChannels);
+
 protected:
   bool               m_inSet, m_outSet;
   enum PCMLayout     m_channelLayout;
@@ -91,9 +97,15 @@ protected:
   struct PCMMapInfo  m_lookupMap[PCM_MAX_CH + 1][PCM_MAX_CH + 1];
   int                m_counts[PCM_MAX_CH];
 
+  float              m_gain;
+  float              m_matrix[PCM_MATRIX_CH][PCM_MATRIX_CH]; //!< level of each input channel [in] in each output channel [out]
+  RemapKernel        m_kernel;
+  const char        *m_kernelName;
+
   struct PCMMapInfo* ResolveChannel(enum PCMChannels channel, float level, bool ifExists, std::vector<enum PCMChannels> path, struct PCMMapInfo *tablePtr);
   void               ResolveChannels(); //!< Partial BuildMap(), just enough to see which output channels are active
   void               BuildMap();
+  void               BuildMatrix();
   void               DumpMap(CStdString info, int unsigned channels, enum PCMChannels *channelMap);
   void               Dispose();
   CStdString         PCMChannelStr(enum PCMChannels ename);
@@ -107,6 +119,7 @@ public:
   enum PCMChannels *SetInputFormat (unsigned int channels, enum PCMChannels *channelMap, unsigned int sampleSize);
   void SetOutputFormat(unsigned int channels, enum PCMChannels *channelMap, bool ignoreLayout = false);
   void Remap(void *data, void *out, unsigned int samples);
+  void SetGain(float gain); //!< scale applied along with the remap, eg for volume
   bool CanRemap();
   int  InBytesToFrames (int bytes );
   int  FramesToOutBytes(int frames);